@@ -0,0 +1,104 @@
+#ifndef BENCH_CORPUS_H
+#define BENCH_CORPUS_H
+
+#include <sstream>
+#include <string>
+
+// Messages shaped like real traffic. Every function returns the bytes of one or more complete
+// messages, as they would arrive on one connection.
+namespace corpus
+{
+
+// A health check or API probe.
+inline std::string smallGet()
+{
+    return "GET /index.html HTTP/1.1\r\n"
+           "Host: example.com\r\n"
+           "\r\n";
+}
+
+// A page load from a desktop browser: many headers, long values and a cookie.
+inline std::string browserGet()
+{
+    return "GET /news/2024/05/article-about-parsers.html?utm_source=feed&utm_medium=rss HTTP/1.1\r\n"
+           "Host: www.example.com\r\n"
+           "Connection: keep-alive\r\n"
+           "Cache-Control: max-age=0\r\n"
+           "sec-ch-ua: \"Chromium\";v=\"124\", \"Google Chrome\";v=\"124\", \"Not-A.Brand\";v=\"99\"\r\n"
+           "sec-ch-ua-mobile: ?0\r\n"
+           "sec-ch-ua-platform: \"Linux\"\r\n"
+           "Upgrade-Insecure-Requests: 1\r\n"
+           "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) "
+           "Chrome/124.0.0.0 Safari/537.36\r\n"
+           "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,image/avif,image/webp,"
+           "image/apng,*/*;q=0.8,application/signed-exchange;v=b3;q=0.7\r\n"
+           "Sec-Fetch-Site: same-origin\r\n"
+           "Sec-Fetch-Mode: navigate\r\n"
+           "Sec-Fetch-User: ?1\r\n"
+           "Sec-Fetch-Dest: document\r\n"
+           "Referer: https://www.example.com/news/\r\n"
+           "Accept-Encoding: gzip, deflate, br, zstd\r\n"
+           "Accept-Language: en-US,en;q=0.9,de;q=0.8\r\n"
+           "Cookie: session=8f14e45fceea167a5a36dedd4bea2543; theme=dark; consent=1; "
+           "_ga=GA1.2.1234567890.1700000000; _gid=GA1.2.987654321.1700000000\r\n"
+           "\r\n";
+}
+
+// The same browser request sent `count` times back to back without waiting for responses.
+inline std::string pipelined(size_t count = 16)
+{
+    std::string one = browserGet();
+    std::string result;
+
+    for (size_t i = 0; i < count; ++i)
+        result += one;
+
+    return result;
+}
+
+// An upload with a Content-Length body.
+inline std::string largePost(size_t size = 1024 * 1024)
+{
+    std::ostringstream stream;
+    stream << "POST /upload HTTP/1.1\r\n"
+           << "Host: example.com\r\n"
+           << "Content-Type: application/octet-stream\r\n"
+           << "Content-Length: " << size << "\r\n"
+           << "\r\n"
+           << std::string(size, 'x');
+    return stream.str();
+}
+
+// A typical response of a web server to a page request.
+inline std::string smallResponse()
+{
+    return "HTTP/1.1 200 OK\r\n"
+           "Server: nginx/1.24.0\r\n"
+           "Date: Tue, 14 May 2024 10:00:00 GMT\r\n"
+           "Content-Type: text/html; charset=utf-8\r\n"
+           "Content-Length: 13\r\n"
+           "Connection: keep-alive\r\n"
+           "Cache-Control: no-cache\r\n"
+           "\r\n"
+           "<html></html>";
+}
+
+// A streamed response cut into many small chunks, like server-sent output.
+inline std::string chunkedResponse(size_t chunks = 1000, size_t chunkSize = 16)
+{
+    std::ostringstream stream;
+    stream << "HTTP/1.1 200 OK\r\n"
+           << "Content-Type: text/plain\r\n"
+           << "Transfer-Encoding: chunked\r\n"
+           << "\r\n";
+
+    for (size_t i = 0; i < chunks; ++i)
+        stream << std::hex << chunkSize << "\r\n" << std::string(chunkSize, 'x') << "\r\n";
+
+    stream << "0\r\n\r\n";
+    return stream.str();
+}
+
+}  // namespace corpus
+
+#endif  // BENCH_CORPUS_H
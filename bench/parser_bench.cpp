@@ -0,0 +1,89 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <string>
+
+#include <httpparser/httprequestparser.h>
+#include <httpparser/httpresponseparser.h>
+#include <httpparser/request.h>
+#include <httpparser/response.h>
+
+#include "corpus.h"
+#include "perfcounters.h"
+
+using namespace httpparser;
+
+// Parse every message of `text` per iteration, reusing one message object and one parser as a
+// server does on a keep-alive connection. The argument is the size of the segments the input
+// arrives in, 0 for the whole buffer at once.
+template <typename Parser, typename Message>
+void parseMessages(benchmark::State& state, const std::string& text)
+{
+    size_t step = state.range(0) == 0 ? text.size() : static_cast<size_t>(state.range(0));
+
+    Message message;
+    Parser parser;
+    PerfCounters counters;
+    size_t messages = 0;
+
+    counters.start();
+    for (auto _ : state)
+    {
+        const char* p   = text.data();
+        const char* end = p + text.size();
+
+        while (p != end)
+        {
+            size_t consumed                  = 0;
+            typename Parser::ParseResult res = parser.parse(message, p, std::min(p + step, end), consumed);
+            p += consumed;
+
+            if (res == Parser::ParsingCompleted)
+            {
+                benchmark::DoNotOptimize(message);
+                message.clear();
+                parser.reset();
+                ++messages;
+            }
+            else if (res != Parser::ParsingIncompleted)
+            {
+                state.SkipWithError("the corpus did not parse");
+                return;
+            }
+        }
+    }
+    counters.stop();
+
+    state.SetItemsProcessed(messages);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+    counters.report(state, double(state.iterations()) * text.size(), double(messages));
+}
+
+void requests(benchmark::State& state, const std::string& text)
+{
+    parseMessages<HttpRequestParser, Request>(state, text);
+}
+
+// Zero-copy parsing into slices of the input.
+void requestViews(benchmark::State& state, const std::string& text)
+{
+    parseMessages<HttpRequestParser, RequestView>(state, text);
+}
+
+void responses(benchmark::State& state, const std::string& text)
+{
+    parseMessages<HttpResponseParser, Response>(state, text);
+}
+
+// Every corpus whole, in 64-byte segments and byte by byte.
+#define DELIVERIES ->Arg(0)->Arg(64)->Arg(1)
+
+BENCHMARK_CAPTURE(requests, small_get, corpus::smallGet()) DELIVERIES;
+BENCHMARK_CAPTURE(requests, browser_get, corpus::browserGet()) DELIVERIES;
+BENCHMARK_CAPTURE(requests, pipelined, corpus::pipelined()) DELIVERIES;
+BENCHMARK_CAPTURE(requests, large_post, corpus::largePost()) DELIVERIES;
+BENCHMARK_CAPTURE(requestViews, browser_get, corpus::browserGet()) DELIVERIES;
+
+BENCHMARK_CAPTURE(responses, small, corpus::smallResponse()) DELIVERIES;
+BENCHMARK_CAPTURE(responses, many_chunks, corpus::chunkedResponse()) DELIVERIES;
+BENCHMARK_CAPTURE(responses, large_chunks, corpus::chunkedResponse(256, 4096)) DELIVERIES;
@@ -0,0 +1,164 @@
+#ifndef BENCH_PERFCOUNTERS_H
+#define BENCH_PERFCOUNTERS_H
+
+#include <benchmark/benchmark.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Hardware counters of this thread around a benchmark run, read with perf_event_open(2). They
+// are only opened when HTTPPARSER_BENCH_PERF is set in the environment. Counters the kernel or
+// the CPU does not offer (no permission, a VM, another OS) are left out of the report.
+class PerfCounters
+{
+public:
+    enum Event
+    {
+        Cycles,
+        Instructions,
+        Branches,
+        BranchMisses,
+        L1dMisses,
+        EventCount
+    };
+
+    PerfCounters()
+    {
+        for (int i = 0; i < EventCount; ++i)
+        {
+            fds[i]    = -1;
+            counts[i] = 0;
+        }
+
+        const char* enabled = getenv("HTTPPARSER_BENCH_PERF");
+        if (enabled && *enabled && strcmp(enabled, "0") != 0)
+        {
+            for (int i = 0; i < EventCount; ++i)
+                fds[i] = openCounter(static_cast<Event>(i));
+        }
+    }
+
+    ~PerfCounters()
+    {
+#ifdef __linux__
+        for (int i = 0; i < EventCount; ++i)
+        {
+            if (fds[i] != -1)
+                close(fds[i]);
+        }
+#endif
+    }
+
+    bool available(Event event) const { return fds[event] != -1; }
+
+    void start()
+    {
+#ifdef __linux__
+        for (int i = 0; i < EventCount; ++i)
+        {
+            if (fds[i] != -1)
+            {
+                ioctl(fds[i], PERF_EVENT_IOC_RESET, 0);
+                ioctl(fds[i], PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+#endif
+    }
+
+    void stop()
+    {
+#ifdef __linux__
+        for (int i = 0; i < EventCount; ++i)
+        {
+            if (fds[i] != -1)
+                ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+        }
+
+        for (int i = 0; i < EventCount; ++i)
+        {
+            // The value and the times the counter was enabled and actually running. When the
+            // CPU has fewer counters than events they take turns, scale up to the whole run.
+            uint64_t values[3] = {0, 0, 0};
+
+            if (fds[i] == -1 || read(fds[i], values, sizeof(values)) != sizeof(values))
+                counts[i] = 0;
+            else
+                counts[i] = values[2] == 0 ? 0 : static_cast<uint64_t>(values[0] * (double(values[1]) / values[2]));
+        }
+#endif
+    }
+
+    uint64_t count(Event event) const { return counts[event]; }
+
+    // Add the counts of the last start()/stop() to the report of `state`.
+    void report(benchmark::State& state, double bytes, double messages) const
+    {
+        if (bytes > 0 && available(Cycles))
+            state.counters["cycles/byte"] = count(Cycles) / bytes;
+        if (bytes > 0 && available(Instructions))
+            state.counters["instructions/byte"] = count(Instructions) / bytes;
+        if (available(Branches) && available(BranchMisses) && count(Branches) > 0)
+            state.counters["branch-miss-rate"] = double(count(BranchMisses)) / count(Branches);
+        if (messages > 0 && available(L1dMisses))
+            state.counters["L1d-misses/msg"] = count(L1dMisses) / messages;
+    }
+
+private:
+    PerfCounters(const PerfCounters&);
+    PerfCounters& operator=(const PerfCounters&);
+
+    static int openCounter(Event event)
+    {
+#ifdef __linux__
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size           = sizeof(attr);
+        attr.type           = PERF_TYPE_HARDWARE;
+        attr.disabled       = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+        attr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        switch (event)
+        {
+        case Cycles:
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case Instructions:
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case Branches:
+            attr.config = PERF_COUNT_HW_BRANCH_INSTRUCTIONS;
+            break;
+        case BranchMisses:
+            attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+        case L1dMisses:
+            attr.type   = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                          | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+        default:
+            return -1;
+        }
+
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#else
+        (void)event;
+        return -1;
+#endif
+    }
+
+    int fds[EventCount];
+    uint64_t counts[EventCount];
+};
+
+#endif  // BENCH_PERFCOUNTERS_H
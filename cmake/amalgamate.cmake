@@ -0,0 +1,72 @@
+# Generates single_include/httpparser/httpparser.h from the headers in include/httpparser.
+#
+#   cmake -P cmake/amalgamate.cmake               regenerate the single header
+#   cmake -DCHECK=ON -P cmake/amalgamate.cmake    fail if the single header is out of date
+cmake_minimum_required(VERSION 3.10)
+
+get_filename_component(ROOT "${CMAKE_CURRENT_LIST_DIR}/.." ABSOLUTE)
+set(INPUT_DIR "${ROOT}/include/httpparser")
+set(OUTPUT "${ROOT}/single_include/httpparser/httpparser.h")
+
+# Append the header `name` to the AMALGAMATION property, inlining every local header it
+# includes the first time it is seen.
+function(expand name)
+    get_property(seen GLOBAL PROPERTY AMALGAMATE_SEEN)
+    if(name IN_LIST seen)
+        return()
+    endif()
+    set_property(GLOBAL APPEND PROPERTY AMALGAMATE_SEEN ${name})
+
+    file(READ "${INPUT_DIR}/${name}" content)
+    # Drop the license comment, the single header has one at the top.
+    string(REGEX REPLACE "^/\\*[^*]*\\*+([^/*][^*]*\\*+)*/\n+" "" content "${content}")
+
+    while(TRUE)
+        string(FIND "${content}" "#include \"" pos)
+        if(pos EQUAL -1)
+            set_property(GLOBAL APPEND_STRING PROPERTY AMALGAMATION "${content}")
+            break()
+        endif()
+
+        string(SUBSTRING "${content}" 0 ${pos} before)
+        set_property(GLOBAL APPEND_STRING PROPERTY AMALGAMATION "${before}")
+
+        string(SUBSTRING "${content}" ${pos} -1 content)
+        string(FIND "${content}" "\n" eol)
+        string(SUBSTRING "${content}" 0 ${eol} line)
+        math(EXPR next "${eol} + 1")
+        string(SUBSTRING "${content}" ${next} -1 content)
+
+        string(REGEX REPLACE "#include \"([^\"]+)\".*" "\\1" included "${line}")
+        expand(${included})
+    endwhile()
+endfunction()
+
+set_property(GLOBAL PROPERTY AMALGAMATION "")
+foreach(header httprequestparser.h httpresponseparser.h urlparser.h)
+    expand(${header})
+endforeach()
+get_property(body GLOBAL PROPERTY AMALGAMATION)
+
+set(result "/*
+ * Copyright (C) Alex Nekipelov (alex@nekipelov.net)
+ * License: MIT
+ *
+ * Generated from include/httpparser by cmake/amalgamate.cmake, do not edit.
+ */
+
+#ifndef HTTPPARSER_HTTPPARSER_H
+#define HTTPPARSER_HTTPPARSER_H
+
+${body}
+#endif  // HTTPPARSER_HTTPPARSER_H
+")
+
+if(CHECK)
+    file(READ "${OUTPUT}" current)
+    if(NOT current STREQUAL result)
+        message(FATAL_ERROR "${OUTPUT} is out of date, run: cmake -P cmake/amalgamate.cmake")
+    endif()
+else()
+    file(WRITE "${OUTPUT}" "${result}")
+endif()
@@ -0,0 +1,374 @@
+// Feeds every input to the parsers whole, byte by byte and cut at pseudo-random points, and
+// aborts if the messages or results differ between the deliveries. The fast paths (bulk body
+// copies, vector scans, word compares) only run when enough input is at hand, so this is what
+// keeps them honest against the per-byte states.
+//
+// Built with clang and HTTPARSER_BUILD_FUZZERS=ON this is a libFuzzer target. Otherwise it is a
+// standalone program that runs over the files given on the command line, or over mutations of
+// built-in seeds, and prints the throughput of each delivery.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+#include <string.h>
+
+#include <httpparser/httprequestparser.h>
+#include <httpparser/httpresponseparser.h>
+#include <httpparser/request.h>
+#include <httpparser/requestview.h>
+#include <httpparser/response.h>
+#include <httpparser/responseview.h>
+
+using namespace httpparser;
+
+namespace
+{
+
+enum Delivery
+{
+    Whole,
+    Bytewise,
+    RandomSplits,
+    DeliveryCount
+};
+
+const char* deliveryNames[DeliveryCount] = {"whole", "byte-by-byte", "random splits"};
+
+struct Timing
+{
+    Timing() : seconds(0), bytes(0) {}
+
+    double seconds;
+    double bytes;
+};
+
+Timing timings[DeliveryCount];
+
+// A small xorshift generator, so the cuts of one input are the same on every run.
+class Random
+{
+public:
+    explicit Random(uint64_t seed) : state(seed ? seed : 0x9e3779b97f4a7c15ULL) {}
+
+    uint64_t next()
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+
+    size_t below(size_t n) { return n == 0 ? 0 : static_cast<size_t>(next() % n); }
+
+private:
+    uint64_t state;
+};
+
+// The end of every segment the input arrives in.
+std::vector<size_t> segmentEnds(Delivery delivery, size_t size, uint64_t seed)
+{
+    std::vector<size_t> ends;
+
+    if (delivery == Whole)
+    {
+        ends.push_back(size);
+    }
+    else if (delivery == Bytewise)
+    {
+        for (size_t i = 1; i <= size; ++i)
+            ends.push_back(i);
+    }
+    else
+    {
+        Random random(seed);
+        for (size_t pos = 0; pos < size;)
+        {
+            // Mostly short segments, sometimes a long one so the fast paths get to run too.
+            pos += 1 + (random.below(4) == 0 ? random.below(256) : random.below(8));
+            ends.push_back(pos < size ? pos : size);
+        }
+    }
+
+    return ends;
+}
+
+std::string describe(const Request& req)
+{
+    std::ostringstream stream;
+    stream << req.inspect() << "method id: " << req.methodId << "\n";
+    for (size_t i = 0; i < req.headers.size(); ++i)
+        stream << "header id: " << req.headers[i].id << "\n";
+    return stream.str();
+}
+
+std::string describe(const Response& resp)
+{
+    std::ostringstream stream;
+    stream << resp.inspect() << "keep-alive: " << resp.keepAlive << "\n";
+    for (size_t i = 0; i < resp.headers.size(); ++i)
+        stream << "header id: " << resp.headers[i].id << "\n";
+    return stream.str();
+}
+
+std::string describe(const RequestView& req)
+{
+    return describe(req.materialize());
+}
+
+std::string describe(const ResponseView& resp)
+{
+    return describe(resp.materialize());
+}
+
+// Parse `data` segment by segment, starting the next message where a completed one stopped,
+// and return every message and the final result, one entry each.
+template <typename Parser, typename Message>
+std::vector<std::string> parseAll(const char* data, const std::vector<size_t>& ends, bool closeAtEnd)
+{
+    std::vector<std::string> results;
+    Parser parser;
+    Message message;
+    const char* pos = data;
+
+    for (size_t i = 0; i < ends.size(); ++i)
+    {
+        const char* end = data + ends[i];
+
+        while (pos != end)
+        {
+            size_t consumed                  = 0;
+            typename Parser::ParseResult res = parser.parse(message, pos, end, consumed);
+            pos += consumed;
+
+            if (res == Parser::ParsingCompleted)
+            {
+                results.push_back(describe(message));
+                message.clear();
+                parser.reset();
+            }
+            else if (res != Parser::ParsingIncompleted)
+            {
+                std::ostringstream stream;
+                stream << "result " << res << ", error " << parser.error();
+                results.push_back(stream.str());
+                return results;
+            }
+        }
+    }
+
+    std::ostringstream stream;
+    if (closeAtEnd)
+    {
+        typename Parser::ParseResult res = parser.finish();
+        if (res == Parser::ParsingCompleted)
+            stream << describe(message);
+        stream << "finish " << res << ", error " << parser.error();
+    }
+    else
+    {
+        stream << "incomplete";
+    }
+    results.push_back(stream.str());
+    return results;
+}
+
+void mismatch(const char* what, Delivery delivery, const std::vector<std::string>& expected,
+              const std::vector<std::string>& actual)
+{
+    fprintf(stderr, "%s: %s delivery differs from the whole buffer\n", what, deliveryNames[delivery]);
+    for (size_t i = 0; i < expected.size() || i < actual.size(); ++i)
+    {
+        fprintf(stderr, "--- message %u, whole:\n%s\n", static_cast<unsigned>(i),
+                i < expected.size() ? expected[i].c_str() : "(none)");
+        fprintf(stderr, "+++ message %u, %s:\n%s\n", static_cast<unsigned>(i), deliveryNames[delivery],
+                i < actual.size() ? actual[i].c_str() : "(none)");
+    }
+    abort();
+}
+
+// Every message type must give the same messages and results for every delivery. The owning
+// and the view types are not compared with each other: a view keeps an obs-fold in its slice.
+template <typename Parser, typename Message, typename View>
+void check(const char* what, const char* data, size_t size, uint64_t seed, bool closeAtEnd)
+{
+    std::vector<std::string> expectedOwned;
+    std::vector<std::string> expectedViewed;
+
+    for (int d = 0; d < DeliveryCount; ++d)
+    {
+        Delivery delivery        = static_cast<Delivery>(d);
+        std::vector<size_t> ends = segmentEnds(delivery, size, seed);
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        std::vector<std::string> owned              = parseAll<Parser, Message>(data, ends, closeAtEnd);
+        std::chrono::steady_clock::time_point stop  = std::chrono::steady_clock::now();
+
+        timings[d].seconds += std::chrono::duration<double>(stop - start).count();
+        timings[d].bytes += size;
+
+        std::vector<std::string> viewed = parseAll<Parser, View>(data, ends, closeAtEnd);
+
+        if (delivery == Whole)
+        {
+            expectedOwned  = owned;
+            expectedViewed = viewed;
+            continue;
+        }
+
+        if (owned != expectedOwned)
+            mismatch(what, delivery, expectedOwned, owned);
+        if (viewed != expectedViewed)
+            mismatch(what, delivery, expectedViewed, viewed);
+    }
+}
+
+}  // namespace
+
+// The first byte picks the parser and seeds the random cuts, the rest is the message stream.
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* input, size_t size)
+{
+    if (size == 0)
+        return 0;
+
+    const char* data = reinterpret_cast<const char*>(input + 1);
+    uint64_t seed    = input[0] * 0x100000001b3ULL + size;
+
+    if (input[0] & 1)
+        check<HttpResponseParser, Response, ResponseView>("response", data, size - 1, seed, (input[0] & 2) != 0);
+    else
+        check<HttpRequestParser, Request, RequestView>("request", data, size - 1, seed, false);
+
+    return 0;
+}
+
+#ifndef HTTPPARSER_LIBFUZZER
+
+namespace
+{
+
+// Adjacent literals are pipelined messages.
+const char* seeds[] = {
+    "GET /index.html HTTP/1.1\r\nHost: example.com\r\n\r\n",
+    "POST /upload?x=1 HTTP/1.1\r\nHost: example.com\r\nContent-Length: 11\r\n\r\nhello world"
+    "GET / HTTP/1.0\r\nConnection: keep-alive\r\n\r\n",
+    "PUT /item HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n5\r\nhello\r\n6;ext=1\r\n world\r\n0\r\n\r\n",
+    "PROPFIND /dav HTTP/1.1\r\nX-Folded: one\r\n two\r\nContent-Length: 0\r\n\r\n",
+    "HTTP/1.1 200 OK\r\nContent-Length: 5\r\nConnection: keep-alive\r\n\r\nhello"
+    "HTTP/1.1 204 No Content\r\n\r\n",
+    "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\na\r\n0123456789\r\n0\r\n\r\n",
+    "HTTP/1.0 200 OK\r\nServer: test\r\n\r\nthe body runs until the connection closes",
+};
+
+// Tokens a mutation may splice in, the bytes the parser's states turn on.
+const char* tokens[] = {
+    "\r\n", "\r\n\r\n", ":", " ", "\t", "0", "9", "f", "Content-Length: ", "Transfer-Encoding: chunked\r\n",
+    "Connection: close\r\n", "HTTP/1.1", "GET ", "HEAD ", ";", "\n",
+};
+
+std::string mutate(const std::string& seed, Random& random)
+{
+    std::string text = seed;
+    size_t count     = 1 + random.below(4);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        size_t pos = random.below(text.size() + 1);
+
+        switch (random.below(4))
+        {
+        case 0:
+            if (pos < text.size())
+                text[pos] = static_cast<char>(random.below(256));
+            break;
+        case 1:
+            if (pos < text.size())
+                text.erase(pos, 1 + random.below(4));
+            break;
+        case 2:
+            text.insert(pos, tokens[random.below(sizeof(tokens) / sizeof(tokens[0]))]);
+            break;
+        default:
+            text.insert(pos, text.substr(random.below(text.size() + 1), random.below(32)));
+            break;
+        }
+    }
+
+    return text;
+}
+
+void run(uint8_t selector, const std::string& text)
+{
+    std::string input(1, static_cast<char>(selector));
+    input += text;
+    LLVMFuzzerTestOneInput(reinterpret_cast<const uint8_t*>(input.data()), input.size());
+}
+
+}  // namespace
+
+// split_fuzzer [-runs=N] [file...]
+int main(int argc, char** argv)
+{
+    unsigned long runs = 10000;
+    std::vector<std::string> files;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strncmp(argv[i], "-runs=", 6) == 0)
+            runs = strtoul(argv[i] + 6, NULL, 10);
+        else
+            files.push_back(argv[i]);
+    }
+
+    if (!files.empty())
+    {
+        for (size_t i = 0; i < files.size(); ++i)
+        {
+            std::ifstream file(files[i].c_str(), std::ios::binary);
+            if (!file)
+            {
+                fprintf(stderr, "cannot read %s\n", files[i].c_str());
+                return 1;
+            }
+
+            std::string input((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            LLVMFuzzerTestOneInput(reinterpret_cast<const uint8_t*>(input.data()), input.size());
+        }
+    }
+    else
+    {
+        Random random(runs);
+        size_t seedCount = sizeof(seeds) / sizeof(seeds[0]);
+
+        for (size_t i = 0; i < seedCount; ++i)
+        {
+            bool response = strncmp(seeds[i], "HTTP/", 5) == 0;
+            run(response ? 3 : 0, seeds[i]);
+        }
+
+        for (unsigned long i = 0; i < runs; ++i)
+        {
+            std::string seed = seeds[random.below(seedCount)];
+            bool response    = seed.compare(0, 5, "HTTP/") == 0;
+            uint8_t selector = static_cast<uint8_t>((random.below(128) << 1) | (response ? 1 : 0));
+            run(selector, mutate(seed, random));
+        }
+    }
+
+    for (int d = 0; d < DeliveryCount; ++d)
+    {
+        double mbs = timings[d].seconds > 0 ? timings[d].bytes / timings[d].seconds / (1024 * 1024) : 0;
+        printf("%-14s %10.0f bytes %8.3f s %10.2f MB/s\n", deliveryNames[d], timings[d].bytes, timings[d].seconds,
+               mbs);
+    }
+
+    return 0;
+}
+
+#endif  // HTTPPARSER_LIBFUZZER
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) Alex Nekipelov (alex@nekipelov.net)
+ * License: MIT
+ */
+
+#ifndef HTTPPARSER_ARENA_H
+#define HTTPPARSER_ARENA_H
+
+#include <algorithm>
+#include <new>
+#include <vector>
+
+#include <assert.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "slice.h"
+
+namespace httpparser
+{
+
+// Monotonic byte storage for the fields of one message at a time. Bytes are handed out from
+// a list of blocks and are only released all at once by reset(), which keeps the blocks for
+// the next message. After the first few messages on a connection nothing is allocated anymore.
+//
+// Fields are built one after another: append() only grows the most recently started slice.
+// A slice that outgrows its block moves to the next one, so every slice stays contiguous.
+class Arena
+{
+public:
+    explicit Arena(size_t blockSize = 4096) : head(NULL), current(NULL), used(0), blockSize(blockSize) {}
+
+    ~Arena()
+    {
+        while (head)
+        {
+            Block* next = head->next;
+            ::operator delete(head);
+            head = next;
+        }
+    }
+
+    // Append [p, p + n) to `s`, which is either empty or the last slice appended to.
+    void append(Slice& s, const char* p, size_t n)
+    {
+        assert(s.empty() || s.end() == top());
+
+        if (n == 0)
+            return;
+
+        if (available() < n)
+            moveToNextBlock(s, s.size() + n);
+
+        char* dst = top();
+        memcpy(dst, p, n);
+        used += n;
+
+        s = Slice(s.empty() ? dst : s.data(), s.size() + n);
+    }
+
+    // Append to the last slice of `v` if it is the last one appended to, or start a new slice.
+    void append(std::vector<Slice>& v, const char* p, size_t n)
+    {
+        if (v.empty() || v.back().end() != top())
+            v.push_back(Slice());
+
+        append(v.back(), p, n);
+    }
+
+    // Release every slice at once. The blocks are kept for reuse.
+    void reset()
+    {
+        current = head;
+        used    = 0;
+    }
+
+    // Total size of the blocks.
+    size_t capacity() const
+    {
+        size_t result = 0;
+
+        for (Block* b = head; b; b = b->next)
+            result += b->size;
+
+        return result;
+    }
+
+private:
+    Arena(const Arena&);
+    Arena& operator=(const Arena&);
+
+    struct Block
+    {
+        Block* next;
+        size_t size;
+
+        char* data() { return reinterpret_cast<char*>(this + 1); }
+    };
+
+    char* top() const { return current ? current->data() + used : NULL; }
+
+    size_t available() const { return current ? current->size - used : 0; }
+
+    // Continue in a block with room for `size` bytes, taking along the bytes of `s` built so far.
+    void moveToNextBlock(Slice& s, size_t size)
+    {
+        Block* next = current ? current->next : head;
+
+        if (!next || next->size < size)
+        {
+            size_t n = std::max(blockSize, 2 * size);
+
+            Block* b = static_cast<Block*>(::operator new(sizeof(Block) + n));
+            b->next  = next;
+            b->size  = n;
+
+            if (current)
+                current->next = b;
+            else
+                head = b;
+
+            next = b;
+        }
+
+        if (!s.empty())
+            memcpy(next->data(), s.data(), s.size());
+
+        current = next;
+        used    = s.size();
+        s       = s.empty() ? Slice() : Slice(current->data(), s.size());
+    }
+
+    Block* head;
+    Block* current;
+    // Bytes taken from the current block.
+    size_t used;
+    size_t blockSize;
+};
+
+}  // namespace httpparser
+
+#endif  // HTTPPARSER_ARENA_H
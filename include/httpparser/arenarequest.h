@@ -0,0 +1,36 @@
+/*
+ * Copyright (C) Alex Nekipelov (alex@nekipelov.net)
+ * License: MIT
+ */
+
+#ifndef HTTPPARSER_ARENAREQUEST_H
+#define HTTPPARSER_ARENAREQUEST_H
+
+#include "arena.h"
+#include "requestview.h"
+
+namespace httpparser
+{
+
+// A RequestView whose slices point into an arena the request owns instead of into the parsed
+// buffer, so the buffer can be reused as soon as parse() returns. Keep one ArenaRequest per
+// connection and clear() it between messages: the text of the next message goes to the same
+// memory and the vectors keep their capacity, so a warmed-up connection does not allocate.
+//
+// The body is stored as a single slice.
+struct ArenaRequest : RequestView
+{
+    explicit ArenaRequest(size_t blockSize = 4096) : arena(blockSize) {}
+
+    void clear()
+    {
+        RequestView::clear();
+        arena.reset();
+    }
+
+    Arena arena;
+};
+
+}  // namespace httpparser
+
+#endif  // HTTPPARSER_ARENAREQUEST_H
@@ -0,0 +1,31 @@
+/*
+ * Copyright (C) Alex Nekipelov (alex@nekipelov.net)
+ * License: MIT
+ */
+
+#ifndef HTTPPARSER_ARENARESPONSE_H
+#define HTTPPARSER_ARENARESPONSE_H
+
+#include "arena.h"
+#include "responseview.h"
+
+namespace httpparser
+{
+
+// A ResponseView whose slices point into an arena the response owns, see ArenaRequest.
+struct ArenaResponse : ResponseView
+{
+    explicit ArenaResponse(size_t blockSize = 4096) : arena(blockSize) {}
+
+    void clear()
+    {
+        ResponseView::clear();
+        arena.reset();
+    }
+
+    Arena arena;
+};
+
+}  // namespace httpparser
+
+#endif  // HTTPPARSER_ARENARESPONSE_H
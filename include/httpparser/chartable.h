@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) Alex Nekipelov (alex@nekipelov.net)
+ * License: MIT
+ */
+
+#ifndef HTTPPARSER_CHARTABLE_H
+#define HTTPPARSER_CHARTABLE_H
+
+#include <stddef.h>
+
+namespace httpparser
+{
+
+// Character classes of the HTTP and URL grammar, one bit per class.
+enum CharClass
+{
+    CharToken      = 0x01,  // tchar (RFC 7230): methods, header names, chunk extensions
+    CharText       = 0x02,  // anything but a control character: URIs, header values, reason phrases
+    CharDigit      = 0x04,
+    CharHex        = 0x08,
+    CharAlnum      = 0x10,
+    CharUnreserved = 0x20,  // unreserved (RFC 3986): ALPHA / DIGIT / "-" / "." / "_" / "~"
+    CharScheme     = 0x40   // ALPHA / DIGIT / "+" / "-" / "."
+};
+
+// Classes of every byte value, indexed by the unsigned byte. Unlike <cctype> the result does not
+// depend on the locale. The table is a static member of a class template, so that it can be
+// defined in a header.
+template <typename T = void>
+struct BasicCharTable
+{
+    static constexpr unsigned char flags[256] = {
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // 0x00
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // 0x10
+        0x02, 0x03, 0x02, 0x03, 0x03, 0x03, 0x03, 0x03, 0x02, 0x02, 0x03, 0x43, 0x02, 0x63, 0x63, 0x02,  // 0x20
+        0x7f, 0x7f, 0x7f, 0x7f, 0x7f, 0x7f, 0x7f, 0x7f, 0x7f, 0x7f, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,  // 0x30
+        0x02, 0x7b, 0x7b, 0x7b, 0x7b, 0x7b, 0x7b, 0x73, 0x73, 0x73, 0x73, 0x73, 0x73, 0x73, 0x73, 0x73,  // 0x40
+        0x73, 0x73, 0x73, 0x73, 0x73, 0x73, 0x73, 0x73, 0x73, 0x73, 0x73, 0x02, 0x02, 0x02, 0x03, 0x23,  // 0x50
+        0x03, 0x7b, 0x7b, 0x7b, 0x7b, 0x7b, 0x7b, 0x73, 0x73, 0x73, 0x73, 0x73, 0x73, 0x73, 0x73, 0x73,  // 0x60
+        0x73, 0x73, 0x73, 0x73, 0x73, 0x73, 0x73, 0x73, 0x73, 0x73, 0x73, 0x02, 0x03, 0x02, 0x23, 0x00,  // 0x70
+        0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,  // 0x80
+        0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,  // 0x90
+        0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,  // 0xa0
+        0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,  // 0xb0
+        0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,  // 0xc0
+        0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,  // 0xd0
+        0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,  // 0xe0
+        0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02   // 0xf0
+    };
+};
+
+template <typename T>
+constexpr unsigned char BasicCharTable<T>::flags[256];
+
+typedef BasicCharTable<> CharTable;
+
+inline bool isCharClass(char c, unsigned char charClass)
+{
+    return (CharTable::flags[static_cast<unsigned char>(c)] & charClass) != 0;
+}
+
+inline bool isToken(char c) { return isCharClass(c, CharToken); }
+inline bool isText(char c) { return isCharClass(c, CharText); }
+inline bool isDigit(char c) { return isCharClass(c, CharDigit); }
+inline bool isHexDigit(char c) { return isCharClass(c, CharHex); }
+inline bool isAlnum(char c) { return isCharClass(c, CharAlnum); }
+inline bool isUnreserved(char c) { return isCharClass(c, CharUnreserved); }
+inline bool isSchemeChar(char c) { return isCharClass(c, CharScheme); }
+
+// reason-phrase (RFC 9112): text and HTAB.
+inline bool isPhraseChar(char c) { return c == '\t' || isText(c); }
+
+// ASCII lowercase, independent of the locale.
+inline char toLower(char c) { return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c; }
+
+// Value of a hex digit.
+inline unsigned int hexValue(char c)
+{
+    return isDigit(c) ? static_cast<unsigned int>(c - '0') : static_cast<unsigned int>(toLower(c) - 'a' + 10);
+}
+
+inline bool equalsIgnoreCase(const char* a, const char* b, size_t size)
+{
+    for (size_t i = 0; i < size; ++i)
+    {
+        if (toLower(a[i]) != toLower(b[i]))
+            return false;
+    }
+
+    return true;
+}
+
+}  // namespace httpparser
+
+#endif  // HTTPPARSER_CHARTABLE_H
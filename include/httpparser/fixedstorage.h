@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) Alex Nekipelov (alex@nekipelov.net)
+ * License: MIT
+ */
+
+#ifndef HTTPPARSER_FIXEDSTORAGE_H
+#define HTTPPARSER_FIXEDSTORAGE_H
+
+#include <assert.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "slice.h"
+
+namespace httpparser
+{
+
+// Inline byte storage of `Size` bytes with the append() interface of Arena. It never allocates;
+// append() returns false once the bytes do not fit anymore.
+template <size_t Size>
+class FixedBuffer
+{
+public:
+    FixedBuffer() : used(0) {}
+
+    // Append [p, p + n) to `s`, which is either empty or the last slice appended to.
+    bool append(Slice& s, const char* p, size_t n)
+    {
+        assert(s.empty() || s.end() == data + used);
+
+        if (n > Size - used)
+            return false;
+
+        memcpy(data + used, p, n);
+        s = Slice(s.empty() ? data + used : s.data(), s.size() + n);
+        used += n;
+        return true;
+    }
+
+    void reset() { used = 0; }
+
+    size_t size() const { return used; }
+    static size_t capacity() { return Size; }
+
+private:
+    FixedBuffer(const FixedBuffer&);
+    FixedBuffer& operator=(const FixedBuffer&);
+
+    char data[Size];
+    size_t used;
+};
+
+// A vector of at most `Capacity` elements stored inline. push_back() returns false when full.
+template <typename T, size_t Capacity>
+class FixedVector
+{
+public:
+    typedef T value_type;
+    typedef const T* const_iterator;
+
+    FixedVector() : count(0) {}
+
+    bool push_back(const T& value)
+    {
+        if (count == Capacity)
+            return false;
+
+        items[count++] = value;
+        return true;
+    }
+
+    void clear() { count = 0; }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    static size_t capacity() { return Capacity; }
+
+    T& operator[](size_t i) { return items[i]; }
+    const T& operator[](size_t i) const { return items[i]; }
+
+    T& back() { return items[count - 1]; }
+    const T& back() const { return items[count - 1]; }
+
+    const_iterator begin() const { return items; }
+    const_iterator end() const { return items + count; }
+
+private:
+    T items[Capacity];
+    size_t count;
+};
+
+}  // namespace httpparser
+
+#endif  // HTTPPARSER_FIXEDSTORAGE_H
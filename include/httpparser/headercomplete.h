@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) Alex Nekipelov (alex@nekipelov.net)
+ * License: MIT
+ */
+
+#ifndef HTTPPARSER_HEADERCOMPLETE_H
+#define HTTPPARSER_HEADERCOMPLETE_H
+
+#include <stddef.h>
+
+#include "scan.h"
+
+namespace httpparser
+{
+
+// Whether [begin, end), the bytes of a message received so far, holds the complete header block.
+// When data trickles in, call it on every read and run the parser once it returns true: the
+// parser then goes over the whole block in one call instead of resuming on every fragment.
+//
+// `scanned` carries the progress between calls on the same, growing buffer and must start at 0.
+// On success it is the size of the header block, the offset of the first body byte. Compare it
+// with ParserLimits::maxHeaderBytes to drop a peer that never finishes its headers.
+inline bool isHeaderComplete(const char* begin, const char* end, size_t& scanned)
+{
+    size_t size = end - begin;
+
+    if (scanned > size)
+        scanned = size;
+
+    const char* blank = scan::blankLine(begin + scanned, end);
+
+    if (blank != end)
+    {
+        scanned = blank + 4 - begin;
+        return true;
+    }
+
+    // The next call starts over the last three bytes, which may begin the blank line.
+    if (size > scanned + 3)
+        scanned = size - 3;
+
+    return false;
+}
+
+}  // namespace httpparser
+
+#endif  // HTTPPARSER_HEADERCOMPLETE_H
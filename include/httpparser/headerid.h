@@ -0,0 +1,219 @@
+/*
+ * Copyright (C) Alex Nekipelov (alex@nekipelov.net)
+ * License: MIT
+ */
+
+#ifndef HTTPPARSER_HEADERID_H
+#define HTTPPARSER_HEADERID_H
+
+#include <string>
+
+#include <stddef.h>
+#include <string.h>
+
+#include "chartable.h"
+
+namespace httpparser
+{
+
+// Well-known header names. The parser classifies every header name it reads, so the framing
+// headers need no string comparison and applications can switch on the ID.
+enum HeaderId
+{
+    HeaderUnknown,
+    HeaderAccept,
+    HeaderAcceptCharset,
+    HeaderAcceptEncoding,
+    HeaderAcceptLanguage,
+    HeaderAcceptRanges,
+    HeaderAge,
+    HeaderAllow,
+    HeaderAuthorization,
+    HeaderCacheControl,
+    HeaderConnection,
+    HeaderContentDisposition,
+    HeaderContentEncoding,
+    HeaderContentLanguage,
+    HeaderContentLength,
+    HeaderContentLocation,
+    HeaderContentRange,
+    HeaderContentType,
+    HeaderCookie,
+    HeaderDate,
+    HeaderEtag,
+    HeaderExpect,
+    HeaderExpires,
+    HeaderForwarded,
+    HeaderHost,
+    HeaderIfMatch,
+    HeaderIfModifiedSince,
+    HeaderIfNoneMatch,
+    HeaderIfRange,
+    HeaderIfUnmodifiedSince,
+    HeaderKeepAlive,
+    HeaderLastModified,
+    HeaderLink,
+    HeaderLocation,
+    HeaderOrigin,
+    HeaderPragma,
+    HeaderProxyAuthenticate,
+    HeaderProxyAuthorization,
+    HeaderRange,
+    HeaderReferer,
+    HeaderRetryAfter,
+    HeaderServer,
+    HeaderSetCookie,
+    HeaderTe,
+    HeaderTrailer,
+    HeaderTransferEncoding,
+    HeaderUpgrade,
+    HeaderUserAgent,
+    HeaderVary,
+    HeaderVia,
+    HeaderWwwAuthenticate,
+    HeaderXForwardedFor,
+    HeaderXForwardedProto,
+    HeaderXRealIp,
+    HeaderXRequestedWith,
+
+    HeaderIdCount
+};
+
+// Perfect hash of the names above: the first, middle and last byte (lowercased) and the length
+// map every well-known name to its own slot. Other names may share a slot and are told apart by
+// a case-insensitive compare.
+constexpr unsigned int headerHash(const char* name, size_t size)
+{
+    return static_cast<unsigned int>(((static_cast<unsigned char>(name[0]) | 0x20) * 90u
+                                      + (static_cast<unsigned char>(name[size / 2]) | 0x20) * 68u
+                                      + (static_cast<unsigned char>(name[size - 1]) | 0x20) * 83u + size * 59u)
+                                     % 128u);
+}
+
+template <typename T = void>
+struct BasicHeaderTable
+{
+    // Canonical spelling, indexed by HeaderId.
+    static constexpr const char* names[HeaderIdCount] = {
+        "",
+        "Accept",
+        "Accept-Charset",
+        "Accept-Encoding",
+        "Accept-Language",
+        "Accept-Ranges",
+        "Age",
+        "Allow",
+        "Authorization",
+        "Cache-Control",
+        "Connection",
+        "Content-Disposition",
+        "Content-Encoding",
+        "Content-Language",
+        "Content-Length",
+        "Content-Location",
+        "Content-Range",
+        "Content-Type",
+        "Cookie",
+        "Date",
+        "ETag",
+        "Expect",
+        "Expires",
+        "Forwarded",
+        "Host",
+        "If-Match",
+        "If-Modified-Since",
+        "If-None-Match",
+        "If-Range",
+        "If-Unmodified-Since",
+        "Keep-Alive",
+        "Last-Modified",
+        "Link",
+        "Location",
+        "Origin",
+        "Pragma",
+        "Proxy-Authenticate",
+        "Proxy-Authorization",
+        "Range",
+        "Referer",
+        "Retry-After",
+        "Server",
+        "Set-Cookie",
+        "TE",
+        "Trailer",
+        "Transfer-Encoding",
+        "Upgrade",
+        "User-Agent",
+        "Vary",
+        "Via",
+        "WWW-Authenticate",
+        "X-Forwarded-For",
+        "X-Forwarded-Proto",
+        "X-Real-IP",
+        "X-Requested-With",
+    };
+
+    // HeaderId of the name that hashes to each slot.
+    static constexpr unsigned char slots[128] = {
+         0,  0,  0,  0, 49,  0,  7, 40,  0,  0,  0, 37, 45,  0,  0,  0,
+         0, 35, 10,  0,  0,  0,  0, 20,  0, 50,  0,  0,  0,  9, 41, 23,
+         0, 17, 29, 19, 24,  0,  0,  8, 52,  0,  0,  0,  0,  0,  0,  0,
+         0,  0, 38,  0, 14,  0,  0, 12,  0,  0,  0,  0,  2, 11, 25, 44,
+         0,  0,  0,  0,  0, 28, 46,  0,  3,  0, 33,  0, 22, 32,  0,  0,
+        47, 43,  0,  0, 21,  0,  5, 53, 15,  0,  0, 18, 16,  0,  0, 31,
+         0,  0,  0, 51,  0, 36,  6,  0, 54,  0,  0, 48,  1, 13, 34, 30,
+         0,  0,  0,  0,  0, 27,  0, 42, 26,  0,  0, 39,  0,  0,  4,  0
+    };
+};
+
+template <typename T>
+constexpr const char* BasicHeaderTable<T>::names[HeaderIdCount];
+
+template <typename T>
+constexpr unsigned char BasicHeaderTable<T>::slots[128];
+
+typedef BasicHeaderTable<> HeaderTable;
+
+// The slots are computed by hand: check at compile time that every well-known name hashes to
+// the slot holding its ID, and that no slot holds a name hashing elsewhere.
+constexpr size_t headerNameLength(const char* name) { return *name ? 1 + headerNameLength(name + 1) : 0; }
+
+constexpr unsigned int headerSlot(unsigned int id)
+{
+    return headerHash(HeaderTable::names[id], headerNameLength(HeaderTable::names[id]));
+}
+
+constexpr bool headerNamesInTheirSlots(unsigned int id = HeaderUnknown + 1)
+{
+    return id == HeaderIdCount || (HeaderTable::slots[headerSlot(id)] == id && headerNamesInTheirSlots(id + 1));
+}
+
+constexpr bool headerSlotsHoldTheirNames(unsigned int slot = 0)
+{
+    return slot == 128
+           || ((HeaderTable::slots[slot] == HeaderUnknown || headerSlot(HeaderTable::slots[slot]) == slot)
+               && headerSlotsHoldTheirNames(slot + 1));
+}
+
+static_assert(headerNamesInTheirSlots(), "HeaderTable::slots does not match headerHash()");
+static_assert(headerSlotsHoldTheirNames(), "HeaderTable::slots holds a name in the wrong slot");
+
+// Canonical name of a header ID, an empty string for HeaderUnknown.
+inline const char* headerName(HeaderId id) { return HeaderTable::names[id]; }
+
+// Classify a header name, ignoring case.
+inline HeaderId headerId(const char* name, size_t size)
+{
+    if (size == 0)
+        return HeaderUnknown;
+
+    HeaderId id           = static_cast<HeaderId>(HeaderTable::slots[headerHash(name, size)]);
+    const char* candidate = HeaderTable::names[id];
+
+    return strlen(candidate) == size && equalsIgnoreCase(name, candidate, size) ? id : HeaderUnknown;
+}
+
+inline HeaderId headerId(const std::string& name) { return headerId(name.data(), name.size()); }
+
+}  // namespace httpparser
+
+#endif  // HTTPPARSER_HEADERID_H
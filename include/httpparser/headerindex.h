@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) Alex Nekipelov (alex@nekipelov.net)
+ * License: MIT
+ */
+
+#ifndef HTTPPARSER_HEADERINDEX_H
+#define HTTPPARSER_HEADERINDEX_H
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "chartable.h"
+#include "headerid.h"
+
+namespace httpparser
+{
+
+// The name to look up with Request::header(), has() and findAll(): a C string, a std::string or
+// a HeaderId. Well-known names are matched by ID, others by a case-insensitive compare.
+class HeaderKey
+{
+public:
+    HeaderKey(const char* name) : name(name), size(strlen(name)), id(headerId(name, size)) {}
+    HeaderKey(const std::string& name) : name(name.data()), size(name.size()), id(headerId(name)) {}
+    HeaderKey(HeaderId id) : name(headerName(id)), size(strlen(name)), id(id) {}
+
+    // FNV-1a of the lowercased name.
+    static uint32_t hash(const char* p, size_t n)
+    {
+        uint32_t h = 2166136261u;
+
+        for (size_t i = 0; i < n; ++i)
+            h = (h ^ static_cast<unsigned char>(toLower(p[i]))) * 16777619u;
+
+        return h;
+    }
+
+    uint32_t hash() const { return hash(name, size); }
+
+    template <typename Item>
+    bool matches(const Item& item) const
+    {
+        if (id != HeaderUnknown && item.id != HeaderUnknown)
+            return id == item.id;
+
+        return item.name.size() == size && equalsIgnoreCase(item.name.data(), name, size);
+    }
+
+private:
+    const char* name;
+    size_t size;
+    HeaderId id;
+};
+
+// Open-addressing table from header names to positions in a header vector. Each slot holds the
+// first and the last header of one name; the headers of the same name are chained in `next`.
+//
+// The index covers the first size() headers and is only valid until they change: call build()
+// again after any edit. Lookups notice headers added or removed since and scan them linearly,
+// but a header renamed in place goes unnoticed.
+template <typename Alloc = std::allocator<char> >
+class BasicHeaderIndex
+{
+public:
+    explicit BasicHeaderIndex(const Alloc& alloc = Alloc()) : slots(alloc), next(alloc) {}
+
+    static const size_t npos = static_cast<size_t>(-1);
+
+    // Number of headers covered.
+    size_t size() const { return next.size(); }
+
+    // Forget all headers, keeping the capacity.
+    void clear()
+    {
+        std::fill(slots.begin(), slots.end(), Slot());
+        next.clear();
+    }
+
+    // Index all of `headers` from scratch.
+    template <typename Headers>
+    void build(const Headers& headers)
+    {
+        size_t capacity = std::max<size_t>(slots.size(), 16);
+
+        while (capacity < 2 * headers.size())
+            capacity *= 2;
+
+        if (capacity != slots.size())
+            slots.resize(capacity);
+
+        clear();
+        next.reserve(headers.size());
+        for (size_t i = 0; i < headers.size(); ++i)
+            insert(headers, i);
+    }
+
+    // Position of the first header matching `key`, or npos.
+    template <typename Headers>
+    size_t find(const Headers& headers, const HeaderKey& key) const
+    {
+        if (next.size() != headers.size())
+        {
+            for (size_t i = 0; i < headers.size(); ++i)
+            {
+                if (key.matches(headers[i]))
+                    return i;
+            }
+
+            return npos;
+        }
+
+        if (slots.empty())
+            return npos;
+
+        uint32_t hash = key.hash();
+        size_t mask   = slots.size() - 1;
+
+        for (size_t i = hash & mask; slots[i].first != 0; i = (i + 1) & mask)
+        {
+            if (slots[i].hash == hash && key.matches(headers[slots[i].first - 1]))
+                return slots[i].first - 1;
+        }
+
+        return npos;
+    }
+
+    // Position of the next header after `pos` with the same name, or npos.
+    template <typename Headers>
+    size_t findNext(const Headers& headers, const HeaderKey& key, size_t pos) const
+    {
+        if (next.size() == headers.size())
+            return next[pos] == 0 ? npos : next[pos] - 1;
+
+        for (size_t i = pos + 1; i < headers.size(); ++i)
+        {
+            if (key.matches(headers[i]))
+                return i;
+        }
+
+        return npos;
+    }
+
+private:
+    struct Slot
+    {
+        Slot() : hash(0), first(0), last(0) {}
+
+        uint32_t hash;
+        // Positions plus one, zero marks an empty slot or the end of a chain.
+        uint32_t first;
+        uint32_t last;
+    };
+
+    template <typename Headers>
+    void insert(const Headers& headers, size_t pos)
+    {
+        const typename Headers::value_type& item = headers[pos];
+
+        uint32_t hash = HeaderKey::hash(item.name.data(), item.name.size());
+        size_t mask   = slots.size() - 1;
+        size_t i      = hash & mask;
+
+        next.push_back(0);
+
+        for (; slots[i].first != 0; i = (i + 1) & mask)
+        {
+            const typename Headers::value_type& other = headers[slots[i].first - 1];
+
+            if (slots[i].hash == hash && other.name.size() == item.name.size()
+                && equalsIgnoreCase(other.name.data(), item.name.data(), item.name.size()))
+            {
+                next[slots[i].last - 1] = static_cast<uint32_t>(pos + 1);
+                slots[i].last           = static_cast<uint32_t>(pos + 1);
+                return;
+            }
+        }
+
+        slots[i].hash  = hash;
+        slots[i].first = static_cast<uint32_t>(pos + 1);
+        slots[i].last  = static_cast<uint32_t>(pos + 1);
+    }
+
+    typedef std::allocator_traits<Alloc> AllocatorTraits;
+
+    std::vector<Slot, typename AllocatorTraits::template rebind_alloc<Slot> > slots;
+    std::vector<uint32_t, typename AllocatorTraits::template rebind_alloc<uint32_t> > next;
+};
+
+template <typename Alloc>
+const size_t BasicHeaderIndex<Alloc>::npos;
+
+typedef BasicHeaderIndex<> HeaderIndex;
+
+}  // namespace httpparser
+
+#endif  // HTTPPARSER_HEADERINDEX_H
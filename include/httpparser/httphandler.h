@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) Alex Nekipelov (alex@nekipelov.net)
+ * License: MIT
+ */
+
+#ifndef HTTPPARSER_HTTPHANDLER_H
+#define HTTPPARSER_HTTPHANDLER_H
+
+#include <string>
+#include <vector>
+
+#include <assert.h>
+#include <stddef.h>
+
+#include "headerid.h"
+#include "method.h"
+#include "slice.h"
+
+namespace httpparser
+{
+
+// Event interface of HttpRequestParser::parse(Handler&, ...) and HttpResponseParser::parse(Handler&, ...).
+//
+// The handler type is a template parameter of parse(), so the calls are resolved at compile time.
+// Derive from HttpHandler and hide only the callbacks you need. Returning false from a callback
+// stops parsing with ParsingError.
+//
+// Data callbacks receive slices of the buffer passed to parse(). A token split across several
+// parse() calls is reported in several fragments which must be concatenated; the pointers are
+// only valid during the callback unless the caller keeps the buffer alive.
+struct HttpHandler
+{
+    // Request line.
+    bool onMethod(const char*, size_t) { return true; }
+    // The method is complete: its well-known ID, or MethodUnknown.
+    bool onMethodId(Method) { return true; }
+    bool onUri(const char*, size_t) { return true; }
+
+    // Status line.
+    bool onStatusCode(unsigned int) { return true; }
+    bool onStatus(const char*, size_t) { return true; }
+
+    // HTTP version of the request or the status line.
+    bool onVersion(int /*major*/, int /*minor*/) { return true; }
+
+    // A new header line starts, the onHeaderField() and onHeaderValue() fragments that follow belong to it.
+    bool onHeaderBegin() { return true; }
+    bool onHeaderField(const char*, size_t) { return true; }
+    // The header name is complete: its well-known ID, or HeaderUnknown.
+    bool onHeaderId(HeaderId) { return true; }
+    bool onHeaderValue(const char*, size_t) { return true; }
+    bool onHeadersComplete(bool /*keepAlive*/) { return true; }
+
+    bool onBody(const char*, size_t) { return true; }
+    bool onMessageComplete() { return true; }
+
+protected:
+    // Store a fragment into a field of an owning or a view message.
+    template <typename Traits, typename Alloc>
+    static void append(std::basic_string<char, Traits, Alloc>& s, const char* p, size_t n)
+    {
+        s.append(p, n);
+    }
+
+    static void append(Slice& s, const char* p, size_t n)
+    {
+        // Views of one message share a single contiguous buffer, so a later fragment of the same
+        // field just moves the end. Anything between the fragments (an obs-fold) stays in the slice.
+        assert(s.empty() || s.end() <= p);
+
+        if (s.empty())
+            s = Slice(p, n);
+        else
+            s = Slice(s.data(), p + n - s.data());
+    }
+
+    template <typename Alloc>
+    static void append(std::vector<char, Alloc>& v, const char* p, size_t n)
+    {
+        v.insert(v.end(), p, p + n);
+    }
+
+    static void append(std::vector<Slice>& v, const char* p, size_t n)
+    {
+        if (v.empty() || v.back().end() != p)
+            v.push_back(Slice(p, n));
+        else
+            v.back().extend(p, n);
+    }
+
+    template <typename Traits, typename Alloc>
+    static void reserve(std::basic_string<char, Traits, Alloc>& s, size_t n)
+    {
+        s.reserve(n);
+    }
+
+    static void reserve(Slice&, size_t) {}
+};
+
+}  // namespace httpparser
+
+#endif  // HTTPPARSER_HTTPHANDLER_H
@@ -0,0 +1,898 @@
+/*
+ * Copyright (C) Alex Nekipelov (alex@nekipelov.net)
+ * License: MIT
+ */
+
+#ifndef HTTPPARSER_HTTPPARSERBASE_H
+#define HTTPPARSER_HTTPPARSERBASE_H
+
+#include <algorithm>
+
+#include <stdint.h>
+#include <string.h>
+
+#include "chartable.h"
+#include "headercomplete.h"
+#include "headerid.h"
+#include "httphandler.h"
+#include "parserlimits.h"
+#include "scan.h"
+
+namespace httpparser
+{
+
+// The part of the HTTP/1.x state machine that requests and responses share: header lines,
+// Content-Length and chunked bodies. `Derived` only parses its start line, through
+//
+//   template <typename Handler>
+//   ParseResult consumeStartLine(Handler&, const char* pos, const char*& begin, const char* end, const char*& mark);
+//   template <typename Handler> bool emitStartLine(Handler&, const char* p, size_t n);
+//   void resetStartLine();
+//   bool startLineStarted() const;
+//   static const bool closeDelimited;  // whether a body without framing runs until the connection closes
+//
+// and moves `state` to StartLineNewLine once it has seen the CR that ends the start line. It is
+// handed the byte at `pos` and may take more of them at once by moving `begin` further.
+template <typename Derived>
+class HttpParserBase
+{
+public:
+    enum ParseResult
+    {
+        ParsingCompleted,
+        ParsingIncompleted,
+        ParsingError,
+        // The message goes over a ParserLimits bound or the fixed capacity of the message it is
+        // parsed into, error() tells which.
+        ParsingTooLarge,
+        // In headers-only mode: the headers are complete and a body follows, see setHeadersOnly().
+        ParsingHeadersCompleted
+    };
+
+    // How the body of the message is delimited, known once the headers are complete.
+    enum BodyFraming
+    {
+        NoBody,
+        ContentLengthBody,
+        ChunkedBody,
+        // Until the connection closes.
+        CloseDelimitedBody
+    };
+
+    // Why the last parse() failed.
+    enum ParseError
+    {
+        NoError,
+        // Malformed, or rejected by the handler.
+        InvalidMessage,
+        UriTooLong,
+        HeadersTooLarge,
+        TooManyHeaders,
+        BodyTooLarge,
+        // A StaticRequest or StaticResponse ran out of room.
+        CapacityExceeded
+    };
+
+    ParseError error() const { return errorCode; }
+
+    // Make parse() return ParsingHeadersCompleted as soon as the headers of a message with a body
+    // are complete, without looking at the body. With parse(..., consumed) the body starts at
+    // `consumed`; forward it by framing() and contentLength(), or call parse() again to go on
+    // with the body. A message without a body still ends with ParsingCompleted.
+    void setHeadersOnly(bool enabled) { headersOnly = enabled; }
+
+    BodyFraming framing() const { return bodyFraming; }
+
+    // The Content-Length of a ContentLengthBody message.
+    uint64_t contentLength() const { return bodyFraming == ContentLengthBody ? bodyLength : 0; }
+
+    const ParserLimits& limits() const { return config; }
+
+    // New limits apply to the bytes parsed from now on.
+    void setLimits(const ParserLimits& limits) { config = limits; }
+
+    // Prepare for the next message on the same connection. Pair it with Request::clear() (or
+    // Response::clear()) to reuse the memory of the previous message.
+    void reset()
+    {
+        state                = StartLine;
+        contentSize          = 0;
+        chunkSize            = 0;
+        chunked              = false;
+        contentLengthSeen    = false;
+        transferEncodingSeen = false;
+        versionMajor         = 0;
+        versionMinor         = 0;
+        headerCount          = 0;
+        headerBytes          = 0;
+        bodySize             = 0;
+        header               = HeaderUnknown;
+        bodyAllowed          = true;
+        connectionSeen       = false;
+        connectionKeepAlive  = false;
+        errorCode            = NoError;
+        bodyFraming          = NoBody;
+        bodyLength           = 0;
+
+        derived().resetStartLine();
+    }
+
+    // Event-driven parsing without building a message object, see httphandler.h.
+    template <typename Handler>
+    ParseResult parse(Handler& handler, const char* begin, const char* end)
+    {
+        return consume(handler, begin, end);
+    }
+
+    // Same as above, but also report in `consumed` how many bytes of [begin, end) were used. Once
+    // the message is completed, the rest of the buffer is the start of the next pipelined message.
+    template <typename Handler>
+    ParseResult parse(Handler& handler, const char* begin, const char* end, size_t& consumed)
+    {
+        const char* pos = begin;
+        ParseResult res = consume(handler, pos, end);
+        consumed        = pos - begin;
+        return res;
+    }
+
+    // The peer closed the connection. Completes a body that runs until the close, see
+    // bodyUntilClose(). ParsingIncompleted if no message had started, ParsingError if the close
+    // cut the message short.
+    template <typename Handler>
+    ParseResult finish(Handler& handler)
+    {
+        if (state == BodyUntilClose)
+            return handler.onMessageComplete() ? ParsingCompleted : ParsingError;
+
+        if (state == StartLine && !derived().startLineStarted())
+            return ParsingIncompleted;
+
+        errorCode = InvalidMessage;
+        return ParsingError;
+    }
+
+    // Same for the message types, whose builders have nothing left to do at the end.
+    ParseResult finish()
+    {
+        HttpHandler handler;
+        return finish(handler);
+    }
+
+    // Whether the body of the message being parsed ends when the connection closes. Such a
+    // message is never kept alive.
+    bool bodyUntilClose() const { return state == BodyUntilClose; }
+
+protected:
+    explicit HttpParserBase(const ParserLimits& limits)
+        : state(StartLine),
+          contentSize(0),
+          chunkSize(0),
+          chunked(false),
+          contentLengthSeen(false),
+          transferEncodingSeen(false),
+          versionMajor(0),
+          versionMinor(0),
+          headerCount(0),
+          headerBytes(0),
+          bodySize(0),
+          header(HeaderUnknown),
+          bodyAllowed(true),
+          connectionSeen(false),
+          connectionKeepAlive(false),
+          errorCode(NoError),
+          headersOnly(false),
+          bodyFraming(NoBody),
+          bodyLength(0),
+          config(limits)
+    {
+    }
+
+    Derived& derived() { return static_cast<Derived&>(*this); }
+
+    // The 8 bytes at `p` as one word. A literal loaded the same way compares equal on any byte order.
+    static uint64_t loadWord(const char* p)
+    {
+        uint64_t w;
+        memcpy(&w, p, sizeof(w));
+        return w;
+    }
+
+    // Take "HTTP/1.1" or "HTTP/1.0" in the 8 bytes at `p` with one comparison. Other versions are
+    // left to the byte-by-byte states.
+    bool matchVersion(const char* p)
+    {
+        uint64_t w = loadWord(p);
+
+        if (w != loadWord("HTTP/1.1") && w != loadWord("HTTP/1.0"))
+            return false;
+
+        versionMajor = 1;
+        versionMinor = p[7] - '0';
+        return true;
+    }
+
+    // Report the part of the current token that lies in [p, p + n) to the handler and remember
+    // its beginning if the parser itself needs to understand the token.
+    template <typename Handler>
+    bool emit(Handler& handler, const char* p, size_t n)
+    {
+        if (n == 0)
+            return true;
+
+        switch (state)
+        {
+        case StartLine:
+            return derived().emitStartLine(handler, p, n);
+        case HeaderName:
+            if (!countHeaderBytes(n))
+                return false;
+
+            token.append(p, n);
+            return handler.onHeaderField(p, n);
+        case HeaderValue:
+            if (!countHeaderBytes(n))
+                return false;
+
+            // Only the final coding frames the message, however long the list is.
+            if (header == HeaderTransferEncoding)
+                value.appendListElement(p, n);
+            else
+                value.append(p, n);
+            return handler.onHeaderValue(p, n);
+        default:
+            return true;
+        }
+    }
+
+    // Stop with `error`, for the checks that return bool.
+    bool fail(ParseError error)
+    {
+        errorCode = error;
+        return false;
+    }
+
+    ParseResult tooLarge(ParseError error)
+    {
+        errorCode = error;
+        return ParsingTooLarge;
+    }
+
+    bool countHeaderBytes(size_t n)
+    {
+        headerBytes += n;
+        return headerBytes <= config.maxHeaderBytes || fail(HeadersTooLarge);
+    }
+
+    template <typename Handler>
+    ParseResult consume(Handler& handler, const char*& begin, const char* end)
+    {
+        ParseResult res = consumeMessage(handler, begin, end);
+
+        if (res != ParsingError)
+            return res;
+
+        // The checks of the limits fail through the same paths as syntax errors.
+        if (errorCode == NoError)
+            errorCode = InvalidMessage;
+
+        return errorCode == InvalidMessage ? ParsingError : ParsingTooLarge;
+    }
+
+    template <typename Handler>
+    ParseResult consumeMessage(Handler& handler, const char*& begin, const char* end)
+    {
+        // Start of the token the parser is in, reported when the token or the buffer ends.
+        const char* mark = begin;
+
+        while (begin != end)
+        {
+            const char* pos = begin++;
+            char input      = *pos;
+
+            switch (state)
+            {
+            case StartLine:
+            {
+                ParseResult res = derived().consumeStartLine(handler, pos, begin, end, mark);
+
+                if (res != ParsingIncompleted)
+                    return res;
+                break;
+            }
+            case StartLineNewLine:
+                if (input == '\n')
+                {
+                    state = HeaderLineStart;
+                }
+                else
+                {
+                    return ParsingError;
+                }
+                break;
+            case HeaderLineStart:
+                if (input == '\r')
+                {
+                    state = ExpectingNewline_3;
+                }
+                else if (headerCount != 0 && (input == ' ' || input == '\t'))
+                {
+                    if (!countHeaderBytes(1))
+                        return ParsingError;
+
+                    state = HeaderLws;
+                }
+                else if (!isToken(input))
+                {
+                    return ParsingError;
+                }
+                else
+                {
+                    if (++headerCount > config.maxHeaderCount)
+                        return tooLarge(TooManyHeaders);
+
+                    if (!handler.onHeaderBegin())
+                        return ParsingError;
+
+                    token.clear();
+                    value.clear();
+                    mark  = pos;
+                    state = HeaderName;
+                }
+                break;
+            case HeaderLws:
+                if (input == '\r')
+                {
+                    state = ExpectingNewline_2;
+                }
+                else if (input == ' ' || input == '\t')
+                {
+                    if (!countHeaderBytes(1))
+                        return ParsingError;
+                }
+                else if (!isText(input))
+                {
+                    return ParsingError;
+                }
+                else
+                {
+                    state = HeaderValue;
+                    mark  = pos;
+                }
+                break;
+            case HeaderName:
+                // Skip the rest of the name at once, it is reported when the name or the buffer ends.
+                pos = scan::token(pos, end);
+                if (pos == end)
+                {
+                    begin = end;
+                    break;
+                }
+
+                // Report the name before checking the byte after it: with the name split over
+                // several buffers its bytes would have counted against the limits already.
+                begin = pos + 1;
+                if (!emit(handler, mark, pos - mark) || *pos != ':')
+                    return ParsingError;
+
+                header = token.headerId();
+                if (!handler.onHeaderId(header))
+                    return ParsingError;
+
+                state = SpaceBeforeHeaderValue;
+                break;
+            case SpaceBeforeHeaderValue:
+                if (input == ' ')
+                {
+                    state = HeaderValue;
+                    mark  = begin;
+                }
+                else
+                {
+                    return ParsingError;
+                }
+                break;
+            case HeaderValue:
+                pos = scan::text(pos, end);
+                if (pos == end)
+                {
+                    begin = end;
+                    break;
+                }
+
+                begin = pos + 1;
+                if (!emit(handler, mark, pos - mark))
+                    return ParsingError;
+
+                if (*pos == '\r')
+                {
+                    switch (header)
+                    {
+                    case HeaderConnection:
+                        if (!connectionSeen)
+                            connectionKeepAlive = value.equals("Keep-Alive");
+
+                        connectionSeen = true;
+                        break;
+                    case HeaderContentLength:
+                    {
+                        if (!bodyAllowed)
+                            break;
+
+                        // RFC 9112 6.3: differing lengths leave the end of the message unknown.
+                        uint64_t length = 0;
+                        if (!value.decimal(length) || (contentLengthSeen && length != contentSize))
+                            return ParsingError;
+
+                        contentSize       = length;
+                        contentLengthSeen = true;
+                        if (contentSize > config.maxBodySize)
+                            return tooLarge(BodyTooLarge);
+                        break;
+                    }
+                    case HeaderTransferEncoding:
+                        if (!bodyAllowed)
+                            break;
+
+                        // Chunked must be the final coding, and applied only once.
+                        if (chunked)
+                            return ParsingError;
+
+                        transferEncodingSeen = true;
+                        chunked              = value.trimmedEquals("chunked");
+                        break;
+                    default:
+                        break;
+                    }
+                    state = ExpectingNewline_2;
+                }
+                else
+                {
+                    return ParsingError;
+                }
+                break;
+            case ExpectingNewline_2:
+                if (input == '\n')
+                {
+                    if (!countHeaderBytes(2))
+                        return ParsingError;
+
+                    state = HeaderLineStart;
+                }
+                else
+                {
+                    return ParsingError;
+                }
+                break;
+            case ExpectingNewline_3:
+            {
+                if (input != '\n')
+                    return ParsingError;
+
+                // RFC 9112 6.3: a request with a final coding other than chunked has no knowable
+                // length. A response to it goes on until the connection closes, as does one
+                // without Content-Length.
+                if (transferEncodingSeen && !chunked && !Derived::closeDelimited)
+                    return ParsingError;
+
+                bool keepAlive  = false;
+                bool untilClose = Derived::closeDelimited && bodyAllowed && !chunked
+                                  && (transferEncodingSeen || !contentLengthSeen);
+
+                // Transfer-Encoding overrides Content-Length, but the peer may have framed the
+                // message by the other one: do not read anything more from this connection.
+                if (untilClose || (transferEncodingSeen && contentLengthSeen))
+                    keepAlive = false;
+                else if (connectionSeen)
+                    keepAlive = connectionKeepAlive;
+                else if (versionMajor > 1 || (versionMajor == 1 && versionMinor == 1))
+                    keepAlive = true;
+
+                if (!handler.onHeadersComplete(keepAlive))
+                    return ParsingError;
+
+                if (chunked)
+                {
+                    state       = ChunkSizeStart;
+                    bodyFraming = ChunkedBody;
+                }
+                else if (untilClose)
+                {
+                    state       = BodyUntilClose;
+                    bodyFraming = CloseDelimitedBody;
+                }
+                else if (contentSize == 0)
+                {
+                    if (!handler.onMessageComplete())
+                        return ParsingError;
+
+                    return ParsingCompleted;
+                }
+                else
+                {
+                    state       = Post;
+                    bodyFraming = ContentLengthBody;
+                    bodyLength  = contentSize;
+                }
+
+                if (headersOnly)
+                    return ParsingHeadersCompleted;
+                break;
+            }
+            case Post:
+            {
+                // Hand over as much of the body as this buffer holds in one step.
+                size_t n = static_cast<size_t>(std::min<uint64_t>(contentSize, end - pos));
+                begin    = pos + n;
+                contentSize -= n;
+
+                if (!handler.onBody(pos, n))
+                    return ParsingError;
+
+                if (contentSize == 0)
+                {
+                    if (!handler.onMessageComplete())
+                        return ParsingError;
+
+                    return ParsingCompleted;
+                }
+                break;
+            }
+            case BodyUntilClose:
+            {
+                size_t n = end - pos;
+                begin    = end;
+
+                if (n > config.maxBodySize - bodySize)
+                    return tooLarge(BodyTooLarge);
+
+                bodySize += n;
+                if (!handler.onBody(pos, n))
+                    return ParsingError;
+                break;
+            }
+            case ChunkSizeStart:
+                if (!isHexDigit(input))
+                    return ParsingError;
+
+                chunkSize = hexValue(input);
+                state     = ChunkSize;
+                break;
+            case ChunkSize:
+                if (isHexDigit(input))
+                {
+                    // One more digit must not push the size past 64 bits.
+                    if (chunkSize > UINT64_MAX >> 4)
+                        return ParsingError;
+
+                    chunkSize = chunkSize * 16 + hexValue(input);
+                }
+                else if (input == ';')
+                {
+                    state = ChunkExtensionName;
+                }
+                else if (input == '\r')
+                {
+                    state = ChunkSizeNewLine;
+                }
+                else
+                {
+                    return ParsingError;
+                }
+                break;
+            case ChunkExtensionName:
+                if (isToken(input) || input == ' ')
+                {
+                    // skip
+                }
+                else if (input == '=')
+                {
+                    state = ChunkExtensionValue;
+                }
+                else if (input == '\r')
+                {
+                    state = ChunkSizeNewLine;
+                }
+                else
+                {
+                    return ParsingError;
+                }
+                break;
+            case ChunkExtensionValue:
+                if (isToken(input) || input == ' ')
+                {
+                    // skip
+                }
+                else if (input == '\r')
+                {
+                    state = ChunkSizeNewLine;
+                }
+                else
+                {
+                    return ParsingError;
+                }
+                break;
+            case ChunkSizeNewLine:
+                if (input == '\n')
+                {
+                    if (chunkSize > config.maxBodySize - bodySize)
+                        return tooLarge(BodyTooLarge);
+
+                    bodySize += chunkSize;
+                    if (chunkSize == 0)
+                        state = ChunkSizeNewLine_2;
+                    else
+                        state = ChunkData;
+                }
+                else
+                {
+                    return ParsingError;
+                }
+                break;
+            case ChunkSizeNewLine_2:
+                if (input == '\r')
+                {
+                    state = ChunkSizeNewLine_3;
+                }
+                else if (isToken(input))
+                {
+                    state = ChunkTrailerName;
+                }
+                else
+                {
+                    return ParsingError;
+                }
+                break;
+            case ChunkSizeNewLine_3:
+                if (input == '\n')
+                {
+                    if (!handler.onMessageComplete())
+                        return ParsingError;
+
+                    return ParsingCompleted;
+                }
+                else
+                {
+                    return ParsingError;
+                }
+                break;
+            case ChunkTrailerName:
+                if (isToken(input))
+                {
+                    // skip
+                }
+                else if (input == ':')
+                {
+                    state = ChunkTrailerValue;
+                }
+                else
+                {
+                    return ParsingError;
+                }
+                break;
+            case ChunkTrailerValue:
+                if (isText(input))
+                {
+                    // skip
+                }
+                else if (input == '\r')
+                {
+                    state = ChunkSizeNewLine;
+                }
+                else
+                {
+                    return ParsingError;
+                }
+                break;
+            case ChunkData:
+            {
+                size_t n = static_cast<size_t>(std::min<uint64_t>(chunkSize, end - pos));
+                begin    = pos + n;
+                chunkSize -= n;
+
+                if (!handler.onBody(pos, n))
+                    return ParsingError;
+
+                if (chunkSize == 0)
+                {
+                    state = ChunkDataNewLine_1;
+                }
+                break;
+            }
+            case ChunkDataNewLine_1:
+                if (input == '\r')
+                {
+                    state = ChunkDataNewLine_2;
+                }
+                else
+                {
+                    return ParsingError;
+                }
+                break;
+            case ChunkDataNewLine_2:
+                if (input == '\n')
+                {
+                    state = ChunkSizeStart;
+                }
+                else
+                {
+                    return ParsingError;
+                }
+                break;
+            default:
+                return ParsingError;
+            }
+        }
+
+        if (!emit(handler, mark, end - mark))
+            return ParsingError;
+
+        return ParsingIncompleted;
+    }
+
+    // The current state of the parser.
+    enum State
+    {
+        StartLine,
+        StartLineNewLine,
+
+        HeaderLineStart,
+        HeaderLws,
+        HeaderName,
+        SpaceBeforeHeaderValue,
+        HeaderValue,
+        ExpectingNewline_2,
+        ExpectingNewline_3,
+
+        Post,
+        BodyUntilClose,
+        ChunkSizeStart,
+        ChunkSize,
+        ChunkExtensionName,
+        ChunkExtensionValue,
+        ChunkSizeNewLine,
+        ChunkSizeNewLine_2,
+        ChunkSizeNewLine_3,
+        ChunkTrailerName,
+        ChunkTrailerValue,
+
+        ChunkDataNewLine_1,
+        ChunkDataNewLine_2,
+        ChunkData,
+    } state;
+
+    // The first bytes of a token, enough to recognize the methods and headers the parser itself
+    // has to understand. Longer tokens never compare equal.
+    class TokenPrefix
+    {
+    public:
+        TokenPrefix() : size(0), elementEnded(false) {}
+
+        void clear()
+        {
+            size         = 0;
+            elementEnded = false;
+        }
+
+        void append(const char* p, size_t n)
+        {
+            if (size < sizeof(data))
+                memcpy(data + size, p, std::min(n, sizeof(data) - size));
+
+            size += n;
+        }
+
+        // Case-insensitive comparison with a literal.
+        bool equals(const char* literal) const
+        {
+            return size == strlen(literal) && size <= sizeof(data) && strncasecmp(data, literal, size) == 0;
+        }
+
+        // Append the next bytes of a comma-separated list, keeping only its last non-empty
+        // element. The element may arrive split over any number of calls.
+        void appendListElement(const char* p, size_t n)
+        {
+            for (const char* end = p + n; p != end; ++p)
+            {
+                if (*p == ',')
+                {
+                    elementEnded = true;
+                }
+                else if (!elementEnded || (*p != ' ' && *p != '\t'))
+                {
+                    if (elementEnded)
+                        clear();
+                    append(p, 1);
+                }
+            }
+        }
+
+        // Case-insensitive comparison with a literal, ignoring whitespace around the token.
+        bool trimmedEquals(const char* literal) const
+        {
+            if (size > sizeof(data))
+                return false;
+
+            size_t i = 0, n = size;
+
+            while (i < n && (data[i] == ' ' || data[i] == '\t'))
+                ++i;
+            while (n > i && (data[n - 1] == ' ' || data[n - 1] == '\t'))
+                --n;
+
+            return n - i == strlen(literal) && strncasecmp(data + i, literal, n - i) == 0;
+        }
+
+        // Well-known ID of the token, names longer than the prefix are never well-known.
+        HeaderId headerId() const { return size <= sizeof(data) ? httpparser::headerId(data, size) : HeaderUnknown; }
+
+        Method methodId() const { return size <= sizeof(data) ? httpparser::methodId(data, size) : MethodUnknown; }
+
+        // Parse the token as a decimal number between optional whitespace. False if there is
+        // anything else in it or the number does not fit into 64 bits.
+        bool decimal(uint64_t& result) const
+        {
+            if (size > sizeof(data))
+                return false;
+
+            size_t i = 0, n = size;
+
+            while (i < n && (data[i] == ' ' || data[i] == '\t'))
+                ++i;
+            while (n > i && (data[n - 1] == ' ' || data[n - 1] == '\t'))
+                --n;
+
+            if (i == n)
+                return false;
+
+            for (result = 0; i < n; ++i)
+            {
+                unsigned int digit = data[i] - '0';
+
+                if (!isDigit(data[i]) || result > (UINT64_MAX - digit) / 10)
+                    return false;
+
+                result = result * 10 + digit;
+            }
+
+            return true;
+        }
+
+    private:
+        char data[32];
+        size_t size;
+        // A comma ended the list element in `data`, the next non-blank byte starts another.
+        bool elementEnded;
+    };
+
+    // 64 bits even where size_t is not, so that bodies over 4 GB parse everywhere.
+    uint64_t contentSize;
+    uint64_t chunkSize;
+    bool chunked;
+    bool contentLengthSeen;
+    bool transferEncodingSeen;
+
+    int versionMajor;
+    int versionMinor;
+    size_t headerCount;
+    // Bytes of the start line and the header lines so far, see ParserLimits::maxHeaderBytes.
+    size_t headerBytes;
+    // Sum of the chunk sizes, or the size of a body read until close, so far.
+    uint64_t bodySize;
+    // Well-known ID of the name of the header line being parsed.
+    HeaderId header;
+    // Whether Content-Length and Transfer-Encoding frame a body for this message.
+    bool bodyAllowed;
+    bool connectionSeen;
+    bool connectionKeepAlive;
+    TokenPrefix token;
+    TokenPrefix value;
+    ParseError errorCode;
+    bool headersOnly;
+    BodyFraming bodyFraming;
+    uint64_t bodyLength;
+    ParserLimits config;
+};
+
+}  // namespace httpparser
+
+#endif  // HTTPPARSER_HTTPPARSERBASE_H
@@ -6,560 +6,567 @@
 #ifndef HTTPPARSER_REQUESTPARSER_H
 #define HTTPPARSER_REQUESTPARSER_H
 
-#include <algorithm>
-
-#include <stdlib.h>
-#include <string.h>
-
+#include "arenarequest.h"
+#include "httpparserbase.h"
 #include "request.h"
+#include "requestview.h"
+#include "staticrequest.h"
 
 namespace httpparser
 {
 
-class HttpRequestParser
+// The handler HttpRequestParser uses to fill a Request or a RequestView.
+template <typename Message>
+class RequestBuilder : public HttpHandler
+{
+public:
+    explicit RequestBuilder(Message& req) : req(req) {}
+
+    bool onMethod(const char* data, size_t size)
+    {
+        append(req.method, data, size);
+        return true;
+    }
+
+    bool onMethodId(Method method)
+    {
+        req.methodId = method;
+        return true;
+    }
+
+    bool onUri(const char* data, size_t size)
+    {
+        append(req.uri, data, size);
+        return true;
+    }
+
+    bool onVersion(int major, int minor)
+    {
+        req.versionMajor = major;
+        req.versionMinor = minor;
+        return true;
+    }
+
+    bool onHeaderBegin()
+    {
+        typename Message::HeaderItem& h = req.addHeader();
+        reserve(h.name, 16);
+        reserve(h.value, 16);
+        return true;
+    }
+
+    bool onHeaderField(const char* data, size_t size)
+    {
+        append(req.headers.back().name, data, size);
+        return true;
+    }
+
+    bool onHeaderId(HeaderId id)
+    {
+        req.headers.back().id = id;
+        return true;
+    }
+
+    bool onHeaderValue(const char* data, size_t size)
+    {
+        append(req.headers.back().value, data, size);
+        return true;
+    }
+
+    bool onHeadersComplete(bool keepAlive)
+    {
+        req.keepAlive = keepAlive;
+        req.reindex();
+        return true;
+    }
+
+    bool onBody(const char* data, size_t size)
+    {
+        append(req.content, data, size);
+        return true;
+    }
+
+protected:
+    Message& req;
+};
+
+// Copies the text of the message into the arena of an ArenaRequest.
+class ArenaRequestBuilder : public RequestBuilder<ArenaRequest>
 {
 public:
-    HttpRequestParser() : state(RequestMethodStart), contentSize(0), chunkSize(0), chunked(false) {}
+    explicit ArenaRequestBuilder(ArenaRequest& req) : RequestBuilder<ArenaRequest>(req) {}
+
+    bool onMethod(const char* data, size_t size)
+    {
+        req.arena.append(req.method, data, size);
+        return true;
+    }
+
+    bool onUri(const char* data, size_t size)
+    {
+        req.arena.append(req.uri, data, size);
+        return true;
+    }
+
+    bool onHeaderField(const char* data, size_t size)
+    {
+        req.arena.append(req.headers.back().name, data, size);
+        return true;
+    }
+
+    bool onHeaderValue(const char* data, size_t size)
+    {
+        req.arena.append(req.headers.back().value, data, size);
+        return true;
+    }
 
-    enum ParseResult
+    bool onBody(const char* data, size_t size)
     {
-        ParsingCompleted,
-        ParsingIncompleted,
-        ParsingError
-    };
+        req.arena.append(req.content, data, size);
+        return true;
+    }
+};
 
-    ParseResult parse(Request& req, const char* begin, const char* end) { return consume(req, begin, end); }
+// Fills a StaticRequest, failing instead of growing once its capacity is used up.
+template <typename Message>
+class StaticRequestBuilder : public HttpHandler
+{
+public:
+    explicit StaticRequestBuilder(Message& req) : req(req), full(false) {}
+
+    bool onMethod(const char* data, size_t size) { return store(req.method, data, size); }
+
+    bool onMethodId(Method method)
+    {
+        req.methodId = method;
+        return true;
+    }
+
+    bool onUri(const char* data, size_t size) { return store(req.uri, data, size); }
+
+    bool onVersion(int major, int minor)
+    {
+        req.versionMajor = major;
+        req.versionMinor = minor;
+        return true;
+    }
+
+    bool onHeaderBegin() { return fits(req.headers.push_back(typename Message::HeaderItem())); }
+
+    bool onHeaderField(const char* data, size_t size) { return store(req.headers.back().name, data, size); }
+
+    bool onHeaderId(HeaderId id)
+    {
+        req.headers.back().id = id;
+        return true;
+    }
+
+    bool onHeaderValue(const char* data, size_t size) { return store(req.headers.back().value, data, size); }
+
+    bool onHeadersComplete(bool keepAlive)
+    {
+        req.keepAlive = keepAlive;
+        return true;
+    }
+
+    bool onBody(const char* data, size_t size) { return store(req.content, data, size); }
+
+    // Whether parsing stopped because the message ran out of capacity.
+    bool overflowed() const { return full; }
 
 private:
-    static bool checkIfConnection(const Request::HeaderItem& item)
+    bool store(Slice& s, const char* data, size_t size) { return fits(req.storage.append(s, data, size)); }
+
+    bool fits(bool stored)
     {
-        return strcasecmp(item.name.c_str(), "Connection") == 0;
+        full = !stored;
+        return stored;
     }
 
-    ParseResult consume(Request& req, const char* begin, const char* end)
+    Message& req;
+    bool full;
+};
+
+// Fills the start line and the headers of a Request but hands the body over to `BodySink`, any
+// callable as bool(const char* data, size_t size), instead of accumulating it in content.
+template <typename Message, typename BodySink>
+class StreamingRequestBuilder : public RequestBuilder<Message>
+{
+public:
+    StreamingRequestBuilder(Message& req, BodySink& body) : RequestBuilder<Message>(req), body(body) {}
+
+    bool onBody(const char* data, size_t size) { return body(data, size); }
+
+private:
+    BodySink& body;
+};
+
+class HttpRequestParser : public HttpParserBase<HttpRequestParser>
+{
+public:
+    explicit HttpRequestParser(const ParserLimits& limits = ParserLimits()) : HttpParserBase<HttpRequestParser>(limits)
     {
-        while (begin != end)
-        {
-            char input = *begin++;
+        resetStartLine();
+    }
 
-            switch (state)
-            {
-            case RequestMethodStart:
-                if (!isChar(input) || isControl(input) || isSpecial(input))
-                {
-                    return ParsingError;
-                }
-                else
-                {
-                    state = RequestMethod;
-                    req.method.push_back(input);
-                }
-                break;
-            case RequestMethod:
-                if (input == ' ')
-                {
-                    state = RequestUriStart;
-                }
-                else if (!isChar(input) || isControl(input) || isSpecial(input))
-                {
-                    return ParsingError;
-                }
-                else
-                {
-                    req.method.push_back(input);
-                }
-                break;
-            case RequestUriStart:
-                if (isControl(input))
-                {
-                    return ParsingError;
-                }
-                else
-                {
-                    state = RequestUri;
-                    req.uri.push_back(input);
-                }
-                break;
-            case RequestUri:
-                if (input == ' ')
-                {
-                    state = RequestHttpVersion_h;
-                }
-                else if (input == '\r')
-                {
-                    req.versionMajor = 0;
-                    req.versionMinor = 9;
+    using HttpParserBase<HttpRequestParser>::parse;
 
-                    return ParsingCompleted;
-                }
-                else if (isControl(input))
-                {
-                    return ParsingError;
-                }
-                else
-                {
-                    req.uri.push_back(input);
-                }
-                break;
-            case RequestHttpVersion_h:
-                if (input == 'H')
-                {
-                    state = RequestHttpVersion_ht;
-                }
-                else
-                {
-                    return ParsingError;
-                }
-                break;
-            case RequestHttpVersion_ht:
-                if (input == 'T')
-                {
-                    state = RequestHttpVersion_htt;
-                }
-                else
-                {
-                    return ParsingError;
-                }
-                break;
-            case RequestHttpVersion_htt:
-                if (input == 'T')
-                {
-                    state = RequestHttpVersion_http;
-                }
-                else
-                {
-                    return ParsingError;
-                }
-                break;
-            case RequestHttpVersion_http:
-                if (input == 'P')
-                {
-                    state = RequestHttpVersion_slash;
-                }
-                else
-                {
-                    return ParsingError;
-                }
-                break;
-            case RequestHttpVersion_slash:
-                if (input == '/')
-                {
-                    req.versionMajor = 0;
-                    req.versionMinor = 0;
-                    state            = RequestHttpVersion_majorStart;
-                }
-                else
-                {
-                    return ParsingError;
-                }
-                break;
-            case RequestHttpVersion_majorStart:
-                if (isDigit(input))
-                {
-                    req.versionMajor = input - '0';
-                    state            = RequestHttpVersion_major;
-                }
-                else
-                {
-                    return ParsingError;
-                }
-                break;
-            case RequestHttpVersion_major:
-                if (input == '.')
-                {
-                    state = RequestHttpVersion_minorStart;
-                }
-                else if (isDigit(input))
-                {
-                    req.versionMajor = req.versionMajor * 10 + input - '0';
-                }
-                else
-                {
-                    return ParsingError;
-                }
-                break;
-            case RequestHttpVersion_minorStart:
-                if (isDigit(input))
-                {
-                    req.versionMinor = input - '0';
-                    state            = RequestHttpVersion_minor;
-                }
-                else
-                {
-                    return ParsingError;
-                }
-                break;
-            case RequestHttpVersion_minor:
-                if (input == '\r')
-                {
-                    state = ResponseHttpVersion_newLine;
-                }
-                else if (isDigit(input))
-                {
-                    req.versionMinor = req.versionMinor * 10 + input - '0';
-                }
-                else
-                {
-                    return ParsingError;
-                }
-                break;
-            case ResponseHttpVersion_newLine:
-                if (input == '\n')
-                {
-                    state = HeaderLineStart;
-                }
-                else
-                {
-                    return ParsingError;
-                }
-                break;
-            case HeaderLineStart:
-                if (input == '\r')
-                {
-                    state = ExpectingNewline_3;
-                }
-                else if (!req.headers.empty() && (input == ' ' || input == '\t'))
-                {
-                    state = HeaderLws;
-                }
-                else if (!isChar(input) || isControl(input) || isSpecial(input))
-                {
-                    return ParsingError;
-                }
-                else
-                {
-                    req.headers.push_back(Request::HeaderItem());
-                    req.headers.back().name.reserve(16);
-                    req.headers.back().value.reserve(16);
-                    req.headers.back().name.push_back(input);
-                    state = HeaderName;
-                }
-                break;
-            case HeaderLws:
-                if (input == '\r')
-                {
-                    state = ExpectingNewline_2;
-                }
-                else if (input == ' ' || input == '\t')
-                {
-                }
-                else if (isControl(input))
-                {
-                    return ParsingError;
-                }
-                else
-                {
-                    state = HeaderValue;
-                    req.headers.back().value.push_back(input);
-                }
-                break;
-            case HeaderName:
-                if (input == ':')
-                {
-                    state = SpaceBeforeHeaderValue;
-                }
-                else if (!isChar(input) || isControl(input) || isSpecial(input))
-                {
-                    return ParsingError;
-                }
-                else
-                {
-                    req.headers.back().name.push_back(input);
-                }
-                break;
-            case SpaceBeforeHeaderValue:
-                if (input == ' ')
-                {
-                    state = HeaderValue;
-                }
-                else
-                {
-                    return ParsingError;
-                }
-                break;
-            case HeaderValue:
-                if (input == '\r')
-                {
-                    if (req.method == "POST" || req.method == "PUT")
-                    {
-                        Request::HeaderItem& h = req.headers.back();
-
-                        if (strcasecmp(h.name.c_str(), "Content-Length") == 0)
-                        {
-                            contentSize = atoi(h.value.c_str());
-                            req.content.reserve(contentSize);
-                        }
-                        else if (strcasecmp(h.name.c_str(), "Transfer-Encoding") == 0)
-                        {
-                            if (strcasecmp(h.value.c_str(), "chunked") == 0)
-                                chunked = true;
-                        }
-                    }
-                    state = ExpectingNewline_2;
-                }
-                else if (isControl(input))
-                {
-                    return ParsingError;
-                }
-                else
-                {
-                    req.headers.back().value.push_back(input);
-                }
-                break;
-            case ExpectingNewline_2:
-                if (input == '\n')
-                {
-                    state = HeaderLineStart;
-                }
-                else
-                {
-                    return ParsingError;
-                }
-                break;
-            case ExpectingNewline_3:
-            {
-                std::vector<Request::HeaderItem>::iterator it =
-                    std::find_if(req.headers.begin(), req.headers.end(), checkIfConnection);
+    template <typename Alloc>
+    ParseResult parse(BasicRequest<Alloc>& req, const char* begin, const char* end)
+    {
+        RequestBuilder<BasicRequest<Alloc> > builder(req);
+        return consume(builder, begin, end);
+    }
 
-                if (it != req.headers.end())
-                {
-                    if (strcasecmp(it->value.c_str(), "Keep-Alive") == 0)
-                    {
-                        req.keepAlive = true;
-                    }
-                    else  // == Close
-                    {
-                        req.keepAlive = false;
-                    }
-                }
-                else
-                {
-                    if (req.versionMajor > 1 || (req.versionMajor == 1 && req.versionMinor == 1))
-                        req.keepAlive = true;
-                }
+    // Zero-copy parsing, see requestview.h for the buffer lifetime contract.
+    ParseResult parse(RequestView& req, const char* begin, const char* end)
+    {
+        RequestBuilder<RequestView> builder(req);
+        return consume(builder, begin, end);
+    }
 
-                if (chunked)
-                {
-                    state = ChunkSize;
-                }
-                else if (contentSize == 0)
+    // Copy the message into the arena of `req`, see arenarequest.h.
+    ParseResult parse(ArenaRequest& req, const char* begin, const char* end)
+    {
+        ArenaRequestBuilder builder(req);
+        return consume(builder, begin, end);
+    }
+
+    // Parse into inline storage only, ParsingTooLarge if the message does not fit.
+    template <size_t MaxHeaders, size_t MaxBytes>
+    ParseResult parse(StaticRequest<MaxHeaders, MaxBytes>& req, const char* begin, const char* end)
+    {
+        StaticRequestBuilder<StaticRequest<MaxHeaders, MaxBytes> > builder(req);
+        ParseResult res = consume(builder, begin, end);
+        return builder.overflowed() ? tooLarge(CapacityExceeded) : res;
+    }
+
+    // Stream the body to `body` as it arrives instead of storing it in req.content, so memory
+    // does not grow with the body size. Returning false from `body` stops parsing with ParsingError.
+    template <typename Alloc, typename BodySink>
+    ParseResult parse(BasicRequest<Alloc>& req, BodySink& body, const char* begin, const char* end)
+    {
+        StreamingRequestBuilder<BasicRequest<Alloc>, BodySink> builder(req, body);
+        return consume(builder, begin, end);
+    }
+
+    // Same as above, but also report in `consumed` how many bytes of [begin, end) were used. Once
+    // the message is completed, the rest of the buffer is the start of the next pipelined message.
+    template <typename Alloc>
+    ParseResult parse(BasicRequest<Alloc>& req, const char* begin, const char* end, size_t& consumed)
+    {
+        RequestBuilder<BasicRequest<Alloc> > builder(req);
+        return parse(builder, begin, end, consumed);
+    }
+
+    ParseResult parse(RequestView& req, const char* begin, const char* end, size_t& consumed)
+    {
+        RequestBuilder<RequestView> builder(req);
+        return parse(builder, begin, end, consumed);
+    }
+
+    ParseResult parse(ArenaRequest& req, const char* begin, const char* end, size_t& consumed)
+    {
+        ArenaRequestBuilder builder(req);
+        return parse(builder, begin, end, consumed);
+    }
+
+    template <size_t MaxHeaders, size_t MaxBytes>
+    ParseResult parse(StaticRequest<MaxHeaders, MaxBytes>& req, const char* begin, const char* end, size_t& consumed)
+    {
+        StaticRequestBuilder<StaticRequest<MaxHeaders, MaxBytes> > builder(req);
+        ParseResult res = parse(builder, begin, end, consumed);
+        return builder.overflowed() ? tooLarge(CapacityExceeded) : res;
+    }
+
+    template <typename Alloc, typename BodySink>
+    ParseResult parse(BasicRequest<Alloc>& req, BodySink& body, const char* begin, const char* end, size_t& consumed)
+    {
+        StreamingRequestBuilder<BasicRequest<Alloc>, BodySink> builder(req, body);
+        return parse(builder, begin, end, consumed);
+    }
+
+private:
+    friend class HttpParserBase<HttpRequestParser>;
+
+    template <typename Handler>
+    ParseResult consumeStartLine(Handler& handler, const char* pos, const char*& begin, const char* end,
+                                 const char*& mark)
+    {
+        char input = *pos;
+
+        switch (startLineState)
+        {
+        case RequestMethodStart:
+            // Take a well-known method with its space in one step when the buffer holds a word.
+            if (end - pos >= 8)
+            {
+                Method method = MethodUnknown;
+                size_t n      = knownMethod(pos, method);
+
+                if (n != 0)
                 {
-                    if (input == '\n')
-                        return ParsingCompleted;
-                    else
+                    token.clear();
+                    startLineState = RequestMethod;
+                    if (!emit(handler, pos, n - 1) || !handler.onMethodId(method))
                         return ParsingError;
+
+                    startLineState = RequestUriStart;
+                    begin          = pos + n;
+                    break;
                 }
-                else
-                {
-                    state = Post;
-                }
-                break;
             }
-            case Post:
-                --contentSize;
-                req.content.push_back(input);
 
-                if (contentSize == 0)
-                {
-                    return ParsingCompleted;
-                }
-                break;
-            case ChunkSize:
-                if (isalnum(input))
-                {
-                    chunkSizeStr.push_back(input);
-                }
-                else if (input == ';')
-                {
-                    state = ChunkExtensionName;
-                }
-                else if (input == '\r')
-                {
-                    state = ChunkSizeNewLine;
-                }
-                else
-                {
-                    return ParsingError;
-                }
-                break;
-            case ChunkExtensionName:
-                if (isalnum(input) || input == ' ')
-                {
-                    // skip
-                }
-                else if (input == '=')
-                {
-                    state = ChunkExtensionValue;
-                }
-                else if (input == '\r')
-                {
-                    state = ChunkSizeNewLine;
-                }
-                else
-                {
-                    return ParsingError;
-                }
-                break;
-            case ChunkExtensionValue:
-                if (isalnum(input) || input == ' ')
-                {
-                    // skip
-                }
-                else if (input == '\r')
-                {
-                    state = ChunkSizeNewLine;
-                }
-                else
-                {
-                    return ParsingError;
-                }
-                break;
-            case ChunkSizeNewLine:
-                if (input == '\n')
-                {
-                    chunkSize = strtol(chunkSizeStr.c_str(), NULL, 16);
-                    chunkSizeStr.clear();
-                    req.content.reserve(req.content.size() + chunkSize);
-
-                    if (chunkSize == 0)
-                        state = ChunkSizeNewLine_2;
-                    else
-                        state = ChunkData;
-                }
-                else
-                {
-                    return ParsingError;
-                }
-                break;
-            case ChunkSizeNewLine_2:
-                if (input == '\r')
-                {
-                    state = ChunkSizeNewLine_3;
-                }
-                else if (isalpha(input))
-                {
-                    state = ChunkTrailerName;
-                }
-                else
-                {
-                    return ParsingError;
-                }
-                break;
-            case ChunkSizeNewLine_3:
-                if (input == '\n')
-                {
-                    return ParsingCompleted;
-                }
-                else
-                {
+            if (!isToken(input))
+            {
+                return ParsingError;
+            }
+            else
+            {
+                startLineState = RequestMethod;
+                mark           = pos;
+                token.clear();
+            }
+            break;
+        case RequestMethod:
+            if (input == ' ')
+            {
+                if (!emit(handler, mark, pos - mark) || !handler.onMethodId(token.methodId()))
                     return ParsingError;
-                }
-                break;
-            case ChunkTrailerName:
-                if (isalnum(input))
-                {
-                    // skip
-                }
-                else if (input == ':')
-                {
-                    state = ChunkTrailerValue;
-                }
-                else
-                {
+
+                startLineState = RequestUriStart;
+            }
+            else if (!isToken(input))
+            {
+                // The bytes so far count against the limits first, as in a split buffer.
+                emit(handler, mark, pos - mark);
+                return ParsingError;
+            }
+            break;
+        case RequestUriStart:
+            if (!isText(input))
+            {
+                return ParsingError;
+            }
+            else
+            {
+                startLineState = RequestUri;
+                mark           = pos;
+            }
+            break;
+        case RequestUri:
+            if (input == ' ')
+            {
+                if (!emit(handler, mark, pos - mark))
                     return ParsingError;
-                }
-                break;
-            case ChunkTrailerValue:
-                if (isalnum(input) || input == ' ')
-                {
-                    // skip
-                }
-                else if (input == '\r')
-                {
-                    state = ChunkSizeNewLine;
-                }
-                else
-                {
+
+                startLineState = RequestHttpVersion_h;
+            }
+            else if (input == '\r')
+            {
+                if (!emit(handler, mark, pos - mark) || !handler.onVersion(0, 9)
+                    || !handler.onMessageComplete())
                     return ParsingError;
-                }
-                break;
-            case ChunkData:
-                req.content.push_back(input);
 
-                if (--chunkSize == 0)
-                {
-                    state = ChunkDataNewLine_1;
-                }
-                break;
-            case ChunkDataNewLine_1:
-                if (input == '\r')
-                {
-                    state = ChunkDataNewLine_2;
-                }
-                else
-                {
+                return ParsingCompleted;
+            }
+            else if (!isText(input))
+            {
+                emit(handler, mark, pos - mark);
+                return ParsingError;
+            }
+            break;
+        case RequestHttpVersion_h:
+            // "HTTP/1.1\r\n" at once, the states below handle anything else and split buffers.
+            if (end - pos >= 10 && pos[8] == '\r' && pos[9] == '\n' && matchVersion(pos))
+            {
+                if (!handler.onVersion(versionMajor, versionMinor))
                     return ParsingError;
-                }
+
+                state = HeaderLineStart;
+                begin = pos + 10;
                 break;
-            case ChunkDataNewLine_2:
-                if (input == '\n')
-                {
-                    state = ChunkSize;
-                }
-                else
-                {
+            }
+
+            if (input == 'H')
+            {
+                startLineState = RequestHttpVersion_ht;
+            }
+            else
+            {
+                return ParsingError;
+            }
+            break;
+        case RequestHttpVersion_ht:
+            if (input == 'T')
+            {
+                startLineState = RequestHttpVersion_htt;
+            }
+            else
+            {
+                return ParsingError;
+            }
+            break;
+        case RequestHttpVersion_htt:
+            if (input == 'T')
+            {
+                startLineState = RequestHttpVersion_http;
+            }
+            else
+            {
+                return ParsingError;
+            }
+            break;
+        case RequestHttpVersion_http:
+            if (input == 'P')
+            {
+                startLineState = RequestHttpVersion_slash;
+            }
+            else
+            {
+                return ParsingError;
+            }
+            break;
+        case RequestHttpVersion_slash:
+            if (input == '/')
+            {
+                versionMajor   = 0;
+                versionMinor   = 0;
+                startLineState = RequestHttpVersion_majorStart;
+            }
+            else
+            {
+                return ParsingError;
+            }
+            break;
+        case RequestHttpVersion_majorStart:
+            if (isDigit(input))
+            {
+                versionMajor   = input - '0';
+                startLineState = RequestHttpVersion_major;
+            }
+            else
+            {
+                return ParsingError;
+            }
+            break;
+        case RequestHttpVersion_major:
+            if (input == '.')
+            {
+                startLineState = RequestHttpVersion_minorStart;
+            }
+            else
+            {
+                return ParsingError;
+            }
+            break;
+        case RequestHttpVersion_minorStart:
+            if (isDigit(input))
+            {
+                versionMinor   = input - '0';
+                startLineState = RequestHttpVersion_minor;
+            }
+            else
+            {
+                return ParsingError;
+            }
+            break;
+        case RequestHttpVersion_minor:
+            if (input == '\r')
+            {
+                if (!handler.onVersion(versionMajor, versionMinor))
                     return ParsingError;
-                }
-                break;
-            default:
+
+                state = StartLineNewLine;
+            }
+            else
+            {
                 return ParsingError;
             }
+            break;
+        default:
+            return ParsingError;
         }
 
         return ParsingIncompleted;
     }
 
-    // Check if a byte is an HTTP character.
-    inline bool isChar(int c) { return c >= 0 && c <= 127; }
+    template <typename Handler>
+    bool emitStartLine(Handler& handler, const char* p, size_t n)
+    {
+        switch (startLineState)
+        {
+        case RequestMethod:
+            if (!countHeaderBytes(n))
+                return false;
 
-    // Check if a byte is an HTTP control character.
-    inline bool isControl(int c) { return (c >= 0 && c <= 31) || (c == 127); }
+            token.append(p, n);
+            return handler.onMethod(p, n);
+        case RequestUri:
+            // Fail with the limit that a byte at a time would reach first, so the error does not
+            // depend on how the input is split. Neither count is over its limit yet.
+            if (n > config.maxUriSize - uriSize && config.maxUriSize - uriSize <= config.maxHeaderBytes - headerBytes)
+                return fail(UriTooLong);
+            if (!countHeaderBytes(n))
+                return false;
 
-    // Check if a byte is defined as an HTTP special character.
-    inline bool isSpecial(int c)
+            uriSize += n;
+            return handler.onUri(p, n);
+        default:
+            return true;
+        }
+    }
+
+    void resetStartLine()
     {
-        switch (c)
+        startLineState = RequestMethodStart;
+        uriSize        = 0;
+    }
+
+    bool startLineStarted() const { return startLineState != RequestMethodStart; }
+
+    // Size of the well-known method and the space after it at `p`, which has at least 8 bytes,
+    // or 0. Each method is compared as one masked word.
+    static size_t knownMethod(const char* p, Method& method)
+    {
+        static const struct
         {
-        case '(':
-        case ')':
-        case '<':
-        case '>':
-        case '@':
-        case ',':
-        case ';':
-        case ':':
-        case '\\':
-        case '"':
-        case '/':
-        case '[':
-        case ']':
-        case '?':
-        case '=':
-        case '{':
-        case '}':
-        case ' ':
-        case '\t':
-            return true;
-        default:
-            return false;
+            char text[9];
+            size_t size;
+            Method id;
+        } methods[] = {
+            {"GET ", 4, MethodGet},
+            {"POST ", 5, MethodPost},
+            {"PUT ", 4, MethodPut},
+            {"HEAD ", 5, MethodHead},
+            {"DELETE ", 7, MethodDelete},
+            {"PATCH ", 6, MethodPatch},
+            {"OPTIONS ", 8, MethodOptions},
+            {"CONNECT ", 8, MethodConnect},
+            {"TRACE ", 6, MethodTrace},
+        };
+        // Eight bytes of ones followed by eight zero bytes: the word at `8 - n` masks n bytes.
+        static const char ones[16] = {'\xff', '\xff', '\xff', '\xff', '\xff', '\xff', '\xff', '\xff'};
+
+        uint64_t w = loadWord(p);
+
+        for (size_t i = 0; i < sizeof(methods) / sizeof(methods[0]); ++i)
+        {
+            if (((w ^ loadWord(methods[i].text)) & loadWord(ones + 8 - methods[i].size)) == 0)
+            {
+                method = methods[i].id;
+                return methods[i].size;
+            }
         }
+
+        return 0;
     }
 
-    // Check if a byte is a digit.
-    inline bool isDigit(int c) { return c >= '0' && c <= '9'; }
+    // A request without Content-Length or chunked encoding has no body.
+    static const bool closeDelimited = false;
 
-    // The current state of the parser.
-    enum State
+    // The state of the parser within the request line.
+    enum StartLineState
     {
         RequestMethodStart,
         RequestMethod,
@@ -574,49 +581,9 @@ private:
         RequestHttpVersion_major,
         RequestHttpVersion_minorStart,
         RequestHttpVersion_minor,
+    } startLineState;
 
-        ResponseStatusStart,
-        ResponseHttpVersion_ht,
-        ResponseHttpVersion_htt,
-        ResponseHttpVersion_http,
-        ResponseHttpVersion_slash,
-        ResponseHttpVersion_majorStart,
-        ResponseHttpVersion_major,
-        ResponseHttpVersion_minorStart,
-        ResponseHttpVersion_minor,
-        ResponseHttpVersion_spaceAfterVersion,
-        ResponseHttpVersion_statusCodeStart,
-        ResponseHttpVersion_spaceAfterStatusCode,
-        ResponseHttpVersion_statusTextStart,
-        ResponseHttpVersion_newLine,
-
-        HeaderLineStart,
-        HeaderLws,
-        HeaderName,
-        SpaceBeforeHeaderValue,
-        HeaderValue,
-        ExpectingNewline_2,
-        ExpectingNewline_3,
-
-        Post,
-        ChunkSize,
-        ChunkExtensionName,
-        ChunkExtensionValue,
-        ChunkSizeNewLine,
-        ChunkSizeNewLine_2,
-        ChunkSizeNewLine_3,
-        ChunkTrailerName,
-        ChunkTrailerValue,
-
-        ChunkDataNewLine_1,
-        ChunkDataNewLine_2,
-        ChunkData,
-    } state;
-
-    size_t contentSize;
-    std::string chunkSizeStr;
-    size_t chunkSize;
-    bool chunked;
+    size_t uriSize;
 };
 
 }  // namespace httpparser
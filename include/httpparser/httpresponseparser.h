@@ -6,559 +6,516 @@
 #ifndef HTTPPARSER_RESPONSEPARSER_H
 #define HTTPPARSER_RESPONSEPARSER_H
 
-#include <algorithm>
-
-#include <stdlib.h>
-#include <string.h>
-
+#include "arenaresponse.h"
+#include "httpparserbase.h"
 #include "response.h"
+#include "responseview.h"
+#include "staticresponse.h"
 
 namespace httpparser
 {
 
-class HttpResponseParser
+// The handler HttpResponseParser uses to fill a Response or a ResponseView.
+template <typename Message>
+class ResponseBuilder : public HttpHandler
 {
 public:
-    HttpResponseParser() : state(ResponseStatusStart), contentSize(0), chunkSize(0), chunked(false) {}
+    explicit ResponseBuilder(Message& resp) : resp(resp) {}
+
+    bool onVersion(int major, int minor)
+    {
+        resp.versionMajor = major;
+        resp.versionMinor = minor;
+        return true;
+    }
+
+    bool onStatusCode(unsigned int code)
+    {
+        resp.statusCode = code;
+        return true;
+    }
+
+    bool onStatus(const char* data, size_t size)
+    {
+        append(resp.status, data, size);
+        return true;
+    }
+
+    bool onHeaderBegin()
+    {
+        typename Message::HeaderItem& h = resp.addHeader();
+        reserve(h.name, 16);
+        reserve(h.value, 16);
+        return true;
+    }
+
+    bool onHeaderField(const char* data, size_t size)
+    {
+        append(resp.headers.back().name, data, size);
+        return true;
+    }
+
+    bool onHeaderId(HeaderId id)
+    {
+        resp.headers.back().id = id;
+        return true;
+    }
+
+    bool onHeaderValue(const char* data, size_t size)
+    {
+        append(resp.headers.back().value, data, size);
+        return true;
+    }
+
+    bool onHeadersComplete(bool keepAlive)
+    {
+        resp.keepAlive = keepAlive;
+        resp.reindex();
+        return true;
+    }
+
+    bool onBody(const char* data, size_t size)
+    {
+        append(resp.content, data, size);
+        return true;
+    }
+
+protected:
+    Message& resp;
+};
+
+// Copies the text of the message into the arena of an ArenaResponse.
+class ArenaResponseBuilder : public ResponseBuilder<ArenaResponse>
+{
+public:
+    explicit ArenaResponseBuilder(ArenaResponse& resp) : ResponseBuilder<ArenaResponse>(resp) {}
+
+    bool onStatus(const char* data, size_t size)
+    {
+        resp.arena.append(resp.status, data, size);
+        return true;
+    }
+
+    bool onHeaderField(const char* data, size_t size)
+    {
+        resp.arena.append(resp.headers.back().name, data, size);
+        return true;
+    }
+
+    bool onHeaderValue(const char* data, size_t size)
+    {
+        resp.arena.append(resp.headers.back().value, data, size);
+        return true;
+    }
+
+    bool onBody(const char* data, size_t size)
+    {
+        resp.arena.append(resp.content, data, size);
+        return true;
+    }
+};
+
+// Fills a StaticResponse, failing instead of growing once its capacity is used up.
+template <typename Message>
+class StaticResponseBuilder : public HttpHandler
+{
+public:
+    explicit StaticResponseBuilder(Message& resp) : resp(resp), full(false) {}
+
+    bool onVersion(int major, int minor)
+    {
+        resp.versionMajor = major;
+        resp.versionMinor = minor;
+        return true;
+    }
+
+    bool onStatusCode(unsigned int code)
+    {
+        resp.statusCode = code;
+        return true;
+    }
+
+    bool onStatus(const char* data, size_t size) { return store(resp.status, data, size); }
 
-    enum ParseResult
+    bool onHeaderBegin() { return fits(resp.headers.push_back(typename Message::HeaderItem())); }
+
+    bool onHeaderField(const char* data, size_t size) { return store(resp.headers.back().name, data, size); }
+
+    bool onHeaderId(HeaderId id)
+    {
+        resp.headers.back().id = id;
+        return true;
+    }
+
+    bool onHeaderValue(const char* data, size_t size) { return store(resp.headers.back().value, data, size); }
+
+    bool onHeadersComplete(bool keepAlive)
     {
-        ParsingCompleted,
-        ParsingIncompleted,
-        ParsingError
-    };
+        resp.keepAlive = keepAlive;
+        return true;
+    }
+
+    bool onBody(const char* data, size_t size) { return store(resp.content, data, size); }
 
-    ParseResult parse(Response& resp, const char* begin, const char* end) { return consume(resp, begin, end); }
+    // Whether parsing stopped because the message ran out of capacity.
+    bool overflowed() const { return full; }
 
 private:
-    static bool checkIfConnection(const Response::HeaderItem& item)
+    bool store(Slice& s, const char* data, size_t size) { return fits(resp.storage.append(s, data, size)); }
+
+    bool fits(bool stored)
     {
-        return strcasecmp(item.name.c_str(), "Connection") == 0;
+        full = !stored;
+        return stored;
     }
 
-    ParseResult consume(Response& resp, const char* begin, const char* end)
+    Message& resp;
+    bool full;
+};
+
+// Fills the start line and the headers of a Response but hands the body over to `BodySink`, any
+// callable as bool(const char* data, size_t size), instead of accumulating it in content.
+template <typename Message, typename BodySink>
+class StreamingResponseBuilder : public ResponseBuilder<Message>
+{
+public:
+    StreamingResponseBuilder(Message& resp, BodySink& body) : ResponseBuilder<Message>(resp), body(body) {}
+
+    bool onBody(const char* data, size_t size) { return body(data, size); }
+
+private:
+    BodySink& body;
+};
+
+class HttpResponseParser : public HttpParserBase<HttpResponseParser>
+{
+public:
+    explicit HttpResponseParser(const ParserLimits& limits = ParserLimits())
+        : HttpParserBase<HttpResponseParser>(limits), noBody(false), tunnel(false)
     {
-        while (begin != end)
-        {
-            char input = *begin++;
+        resetStartLine();
+    }
 
-            switch (state)
-            {
-            case ResponseStatusStart:
-                if (input != 'H')
-                {
-                    return ParsingError;
-                }
-                else
-                {
-                    state = ResponseHttpVersion_ht;
-                }
-                break;
-            case ResponseHttpVersion_ht:
-                if (input == 'T')
-                {
-                    state = ResponseHttpVersion_htt;
-                }
-                else
-                {
-                    return ParsingError;
-                }
-                break;
-            case ResponseHttpVersion_htt:
-                if (input == 'T')
-                {
-                    state = ResponseHttpVersion_http;
-                }
-                else
-                {
-                    return ParsingError;
-                }
-                break;
-            case ResponseHttpVersion_http:
-                if (input == 'P')
-                {
-                    state = ResponseHttpVersion_slash;
-                }
-                else
-                {
-                    return ParsingError;
-                }
-                break;
-            case ResponseHttpVersion_slash:
-                if (input == '/')
-                {
-                    resp.versionMajor = 0;
-                    resp.versionMinor = 0;
-                    state             = ResponseHttpVersion_majorStart;
-                }
-                else
-                {
-                    return ParsingError;
-                }
-                break;
-            case ResponseHttpVersion_majorStart:
-                if (isDigit(input))
-                {
-                    resp.versionMajor = input - '0';
-                    state             = ResponseHttpVersion_major;
-                }
-                else
-                {
-                    return ParsingError;
-                }
-                break;
-            case ResponseHttpVersion_major:
-                if (input == '.')
-                {
-                    state = ResponseHttpVersion_minorStart;
-                }
-                else if (isDigit(input))
-                {
-                    resp.versionMajor = resp.versionMajor * 10 + input - '0';
-                }
-                else
-                {
-                    return ParsingError;
-                }
-                break;
-            case ResponseHttpVersion_minorStart:
-                if (isDigit(input))
-                {
-                    resp.versionMinor = input - '0';
-                    state             = ResponseHttpVersion_minor;
-                }
-                else
-                {
-                    return ParsingError;
-                }
-                break;
-            case ResponseHttpVersion_minor:
-                if (input == ' ')
-                {
-                    state           = ResponseHttpVersion_statusCodeStart;
-                    resp.statusCode = 0;
-                }
-                else if (isDigit(input))
-                {
-                    resp.versionMinor = resp.versionMinor * 10 + input - '0';
-                }
-                else
-                {
-                    return ParsingError;
-                }
-                break;
-            case ResponseHttpVersion_statusCodeStart:
-                if (isDigit(input))
-                {
-                    resp.statusCode = input - '0';
-                    state           = ResponseHttpVersion_statusCode;
-                }
-                else
-                {
-                    return ParsingError;
-                }
-                break;
-            case ResponseHttpVersion_statusCode:
-                if (isDigit(input))
-                {
-                    resp.statusCode = resp.statusCode * 10 + input - '0';
-                }
-                else
-                {
-                    if (resp.statusCode < 100 || resp.statusCode > 999)
-                    {
-                        return ParsingError;
-                    }
-                    else if (input == ' ')
-                    {
-                        state = ResponseHttpVersion_statusTextStart;
-                    }
-                    else
-                    {
-                        return ParsingError;
-                    }
-                }
-                break;
-            case ResponseHttpVersion_statusTextStart:
-                if (isChar(input))
-                {
-                    resp.status += input;
-                    state = ResponseHttpVersion_statusText;
-                }
-                else
-                {
-                    return ParsingError;
-                }
-                break;
-            case ResponseHttpVersion_statusText:
-                if (input == '\r')
-                {
-                    state = ResponseHttpVersion_newLine;
-                }
-                else if (isChar(input))
-                {
-                    resp.status += input;
-                }
-                else
-                {
-                    return ParsingError;
-                }
-                break;
-            case ResponseHttpVersion_newLine:
-                if (input == '\n')
-                {
-                    state = HeaderLineStart;
-                }
-                else
-                {
-                    return ParsingError;
-                }
-                break;
-            case HeaderLineStart:
-                if (input == '\r')
-                {
-                    state = ExpectingNewline_3;
-                }
-                else if (!resp.headers.empty() && (input == ' ' || input == '\t'))
-                {
-                    state = HeaderLws;
-                }
-                else if (!isChar(input) || isControl(input) || isSpecial(input))
-                {
-                    return ParsingError;
-                }
-                else
-                {
-                    resp.headers.push_back(Response::HeaderItem());
-                    resp.headers.back().name.reserve(16);
-                    resp.headers.back().value.reserve(16);
-                    resp.headers.back().name.push_back(input);
-                    state = HeaderName;
-                }
-                break;
-            case HeaderLws:
-                if (input == '\r')
-                {
-                    state = ExpectingNewline_2;
-                }
-                else if (input == ' ' || input == '\t')
-                {
-                }
-                else if (isControl(input))
-                {
-                    return ParsingError;
-                }
-                else
-                {
-                    state = HeaderValue;
-                    resp.headers.back().value.push_back(input);
-                }
-                break;
-            case HeaderName:
-                if (input == ':')
-                {
-                    state = SpaceBeforeHeaderValue;
-                }
-                else if (!isChar(input) || isControl(input) || isSpecial(input))
-                {
-                    return ParsingError;
-                }
-                else
-                {
-                    resp.headers.back().name.push_back(input);
-                }
-                break;
-            case SpaceBeforeHeaderValue:
-                if (input == ' ')
-                {
-                    state = HeaderValue;
-                }
-                else
-                {
-                    return ParsingError;
-                }
-                break;
-            case HeaderValue:
-                if (input == '\r')
-                {
-                    Response::HeaderItem& h = resp.headers.back();
-
-                    if (strcasecmp(h.name.c_str(), "Content-Length") == 0)
-                    {
-                        contentSize = atoi(h.value.c_str());
-                        resp.content.reserve(contentSize);
-                    }
-                    else if (strcasecmp(h.name.c_str(), "Transfer-Encoding") == 0)
-                    {
-                        if (strcasecmp(h.value.c_str(), "chunked") == 0)
-                            chunked = true;
-                    }
-                    state = ExpectingNewline_2;
-                }
-                else if (isControl(input))
-                {
-                    return ParsingError;
-                }
-                else
-                {
-                    resp.headers.back().value.push_back(input);
-                }
-                break;
-            case ExpectingNewline_2:
-                if (input == '\n')
-                {
-                    state = HeaderLineStart;
-                }
-                else
-                {
-                    return ParsingError;
-                }
-                break;
-            case ExpectingNewline_3:
-            {
-                std::vector<Response::HeaderItem>::iterator it =
-                    std::find_if(resp.headers.begin(), resp.headers.end(), checkIfConnection);
+    using HttpParserBase<HttpResponseParser>::parse;
 
-                if (it != resp.headers.end())
-                {
-                    if (strcasecmp(it->value.c_str(), "Keep-Alive") == 0)
-                    {
-                        resp.keepAlive = true;
-                    }
-                    else  // == Close
-                    {
-                        resp.keepAlive = false;
-                    }
-                }
-                else
-                {
-                    if (resp.versionMajor > 1 || (resp.versionMajor == 1 && resp.versionMinor == 1))
-                        resp.keepAlive = true;
-                }
+    // The method of the request the next responses answer, which decides how they are framed: a
+    // response to HEAD never has a body, a 2xx response to CONNECT ends with its headers and the
+    // connection becomes a tunnel. It stays in effect over reset() until it is changed.
+    void setRequestMethod(Method method)
+    {
+        noBody = method == MethodHead;
+        tunnel = method == MethodConnect;
+    }
 
-                if (chunked)
-                {
-                    state = ChunkSize;
-                }
-                else if (contentSize == 0)
-                {
-                    if (input == '\n')
-                        return ParsingCompleted;
-                    else
-                        return ParsingError;
-                }
+    void setRequestMethod(const char* method) { setRequestMethod(methodId(method, strlen(method))); }
 
-                else
-                {
-                    state = Post;
-                }
-                break;
-            }
-            case Post:
-                --contentSize;
-                resp.content.push_back(input);
+    // Tell that the next responses have no body whatever their headers say, or undo that.
+    void setBodyExpected(bool expected) { noBody = !expected; }
 
-                if (contentSize == 0)
-                {
-                    return ParsingCompleted;
-                }
-                break;
-            case ChunkSize:
-                if (isalnum(input))
-                {
-                    chunkSizeStr.push_back(input);
-                }
-                else if (input == ';')
-                {
-                    state = ChunkExtensionName;
-                }
-                else if (input == '\r')
-                {
-                    state = ChunkSizeNewLine;
-                }
-                else
-                {
-                    return ParsingError;
-                }
-                break;
-            case ChunkExtensionName:
-                if (isalnum(input) || input == ' ')
-                {
-                    // skip
-                }
-                else if (input == '=')
-                {
-                    state = ChunkExtensionValue;
-                }
-                else if (input == '\r')
-                {
-                    state = ChunkSizeNewLine;
-                }
-                else
-                {
-                    return ParsingError;
-                }
-                break;
-            case ChunkExtensionValue:
-                if (isalnum(input) || input == ' ')
-                {
-                    // skip
-                }
-                else if (input == '\r')
-                {
-                    state = ChunkSizeNewLine;
-                }
-                else
-                {
-                    return ParsingError;
-                }
-                break;
-            case ChunkSizeNewLine:
-                if (input == '\n')
-                {
-                    chunkSize = strtol(chunkSizeStr.c_str(), NULL, 16);
-                    chunkSizeStr.clear();
-                    resp.content.reserve(resp.content.size() + chunkSize);
-
-                    if (chunkSize == 0)
-                        state = ChunkSizeNewLine_2;
-                    else
-                        state = ChunkData;
-                }
-                else
-                {
+    template <typename Alloc>
+    ParseResult parse(BasicResponse<Alloc>& resp, const char* begin, const char* end)
+    {
+        ResponseBuilder<BasicResponse<Alloc> > builder(resp);
+        return consume(builder, begin, end);
+    }
+
+    // Zero-copy parsing, see responseview.h for the buffer lifetime contract.
+    ParseResult parse(ResponseView& resp, const char* begin, const char* end)
+    {
+        ResponseBuilder<ResponseView> builder(resp);
+        return consume(builder, begin, end);
+    }
+
+    // Copy the message into the arena of `resp`, see arenaresponse.h.
+    ParseResult parse(ArenaResponse& resp, const char* begin, const char* end)
+    {
+        ArenaResponseBuilder builder(resp);
+        return consume(builder, begin, end);
+    }
+
+    // Parse into inline storage only, ParsingTooLarge if the message does not fit.
+    template <size_t MaxHeaders, size_t MaxBytes>
+    ParseResult parse(StaticResponse<MaxHeaders, MaxBytes>& resp, const char* begin, const char* end)
+    {
+        StaticResponseBuilder<StaticResponse<MaxHeaders, MaxBytes> > builder(resp);
+        ParseResult res = consume(builder, begin, end);
+        return builder.overflowed() ? tooLarge(CapacityExceeded) : res;
+    }
+
+    // Stream the body to `body` as it arrives instead of storing it in resp.content, so memory
+    // does not grow with the body size. Returning false from `body` stops parsing with ParsingError.
+    template <typename Alloc, typename BodySink>
+    ParseResult parse(BasicResponse<Alloc>& resp, BodySink& body, const char* begin, const char* end)
+    {
+        StreamingResponseBuilder<BasicResponse<Alloc>, BodySink> builder(resp, body);
+        return consume(builder, begin, end);
+    }
+
+    // Same as above, but also report in `consumed` how many bytes of [begin, end) were used. Once
+    // the message is completed, the rest of the buffer is the start of the next pipelined message.
+    template <typename Alloc>
+    ParseResult parse(BasicResponse<Alloc>& resp, const char* begin, const char* end, size_t& consumed)
+    {
+        ResponseBuilder<BasicResponse<Alloc> > builder(resp);
+        return parse(builder, begin, end, consumed);
+    }
+
+    ParseResult parse(ResponseView& resp, const char* begin, const char* end, size_t& consumed)
+    {
+        ResponseBuilder<ResponseView> builder(resp);
+        return parse(builder, begin, end, consumed);
+    }
+
+    ParseResult parse(ArenaResponse& resp, const char* begin, const char* end, size_t& consumed)
+    {
+        ArenaResponseBuilder builder(resp);
+        return parse(builder, begin, end, consumed);
+    }
+
+    template <size_t MaxHeaders, size_t MaxBytes>
+    ParseResult parse(StaticResponse<MaxHeaders, MaxBytes>& resp, const char* begin, const char* end, size_t& consumed)
+    {
+        StaticResponseBuilder<StaticResponse<MaxHeaders, MaxBytes> > builder(resp);
+        ParseResult res = parse(builder, begin, end, consumed);
+        return builder.overflowed() ? tooLarge(CapacityExceeded) : res;
+    }
+
+    template <typename Alloc, typename BodySink>
+    ParseResult parse(BasicResponse<Alloc>& resp, BodySink& body, const char* begin, const char* end, size_t& consumed)
+    {
+        StreamingResponseBuilder<BasicResponse<Alloc>, BodySink> builder(resp, body);
+        return parse(builder, begin, end, consumed);
+    }
+
+private:
+    friend class HttpParserBase<HttpResponseParser>;
+
+    template <typename Handler>
+    ParseResult consumeStartLine(Handler& handler, const char* pos, const char*& begin, const char* end,
+                                 const char*& mark)
+    {
+        char input = *pos;
+
+        switch (startLineState)
+        {
+        case ResponseStatusStart:
+            // "HTTP/1.1 " at once, the states below handle anything else and split buffers.
+            if (end - pos >= 9 && pos[8] == ' ' && matchVersion(pos))
+            {
+                if (!handler.onVersion(versionMajor, versionMinor))
                     return ParsingError;
-                }
+
+                startLineState = ResponseHttpVersion_statusCodeStart;
+                statusCode     = 0;
+                begin          = pos + 9;
                 break;
-            case ChunkSizeNewLine_2:
-                if (input == '\r')
-                {
-                    state = ChunkSizeNewLine_3;
-                }
-                else if (isalpha(input))
-                {
-                    state = ChunkTrailerName;
-                }
-                else
-                {
+            }
+
+            if (input != 'H')
+            {
+                return ParsingError;
+            }
+            else
+            {
+                startLineState = ResponseHttpVersion_ht;
+            }
+            break;
+        case ResponseHttpVersion_ht:
+            if (input == 'T')
+            {
+                startLineState = ResponseHttpVersion_htt;
+            }
+            else
+            {
+                return ParsingError;
+            }
+            break;
+        case ResponseHttpVersion_htt:
+            if (input == 'T')
+            {
+                startLineState = ResponseHttpVersion_http;
+            }
+            else
+            {
+                return ParsingError;
+            }
+            break;
+        case ResponseHttpVersion_http:
+            if (input == 'P')
+            {
+                startLineState = ResponseHttpVersion_slash;
+            }
+            else
+            {
+                return ParsingError;
+            }
+            break;
+        case ResponseHttpVersion_slash:
+            if (input == '/')
+            {
+                versionMajor   = 0;
+                versionMinor   = 0;
+                startLineState = ResponseHttpVersion_majorStart;
+            }
+            else
+            {
+                return ParsingError;
+            }
+            break;
+        case ResponseHttpVersion_majorStart:
+            if (isDigit(input))
+            {
+                versionMajor   = input - '0';
+                startLineState = ResponseHttpVersion_major;
+            }
+            else
+            {
+                return ParsingError;
+            }
+            break;
+        case ResponseHttpVersion_major:
+            if (input == '.')
+            {
+                startLineState = ResponseHttpVersion_minorStart;
+            }
+            else
+            {
+                return ParsingError;
+            }
+            break;
+        case ResponseHttpVersion_minorStart:
+            if (isDigit(input))
+            {
+                versionMinor   = input - '0';
+                startLineState = ResponseHttpVersion_minor;
+            }
+            else
+            {
+                return ParsingError;
+            }
+            break;
+        case ResponseHttpVersion_minor:
+            if (input == ' ')
+            {
+                if (!handler.onVersion(versionMajor, versionMinor))
                     return ParsingError;
-                }
-                break;
-            case ChunkSizeNewLine_3:
-                if (input == '\n')
-                {
-                    return ParsingCompleted;
-                }
-                else
-                {
+
+                startLineState = ResponseHttpVersion_statusCodeStart;
+                statusCode     = 0;
+            }
+            else
+            {
+                return ParsingError;
+            }
+            break;
+        case ResponseHttpVersion_statusCodeStart:
+            // RFC 9112: exactly three digits. Codes start at 100, so a leading zero can only
+            // pad one.
+            if (isDigit(input) && input != '0')
+            {
+                statusCode     = input - '0';
+                startLineState = ResponseHttpVersion_statusCode;
+            }
+            else
+            {
+                return ParsingError;
+            }
+            break;
+        case ResponseHttpVersion_statusCode:
+            if (isDigit(input))
+            {
+                if (statusCode >= 100)
                     return ParsingError;
-                }
-                break;
-            case ChunkTrailerName:
-                if (isalnum(input))
-                {
-                    // skip
-                }
-                else if (input == ':')
-                {
-                    state = ChunkTrailerValue;
-                }
-                else
+
+                statusCode = statusCode * 10 + input - '0';
+            }
+            else
+            {
+                if (statusCode < 100)
                 {
                     return ParsingError;
                 }
-                break;
-            case ChunkTrailerValue:
-                if (isalnum(input) || input == ' ')
+                else if (input == ' ')
                 {
-                    // skip
-                }
-                else if (input == '\r')
-                {
-                    state = ChunkSizeNewLine;
-                }
-                else
-                {
-                    return ParsingError;
-                }
-                break;
-            case ChunkData:
-                resp.content.push_back(input);
+                    if (!handler.onStatusCode(statusCode))
+                        return ParsingError;
 
-                if (--chunkSize == 0)
-                {
-                    state = ChunkDataNewLine_1;
-                }
-                break;
-            case ChunkDataNewLine_1:
-                if (input == '\r')
-                {
-                    state = ChunkDataNewLine_2;
+                    bodyAllowed    = bodyExpected();
+                    startLineState = ResponseHttpVersion_statusTextStart;
                 }
                 else
                 {
                     return ParsingError;
                 }
-                break;
-            case ChunkDataNewLine_2:
-                if (input == '\n')
-                {
-                    state = ChunkSize;
-                }
-                else
-                {
+            }
+            break;
+        case ResponseHttpVersion_statusTextStart:
+            if (isPhraseChar(input))
+            {
+                startLineState = ResponseHttpVersion_statusText;
+                mark           = pos;
+            }
+            else
+            {
+                return ParsingError;
+            }
+            break;
+        case ResponseHttpVersion_statusText:
+            if (input == '\r')
+            {
+                if (!emit(handler, mark, pos - mark))
                     return ParsingError;
-                }
-                break;
-            default:
+
+                state = StartLineNewLine;
+            }
+            else if (!isPhraseChar(input))
+            {
+                // The bytes so far count against the limits first, as in a split buffer.
+                emit(handler, mark, pos - mark);
                 return ParsingError;
             }
+            break;
+        default:
+            return ParsingError;
         }
 
         return ParsingIncompleted;
     }
 
-    // Check if a byte is an HTTP character.
-    inline bool isChar(int c) { return c >= 0 && c <= 127; }
-
-    // Check if a byte is an HTTP control character.
-    inline bool isControl(int c) { return (c >= 0 && c <= 31) || (c == 127); }
-
-    // Check if a byte is defined as an HTTP special character.
-    inline bool isSpecial(int c)
+    template <typename Handler>
+    bool emitStartLine(Handler& handler, const char* p, size_t n)
     {
-        switch (c)
+        switch (startLineState)
         {
-        case '(':
-        case ')':
-        case '<':
-        case '>':
-        case '@':
-        case ',':
-        case ';':
-        case ':':
-        case '\\':
-        case '"':
-        case '/':
-        case '[':
-        case ']':
-        case '?':
-        case '=':
-        case '{':
-        case '}':
-        case ' ':
-        case '\t':
-            return true;
+        case ResponseHttpVersion_statusText:
+            return countHeaderBytes(n) && handler.onStatus(p, n);
         default:
-            return false;
+            return true;
         }
     }
 
-    // Check if a byte is a digit.
-    inline bool isDigit(int c) { return c >= '0' && c <= '9'; }
+    void resetStartLine()
+    {
+        startLineState = ResponseStatusStart;
+        statusCode     = 0;
+    }
+
+    bool startLineStarted() const { return startLineState != ResponseStatusStart; }
 
-    // The current state of the parser.
-    enum State
+    // An HTTP/1.0 style response body without Content-Length or chunked encoding.
+    static const bool closeDelimited = true;
+
+    // Whether a response with this status to the current request may have a body.
+    bool bodyExpected() const
+    {
+        if (noBody || statusCode < 200 || statusCode == 204 || statusCode == 304)
+            return false;
+
+        return !(tunnel && statusCode < 300);
+    }
+
+    // The state of the parser within the status line.
+    enum StartLineState
     {
         ResponseStatusStart,
         ResponseHttpVersion_ht,
@@ -573,33 +530,11 @@ private:
         ResponseHttpVersion_statusCode,
         ResponseHttpVersion_statusTextStart,
         ResponseHttpVersion_statusText,
-        ResponseHttpVersion_newLine,
-        HeaderLineStart,
-        HeaderLws,
-        HeaderName,
-        SpaceBeforeHeaderValue,
-        HeaderValue,
-        ExpectingNewline_2,
-        ExpectingNewline_3,
-        Post,
-        ChunkSize,
-        ChunkExtensionName,
-        ChunkExtensionValue,
-        ChunkSizeNewLine,
-        ChunkSizeNewLine_2,
-        ChunkSizeNewLine_3,
-        ChunkTrailerName,
-        ChunkTrailerValue,
-
-        ChunkDataNewLine_1,
-        ChunkDataNewLine_2,
-        ChunkData,
-    } state;
-
-    size_t contentSize;
-    std::string chunkSizeStr;
-    size_t chunkSize;
-    bool chunked;
+    } startLineState;
+
+    unsigned int statusCode;
+    bool noBody;
+    bool tunnel;
 };
 
 }  // namespace httpparser
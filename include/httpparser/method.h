@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) Alex Nekipelov (alex@nekipelov.net)
+ * License: MIT
+ */
+
+#ifndef HTTPPARSER_METHOD_H
+#define HTTPPARSER_METHOD_H
+
+#include <string>
+
+#include <stddef.h>
+#include <string.h>
+
+namespace httpparser
+{
+
+// Request methods of RFC 9110 and RFC 5789. The parser classifies the method of every request;
+// extension methods are MethodUnknown and only available as text.
+enum Method
+{
+    MethodUnknown,
+    MethodGet,
+    MethodHead,
+    MethodPost,
+    MethodPut,
+    MethodDelete,
+    MethodConnect,
+    MethodOptions,
+    MethodTrace,
+    MethodPatch,
+
+    MethodCount
+};
+
+template <typename T = void>
+struct BasicMethodTable
+{
+    // Spelling, indexed by Method.
+    static constexpr const char* names[MethodCount] = {
+        "", "GET", "HEAD", "POST", "PUT", "DELETE", "CONNECT", "OPTIONS", "TRACE", "PATCH",
+    };
+};
+
+template <typename T>
+constexpr const char* BasicMethodTable<T>::names[MethodCount];
+
+typedef BasicMethodTable<> MethodTable;
+
+inline const char* methodName(Method method) { return MethodTable::names[method]; }
+
+// Classify a method token. Methods are case-sensitive, "get" is an extension method.
+inline Method methodId(const char* name, size_t size)
+{
+    for (int i = MethodUnknown + 1; i < MethodCount; ++i)
+    {
+        const char* candidate = MethodTable::names[i];
+
+        if (strlen(candidate) == size && memcmp(candidate, name, size) == 0)
+            return static_cast<Method>(i);
+    }
+
+    return MethodUnknown;
+}
+
+inline Method methodId(const std::string& name) { return methodId(name.data(), name.size()); }
+
+}  // namespace httpparser
+
+#endif  // HTTPPARSER_METHOD_H
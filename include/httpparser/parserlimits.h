@@ -0,0 +1,37 @@
+/*
+ * Copyright (C) Alex Nekipelov (alex@nekipelov.net)
+ * License: MIT
+ */
+
+#ifndef HTTPPARSER_PARSERLIMITS_H
+#define HTTPPARSER_PARSERLIMITS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace httpparser
+{
+
+// Upper bounds on what the parser accepts from the peer. A message that goes over one of them
+// stops with ParsingTooLarge before the offending bytes reach the handler, so the memory a
+// message can make the builders allocate is bounded by the limits rather than by the peer.
+struct ParserLimits
+{
+    ParserLimits()
+        : maxUriSize(8192), maxHeaderCount(100), maxHeaderBytes(64 * 1024), maxBodySize(UINT64_MAX)
+    {
+    }
+
+    // Length of the request target.
+    size_t maxUriSize;
+    // Number of header lines.
+    size_t maxHeaderCount;
+    // Size of the start line and the header lines: their tokens, line ends and folding whitespace.
+    size_t maxHeaderBytes;
+    // Content-Length, or the total of all chunks of a chunked body.
+    uint64_t maxBodySize;
+};
+
+}  // namespace httpparser
+
+#endif  // HTTPPARSER_PARSERLIMITS_H
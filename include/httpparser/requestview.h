@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) Alex Nekipelov (alex@nekipelov.net)
+ * License: MIT
+ */
+
+#ifndef HTTPPARSER_REQUESTVIEW_H
+#define HTTPPARSER_REQUESTVIEW_H
+
+#include <string>
+#include <vector>
+
+#include "headerindex.h"
+#include "method.h"
+#include "request.h"
+#include "slice.h"
+
+namespace httpparser
+{
+
+// Zero-copy counterpart of Request: every field is a slice of the buffer that was passed to
+// HttpRequestParser::parse(), nothing is copied.
+//
+// Buffer contract: all bytes of the message must live in one contiguous buffer which stays
+// alive and is not moved or modified while the view is in use. A message split across several
+// parse() calls is fine as long as each call continues exactly where the previous one stopped
+// in that same buffer. Call materialize() to get an owning Request that outlives the buffer.
+struct RequestView
+{
+    RequestView() : methodId(MethodUnknown), versionMajor(0), versionMinor(0), keepAlive(false) {}
+
+    struct HeaderItem
+    {
+        HeaderItem() : id(HeaderUnknown) {}
+
+        Slice name;
+        Slice value;
+        HeaderId id;
+    };
+
+    Slice method;
+    Method methodId;
+    Slice uri;
+    int versionMajor;
+    int versionMinor;
+    std::vector<HeaderItem> headers;
+    // One slice for a Content-Length body, one slice per chunk for a chunked body.
+    std::vector<Slice> content;
+    bool keepAlive;
+
+    HeaderItem& addHeader()
+    {
+        headers.push_back(HeaderItem());
+        return headers.back();
+    }
+
+    // Reset to the default-constructed state, keeping the capacity of the vectors.
+    void clear()
+    {
+        method.clear();
+        methodId = MethodUnknown;
+        uri.clear();
+        versionMajor = 0;
+        versionMinor = 0;
+        headers.clear();
+        index.clear();
+        content.clear();
+        keepAlive = false;
+    }
+
+    // Value of the first header called `key`, ignoring case, or an empty slice if there is none.
+    Slice header(const HeaderKey& key) const
+    {
+        size_t pos = index.find(headers, key);
+        return pos == HeaderIndex::npos ? Slice() : headers[pos].value;
+    }
+
+    bool has(const HeaderKey& key) const { return index.find(headers, key) != HeaderIndex::npos; }
+
+    // All headers called `key`, in the order of the message.
+    std::vector<const HeaderItem*> findAll(const HeaderKey& key) const
+    {
+        std::vector<const HeaderItem*> result;
+
+        for (size_t pos = index.find(headers, key); pos != HeaderIndex::npos; pos = index.findNext(headers, key, pos))
+            result.push_back(&headers[pos]);
+
+        return result;
+    }
+
+    // Index the headers for the lookups above. The parser does it when the headers are complete;
+    // call it again after any change to `headers`, renaming one in place included. The index does
+    // not see such changes, and the lookups may miss headers until then. A renamed header also
+    // needs the `id` of its new name, or HeaderUnknown.
+    void reindex() { index.build(headers); }
+
+    template <typename Alloc>
+    void materialize(BasicRequest<Alloc>& req) const
+    {
+        req.clear();
+        req.method.assign(method.data(), method.size());
+        req.methodId = methodId;
+        req.uri.assign(uri.data(), uri.size());
+        req.versionMajor = versionMajor;
+        req.versionMinor = versionMinor;
+        req.keepAlive    = keepAlive;
+
+        for (size_t i = 0; i < headers.size(); ++i)
+        {
+            req.addHeader().name.assign(headers[i].name.data(), headers[i].name.size());
+            req.headers.back().value.assign(headers[i].value.data(), headers[i].value.size());
+            req.headers.back().id = headers[i].id;
+        }
+
+        for (std::vector<Slice>::const_iterator it = content.begin(); it != content.end(); ++it)
+        {
+            req.content.insert(req.content.end(), it->begin(), it->end());
+        }
+
+        req.reindex();
+    }
+
+    Request materialize() const
+    {
+        Request req;
+        materialize(req);
+        return req;
+    }
+
+    std::string inspect() const { return materialize().inspect(); }
+
+private:
+    HeaderIndex index;
+};
+
+}  // namespace httpparser
+
+#endif  // HTTPPARSER_REQUESTVIEW_H
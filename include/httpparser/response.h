@@ -6,48 +6,158 @@
 #ifndef HTTPPARSER_RESPONSE_H
 #define HTTPPARSER_RESPONSE_H
 
+#include <algorithm>
+#include <memory>
 #include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "headerid.h"
+#include "headerindex.h"
+
 namespace httpparser
 {
 
-struct Response
+// Every string and vector of the message, and of the headers it hands out, uses a copy of the
+// allocator given to the constructor.
+template <typename Alloc = std::allocator<char> >
+struct BasicResponse
 {
-    Response() : versionMajor(0), versionMinor(0), keepAlive(false), statusCode(0) {}
+private:
+    typedef std::allocator_traits<Alloc> AllocatorTraits;
+
+public:
+    typedef Alloc allocator_type;
+    typedef std::basic_string<char, std::char_traits<char>, typename AllocatorTraits::template rebind_alloc<char> > String;
+
+    explicit BasicResponse(const Alloc& alloc = Alloc())
+        : versionMajor(0),
+          versionMinor(0),
+          headers(alloc),
+          content(alloc),
+          keepAlive(false),
+          statusCode(0),
+          status(alloc),
+          headerPool(alloc),
+          index(alloc),
+          none(alloc)
+    {
+    }
 
     struct HeaderItem
     {
-        std::string name;
-        std::string value;
+        HeaderItem() : id(HeaderUnknown) {}
+        HeaderItem(const String& name, const String& value, HeaderId id = HeaderUnknown)
+            : name(name), value(value), id(id)
+        {
+        }
+
+        String name;
+        String value;
+        // Set by the parser, HeaderUnknown for a header added by hand.
+        HeaderId id;
     };
 
     int versionMajor;
     int versionMinor;
-    std::vector<HeaderItem> headers;
-    std::vector<char> content;
+    std::vector<HeaderItem, typename AllocatorTraits::template rebind_alloc<HeaderItem> > headers;
+    std::vector<char, typename AllocatorTraits::template rebind_alloc<char> > content;
     bool keepAlive;
 
     unsigned int statusCode;
-    std::string status;
+    String status;
+
+    // Append an empty header, reusing the storage of a header dropped by clear() if possible.
+    HeaderItem& addHeader()
+    {
+        if (headerPool.empty())
+        {
+            HeaderItem item = {String(none.get_allocator()), String(none.get_allocator()), HeaderUnknown};
+            headers.push_back(std::move(item));
+        }
+        else
+        {
+            headers.push_back(std::move(headerPool.back()));
+            headerPool.pop_back();
+        }
+
+        return headers.back();
+    }
+
+    // Same as Request::clear().
+    void clear()
+    {
+        versionMajor = 0;
+        versionMinor = 0;
+        content.clear();
+        keepAlive  = false;
+        statusCode = 0;
+        status.clear();
+
+        for (size_t i = headers.size(); i-- > 0;)
+        {
+            headers[i].name.clear();
+            headers[i].value.clear();
+            headers[i].id = HeaderUnknown;
+            headerPool.push_back(std::move(headers[i]));
+        }
+
+        headers.clear();
+        index.clear();
+    }
+
+    // Value of the first header called `key`, ignoring case, or an empty string if there is none.
+    const String& header(const HeaderKey& key) const
+    {
+        size_t pos = index.find(headers, key);
+        return pos == HeaderIndex::npos ? none : headers[pos].value;
+    }
+
+    bool has(const HeaderKey& key) const { return index.find(headers, key) != HeaderIndex::npos; }
+
+    // All headers called `key`, in the order of the message.
+    std::vector<const HeaderItem*> findAll(const HeaderKey& key) const
+    {
+        std::vector<const HeaderItem*> result;
+
+        for (size_t pos = index.find(headers, key); pos != HeaderIndex::npos; pos = index.findNext(headers, key, pos))
+            result.push_back(&headers[pos]);
+
+        return result;
+    }
+
+    // Index the headers for the lookups above. The parser does it when the headers are complete;
+    // call it again after any change to `headers`, renaming one in place included. The index does
+    // not see such changes, and the lookups may miss headers until then. A renamed header also
+    // needs the `id` of its new name, or HeaderUnknown.
+    void reindex() { index.build(headers); }
 
     std::string inspect() const
     {
         std::stringstream stream;
         stream << "HTTP/" << versionMajor << "." << versionMinor << " " << statusCode << " " << status << "\n";
 
-        for (std::vector<Response::HeaderItem>::const_iterator it = headers.begin(); it != headers.end(); ++it)
+        for (size_t i = 0; i < headers.size(); ++i)
         {
-            stream << it->name << ": " << it->value << "\n";
+            stream << headers[i].name << ": " << headers[i].value << "\n";
         }
 
         std::string data(content.begin(), content.end());
         stream << data << "\n";
         return stream.str();
     }
+
+private:
+    // Cleared headers kept for reuse, the next one to hand out is at the back.
+    std::vector<HeaderItem, typename AllocatorTraits::template rebind_alloc<HeaderItem> > headerPool;
+    BasicHeaderIndex<Alloc> index;
+    // Returned by header() for a missing header, and the source of the allocator for new headers.
+    String none;
 };
 
+typedef BasicResponse<> Response;
+
 }  // namespace httpparser
 
 #endif  // HTTPPARSER_RESPONSE_H
@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) Alex Nekipelov (alex@nekipelov.net)
+ * License: MIT
+ */
+
+#ifndef HTTPPARSER_RESPONSEVIEW_H
+#define HTTPPARSER_RESPONSEVIEW_H
+
+#include <string>
+#include <vector>
+
+#include "headerindex.h"
+#include "response.h"
+#include "slice.h"
+
+namespace httpparser
+{
+
+// Zero-copy counterpart of Response. The same buffer contract as for RequestView applies:
+// the whole message must stay alive, unmoved and contiguous while the view is in use.
+struct ResponseView
+{
+    ResponseView() : versionMajor(0), versionMinor(0), keepAlive(false), statusCode(0) {}
+
+    struct HeaderItem
+    {
+        HeaderItem() : id(HeaderUnknown) {}
+
+        Slice name;
+        Slice value;
+        HeaderId id;
+    };
+
+    int versionMajor;
+    int versionMinor;
+    std::vector<HeaderItem> headers;
+    // One slice for a Content-Length body, one slice per chunk for a chunked body.
+    std::vector<Slice> content;
+    bool keepAlive;
+
+    unsigned int statusCode;
+    Slice status;
+
+    HeaderItem& addHeader()
+    {
+        headers.push_back(HeaderItem());
+        return headers.back();
+    }
+
+    // Reset to the default-constructed state, keeping the capacity of the vectors.
+    void clear()
+    {
+        versionMajor = 0;
+        versionMinor = 0;
+        headers.clear();
+        index.clear();
+        content.clear();
+        keepAlive  = false;
+        statusCode = 0;
+        status.clear();
+    }
+
+    // Value of the first header called `key`, ignoring case, or an empty slice if there is none.
+    Slice header(const HeaderKey& key) const
+    {
+        size_t pos = index.find(headers, key);
+        return pos == HeaderIndex::npos ? Slice() : headers[pos].value;
+    }
+
+    bool has(const HeaderKey& key) const { return index.find(headers, key) != HeaderIndex::npos; }
+
+    // All headers called `key`, in the order of the message.
+    std::vector<const HeaderItem*> findAll(const HeaderKey& key) const
+    {
+        std::vector<const HeaderItem*> result;
+
+        for (size_t pos = index.find(headers, key); pos != HeaderIndex::npos; pos = index.findNext(headers, key, pos))
+            result.push_back(&headers[pos]);
+
+        return result;
+    }
+
+    // Index the headers for the lookups above. The parser does it when the headers are complete;
+    // call it again after any change to `headers`, renaming one in place included. The index does
+    // not see such changes, and the lookups may miss headers until then. A renamed header also
+    // needs the `id` of its new name, or HeaderUnknown.
+    void reindex() { index.build(headers); }
+
+    template <typename Alloc>
+    void materialize(BasicResponse<Alloc>& resp) const
+    {
+        resp.clear();
+        resp.versionMajor = versionMajor;
+        resp.versionMinor = versionMinor;
+        resp.keepAlive    = keepAlive;
+        resp.statusCode   = statusCode;
+        resp.status.assign(status.data(), status.size());
+
+        for (size_t i = 0; i < headers.size(); ++i)
+        {
+            resp.addHeader().name.assign(headers[i].name.data(), headers[i].name.size());
+            resp.headers.back().value.assign(headers[i].value.data(), headers[i].value.size());
+            resp.headers.back().id = headers[i].id;
+        }
+
+        for (std::vector<Slice>::const_iterator it = content.begin(); it != content.end(); ++it)
+        {
+            resp.content.insert(resp.content.end(), it->begin(), it->end());
+        }
+
+        resp.reindex();
+    }
+
+    Response materialize() const
+    {
+        Response resp;
+        materialize(resp);
+        return resp;
+    }
+
+    std::string inspect() const { return materialize().inspect(); }
+
+private:
+    HeaderIndex index;
+};
+
+}  // namespace httpparser
+
+#endif  // HTTPPARSER_RESPONSEVIEW_H
@@ -0,0 +1,262 @@
+/*
+ * Copyright (C) Alex Nekipelov (alex@nekipelov.net)
+ * License: MIT
+ */
+
+#ifndef HTTPPARSER_SCAN_H
+#define HTTPPARSER_SCAN_H
+
+#include <string.h>
+
+#include "chartable.h"
+
+// Vector scanners are built on x86 with GCC and Clang, which can compile SSE4.2 and AVX2
+// functions without -m flags and tell the CPU features at runtime. Define HTTPPARSER_NO_SIMD
+// to always use the portable loops.
+#if !defined(HTTPPARSER_NO_SIMD) && (defined(__GNUC__) || defined(__clang__)) \
+    && (defined(__x86_64__) || defined(__i386__))
+#define HTTPPARSER_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace httpparser
+{
+
+// Scanners for the long runs of header lines. Each one returns the first byte in [p, end) that
+// ends the run, or `end` if the run goes on past the buffer. The blankLine scanners return the
+// first "\r\n\r\n" that lies entirely in [p, end) instead.
+namespace scan
+{
+
+enum Level
+{
+    Scalar,
+    Sse42,
+    Avx2
+};
+
+// Portable versions.
+inline const char* tokenScalar(const char* p, const char* end)
+{
+    while (p != end && isToken(*p))
+        ++p;
+
+    return p;
+}
+
+inline const char* textScalar(const char* p, const char* end)
+{
+    while (p != end && isText(*p))
+        ++p;
+
+    return p;
+}
+
+inline const char* blankLineScalar(const char* p, const char* end)
+{
+    // Look at every LF that could end the blank line, memchr() skips the rest.
+    for (const char* lf = p + 3; lf < end; lf += 2)
+    {
+        lf = static_cast<const char*>(memchr(lf, '\n', end - lf));
+        if (!lf)
+            break;
+
+        if (lf[-1] == '\r' && lf[-2] == '\n' && lf[-3] == '\r')
+            return lf - 3;
+    }
+
+    return end;
+}
+
+#ifdef HTTPPARSER_SIMD_X86
+
+// The byte ranges that stop a run, for PCMPESTRI. Eight ranges cannot describe the token
+// delimiters exactly, so "{" to 0xff also stops at "|" and "~"; those are checked against the
+// table and skipped.
+__attribute__((target("sse4.2"))) inline const char* tokenSse42(const char* p, const char* end)
+{
+    static const char ranges[16] = {'\0', ' ', '"', '"', '(', ')', ',', ',', '/', '/', ':', '@', '[', ']', '{', '\xff'};
+    const __m128i r              = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ranges));
+
+    while (end - p >= 16)
+    {
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        int i     = _mm_cmpestri(r, 16, b, 16, _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_LEAST_SIGNIFICANT);
+
+        if (i == 16)
+        {
+            p += 16;
+        }
+        else
+        {
+            p += i;
+            if (!isToken(*p))
+                return p;
+            ++p;
+        }
+    }
+
+    return tokenScalar(p, end);
+}
+
+__attribute__((target("sse4.2"))) inline const char* textSse42(const char* p, const char* end)
+{
+    static const char ranges[16] = {'\0', '\x1f', '\x7f', '\x7f'};
+    const __m128i r              = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ranges));
+
+    while (end - p >= 16)
+    {
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        int i     = _mm_cmpestri(r, 4, b, 16, _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_LEAST_SIGNIFICANT);
+
+        if (i != 16)
+            return p + i;
+
+        p += 16;
+    }
+
+    return textScalar(p, end);
+}
+
+// A control byte is one that the unsigned minimum with 0x1f leaves unchanged.
+__attribute__((target("avx2"))) inline const char* textAvx2(const char* p, const char* end)
+{
+    const __m256i control = _mm256_set1_epi8(0x1f);
+    const __m256i del     = _mm256_set1_epi8(0x7f);
+
+    while (end - p >= 32)
+    {
+        __m256i b         = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i lo        = _mm256_cmpeq_epi8(_mm256_min_epu8(b, control), b);
+        __m256i hi        = _mm256_cmpeq_epi8(b, del);
+        unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_or_si256(lo, hi)));
+
+        if (mask != 0)
+            return p + __builtin_ctz(mask);
+
+        p += 32;
+    }
+
+    return textSse42(p, end);
+}
+
+// Compare 16 positions at once against each of the four bytes of "\r\n\r\n".
+__attribute__((target("sse2"))) inline const char* blankLineSse2(const char* p, const char* end)
+{
+    const __m128i cr = _mm_set1_epi8('\r');
+    const __m128i lf = _mm_set1_epi8('\n');
+
+    while (end - p >= 16 + 3)
+    {
+        __m128i b0        = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), cr);
+        __m128i b1        = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 1)), lf);
+        __m128i b2        = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 2)), cr);
+        __m128i b3        = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 3)), lf);
+        __m128i hit       = _mm_and_si128(_mm_and_si128(b0, b1), _mm_and_si128(b2, b3));
+        unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(hit));
+
+        if (mask != 0)
+            return p + __builtin_ctz(mask);
+
+        p += 16;
+    }
+
+    return blankLineScalar(p, end);
+}
+
+__attribute__((target("avx2"))) inline const char* blankLineAvx2(const char* p, const char* end)
+{
+    const __m256i cr = _mm256_set1_epi8('\r');
+    const __m256i lf = _mm256_set1_epi8('\n');
+
+    while (end - p >= 32 + 3)
+    {
+        __m256i b0        = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)), cr);
+        __m256i b1        = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 1)), lf);
+        __m256i b2        = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 2)), cr);
+        __m256i b3        = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 3)), lf);
+        __m256i hit       = _mm256_and_si256(_mm256_and_si256(b0, b1), _mm256_and_si256(b2, b3));
+        unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(hit));
+
+        if (mask != 0)
+            return p + __builtin_ctz(mask);
+
+        p += 32;
+    }
+
+    return blankLineSse2(p, end);
+}
+
+inline Level detectLevel()
+{
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2"))
+        return Avx2;
+    if (__builtin_cpu_supports("sse4.2"))
+        return Sse42;
+    return Scalar;
+}
+
+#else
+
+inline Level detectLevel() { return Scalar; }
+
+#endif  // HTTPPARSER_SIMD_X86
+
+// The best instruction set of this CPU, detected on first use.
+inline Level level()
+{
+    static const Level detected = detectLevel();
+    return detected;
+}
+
+// Find the end of a header name.
+inline const char* token(const char* p, const char* end)
+{
+#ifdef HTTPPARSER_SIMD_X86
+    if (level() != Scalar)
+        return tokenSse42(p, end);
+#endif
+    return tokenScalar(p, end);
+}
+
+// Find the end of a header value: the CR, or the control byte that makes it invalid.
+inline const char* text(const char* p, const char* end)
+{
+#ifdef HTTPPARSER_SIMD_X86
+    switch (level())
+    {
+    case Avx2:
+        return textAvx2(p, end);
+    case Sse42:
+        return textSse42(p, end);
+    default:
+        break;
+    }
+#endif
+    return textScalar(p, end);
+}
+
+// Find the blank line that ends the headers.
+inline const char* blankLine(const char* p, const char* end)
+{
+#ifdef HTTPPARSER_SIMD_X86
+    switch (level())
+    {
+    case Avx2:
+        return blankLineAvx2(p, end);
+    case Sse42:
+        return blankLineSse2(p, end);
+    default:
+        break;
+    }
+#endif
+    return blankLineScalar(p, end);
+}
+
+}  // namespace scan
+
+}  // namespace httpparser
+
+#endif  // HTTPPARSER_SCAN_H
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) Alex Nekipelov (alex@nekipelov.net)
+ * License: MIT
+ */
+
+#ifndef HTTPPARSER_SLICE_H
+#define HTTPPARSER_SLICE_H
+
+#include <ostream>
+#include <string>
+
+#include <stddef.h>
+#include <string.h>
+
+namespace httpparser
+{
+
+// A non-owning (pointer, length) reference into a buffer owned by someone else.
+class Slice
+{
+public:
+    Slice() : ptr(NULL), len(0) {}
+    Slice(const char* data, size_t size) : ptr(data), len(size) {}
+
+    const char* data() const { return ptr; }
+    size_t size() const { return len; }
+    bool empty() const { return len == 0; }
+
+    const char* begin() const { return ptr; }
+    const char* end() const { return ptr + len; }
+
+    char operator[](size_t i) const { return ptr[i]; }
+
+    std::string str() const { return std::string(ptr, len); }
+
+    // Grow the slice by `n` bytes that directly follow it in the same buffer.
+    // An empty slice starts at `p`.
+    void extend(const char* p, size_t n)
+    {
+        if (len == 0)
+            ptr = p;
+
+        len += n;
+    }
+
+    void clear()
+    {
+        ptr = NULL;
+        len = 0;
+    }
+
+    bool operator==(const char* str) const { return strlen(str) == len && memcmp(ptr, str, len) == 0; }
+    bool operator!=(const char* str) const { return !(*this == str); }
+
+private:
+    const char* ptr;
+    size_t len;
+};
+
+inline std::ostream& operator<<(std::ostream& stream, const Slice& slice)
+{
+    return stream.write(slice.data(), static_cast<std::streamsize>(slice.size()));
+}
+
+}  // namespace httpparser
+
+#endif  // HTTPPARSER_SLICE_H
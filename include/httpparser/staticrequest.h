@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) Alex Nekipelov (alex@nekipelov.net)
+ * License: MIT
+ */
+
+#ifndef HTTPPARSER_STATICREQUEST_H
+#define HTTPPARSER_STATICREQUEST_H
+
+#include <string>
+
+#include <stddef.h>
+
+#include "fixedstorage.h"
+#include "headerid.h"
+#include "headerindex.h"
+#include "method.h"
+#include "request.h"
+#include "slice.h"
+
+namespace httpparser
+{
+
+// A request that keeps everything inline, for parsing without touching the heap: at most
+// `MaxHeaders` headers and `MaxBytes` bytes of text for the method, the URI, the header names
+// and values and the body together. HttpRequestParser returns ParsingTooLarge for a message that
+// does not fit.
+//
+// The fields are slices of the request's own storage, so it cannot be copied; materialize() it
+// into a Request to keep it.
+template <size_t MaxHeaders, size_t MaxBytes>
+struct StaticRequest
+{
+    StaticRequest() : methodId(MethodUnknown), versionMajor(0), versionMinor(0), keepAlive(false) {}
+
+    struct HeaderItem
+    {
+        HeaderItem() : id(HeaderUnknown) {}
+
+        Slice name;
+        Slice value;
+        HeaderId id;
+    };
+
+    Slice method;
+    Method methodId;
+    Slice uri;
+    int versionMajor;
+    int versionMinor;
+    FixedVector<HeaderItem, MaxHeaders> headers;
+    Slice content;
+    bool keepAlive;
+    FixedBuffer<MaxBytes> storage;
+
+    // Reset to the default-constructed state, ready for the next message.
+    void clear()
+    {
+        method.clear();
+        methodId = MethodUnknown;
+        uri.clear();
+        versionMajor = 0;
+        versionMinor = 0;
+        headers.clear();
+        content.clear();
+        keepAlive = false;
+        storage.reset();
+    }
+
+    // Value of the first header called `key`, ignoring case, or an empty slice if there is none.
+    // There are only a few headers, so this is a scan.
+    Slice header(const HeaderKey& key) const
+    {
+        for (size_t i = 0; i < headers.size(); ++i)
+        {
+            if (key.matches(headers[i]))
+                return headers[i].value;
+        }
+
+        return Slice();
+    }
+
+    bool has(const HeaderKey& key) const
+    {
+        for (size_t i = 0; i < headers.size(); ++i)
+        {
+            if (key.matches(headers[i]))
+                return true;
+        }
+
+        return false;
+    }
+
+    template <typename Alloc>
+    void materialize(BasicRequest<Alloc>& req) const
+    {
+        req.clear();
+        req.method.assign(method.data(), method.size());
+        req.methodId = methodId;
+        req.uri.assign(uri.data(), uri.size());
+        req.versionMajor = versionMajor;
+        req.versionMinor = versionMinor;
+        req.keepAlive    = keepAlive;
+
+        for (size_t i = 0; i < headers.size(); ++i)
+        {
+            req.addHeader().name.assign(headers[i].name.data(), headers[i].name.size());
+            req.headers.back().value.assign(headers[i].value.data(), headers[i].value.size());
+            req.headers.back().id = headers[i].id;
+        }
+
+        req.content.assign(content.begin(), content.end());
+        req.reindex();
+    }
+
+    Request materialize() const
+    {
+        Request req;
+        materialize(req);
+        return req;
+    }
+
+    std::string inspect() const { return materialize().inspect(); }
+};
+
+}  // namespace httpparser
+
+#endif  // HTTPPARSER_STATICREQUEST_H
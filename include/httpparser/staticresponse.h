@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) Alex Nekipelov (alex@nekipelov.net)
+ * License: MIT
+ */
+
+#ifndef HTTPPARSER_STATICRESPONSE_H
+#define HTTPPARSER_STATICRESPONSE_H
+
+#include <string>
+
+#include <stddef.h>
+
+#include "fixedstorage.h"
+#include "headerid.h"
+#include "headerindex.h"
+#include "response.h"
+#include "slice.h"
+
+namespace httpparser
+{
+
+// A response that keeps everything inline, see StaticRequest. `MaxBytes` covers the reason
+// phrase, the header names and values and the body.
+template <size_t MaxHeaders, size_t MaxBytes>
+struct StaticResponse
+{
+    StaticResponse() : versionMajor(0), versionMinor(0), keepAlive(false), statusCode(0) {}
+
+    struct HeaderItem
+    {
+        HeaderItem() : id(HeaderUnknown) {}
+
+        Slice name;
+        Slice value;
+        HeaderId id;
+    };
+
+    int versionMajor;
+    int versionMinor;
+    FixedVector<HeaderItem, MaxHeaders> headers;
+    Slice content;
+    bool keepAlive;
+
+    unsigned int statusCode;
+    Slice status;
+    FixedBuffer<MaxBytes> storage;
+
+    // Reset to the default-constructed state, ready for the next message.
+    void clear()
+    {
+        versionMajor = 0;
+        versionMinor = 0;
+        headers.clear();
+        content.clear();
+        keepAlive  = false;
+        statusCode = 0;
+        status.clear();
+        storage.reset();
+    }
+
+    // Value of the first header called `key`, ignoring case, or an empty slice if there is none.
+    // There are only a few headers, so this is a scan.
+    Slice header(const HeaderKey& key) const
+    {
+        for (size_t i = 0; i < headers.size(); ++i)
+        {
+            if (key.matches(headers[i]))
+                return headers[i].value;
+        }
+
+        return Slice();
+    }
+
+    bool has(const HeaderKey& key) const
+    {
+        for (size_t i = 0; i < headers.size(); ++i)
+        {
+            if (key.matches(headers[i]))
+                return true;
+        }
+
+        return false;
+    }
+
+    template <typename Alloc>
+    void materialize(BasicResponse<Alloc>& resp) const
+    {
+        resp.clear();
+        resp.versionMajor = versionMajor;
+        resp.versionMinor = versionMinor;
+        resp.keepAlive    = keepAlive;
+        resp.statusCode   = statusCode;
+        resp.status.assign(status.data(), status.size());
+
+        for (size_t i = 0; i < headers.size(); ++i)
+        {
+            resp.addHeader().name.assign(headers[i].name.data(), headers[i].name.size());
+            resp.headers.back().value.assign(headers[i].value.data(), headers[i].value.size());
+            resp.headers.back().id = headers[i].id;
+        }
+
+        resp.content.assign(content.begin(), content.end());
+        resp.reindex();
+    }
+
+    Response materialize() const
+    {
+        Response resp;
+        materialize(resp);
+        return resp;
+    }
+
+    std::string inspect() const { return materialize().inspect(); }
+};
+
+}  // namespace httpparser
+
+#endif  // HTTPPARSER_STATICRESPONSE_H
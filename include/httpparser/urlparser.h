@@ -11,6 +11,8 @@
 #include <stdlib.h>
 #include <string>
 
+#include "chartable.h"
+
 namespace httpparser
 {
 
@@ -23,7 +25,7 @@ public:
 
     bool parse(const std::string& str)
     {
-        url = Url();
+        url.clear();
         parse_(str);
 
         return isValid();
@@ -100,23 +102,6 @@ public:
     }
 
 private:
-    bool isUnreserved(char ch) const
-    {
-        if (isalnum(ch))
-            return true;
-
-        switch (ch)
-        {
-        case '-':
-        case '.':
-        case '_':
-        case '~':
-            return true;
-        }
-
-        return false;
-    }
-
     void parse_(const std::string& str)
     {
         enum
@@ -135,8 +120,8 @@ private:
             Fragment
         } state = Scheme;
 
-        std::string usernameOrHostname;
-        std::string portOrPassword;
+        usernameOrHostname.clear();
+        portOrPassword.clear();
 
         valid           = true;
         url.path        = "/";
@@ -149,7 +134,7 @@ private:
             switch (state)
             {
             case Scheme:
-                if (isalnum(ch) || ch == '+' || ch == '-' || ch == '.')
+                if (isSchemeChar(ch))
                 {
                     url.scheme += ch;
                 }
@@ -160,7 +145,7 @@ private:
                 else
                 {
                     valid = false;
-                    url   = Url();
+                    url.clear();
                 }
                 break;
             case SlashAfterScheme1:
@@ -168,7 +153,7 @@ private:
                 {
                     state = SlashAfterScheme2;
                 }
-                else if (isalnum(ch))
+                else if (isAlnum(ch))
                 {
                     usernameOrHostname = ch;
                     state              = UsernameOrHostname;
@@ -176,7 +161,7 @@ private:
                 else
                 {
                     valid = false;
-                    url   = Url();
+                    url.clear();
                 }
                 break;
             case SlashAfterScheme2:
@@ -187,7 +172,7 @@ private:
                 else
                 {
                     valid = false;
-                    url   = Url();
+                    url.clear();
                 }
                 break;
             case UsernameOrHostname:
@@ -212,11 +197,11 @@ private:
                 else
                 {
                     valid = false;
-                    url   = Url();
+                    url.clear();
                 }
                 break;
             case Password:
-                if (isalnum(ch) || ch == '%')
+                if (isAlnum(ch) || ch == '%')
                 {
                     url.password += ch;
                 }
@@ -227,7 +212,7 @@ private:
                 else
                 {
                     valid = false;
-                    url   = Url();
+                    url.clear();
                 }
                 break;
             case Hostname:
@@ -250,13 +235,13 @@ private:
                 else
                 {
                     valid = false;
-                    url   = Url();
+                    url.clear();
                 }
                 break;
             case IPV6Hostname:
                 abort();  // TODO
             case PortOrPassword:
-                if (isdigit(ch))
+                if (isDigit(ch))
                 {
                     portOrPassword += ch;
                 }
@@ -267,7 +252,7 @@ private:
                     url.integerPort = atoi(url.port.c_str());
                     state           = Path;
                 }
-                else if (isalnum(ch) || ch == '%')
+                else if (isAlnum(ch) || ch == '%')
                 {
                     std::swap(url.username, usernameOrHostname);
                     std::swap(url.password, portOrPassword);
@@ -277,11 +262,11 @@ private:
                 else
                 {
                     valid = false;
-                    url   = Url();
+                    url.clear();
                 }
                 break;
             case Port:
-                if (isdigit(ch))
+                if (isDigit(ch))
                 {
                     portOrPassword += ch;
                 }
@@ -294,7 +279,7 @@ private:
                 else
                 {
                     valid = false;
-                    url   = Url();
+                    url.clear();
                 }
                 break;
             case Path:
@@ -343,6 +328,21 @@ private:
     {
         Url() : integerPort(0) {}
 
+        // Empty every part but keep the storage, so parsing the next url allocates nothing
+        // unless it has a longer part.
+        void clear()
+        {
+            scheme.clear();
+            username.clear();
+            password.clear();
+            hostname.clear();
+            port.clear();
+            path.clear();
+            query.clear();
+            fragment.clear();
+            integerPort = 0;
+        }
+
         std::string scheme;
         std::string username;
         std::string password;
@@ -353,6 +353,10 @@ private:
         std::string fragment;
         uint16_t integerPort;
     } url;
+
+    // Scratch for the parts that are only told apart later, swapped with parts of `url`.
+    std::string usernameOrHostname;
+    std::string portOrPassword;
 };
 
 }  // namespace httpparser
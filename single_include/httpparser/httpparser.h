@@ -1,1614 +1,4485 @@
-#pragma once
+/*
+ * Copyright (C) Alex Nekipelov (alex@nekipelov.net)
+ * License: MIT
+ *
+ * Generated from include/httpparser by cmake/amalgamate.cmake, do not edit.
+ */
+
+#ifndef HTTPPARSER_HTTPPARSER_H
+#define HTTPPARSER_HTTPPARSER_H
+
+#ifndef HTTPPARSER_REQUESTPARSER_H
+#define HTTPPARSER_REQUESTPARSER_H
+
+#ifndef HTTPPARSER_ARENAREQUEST_H
+#define HTTPPARSER_ARENAREQUEST_H
+
+#ifndef HTTPPARSER_ARENA_H
+#define HTTPPARSER_ARENA_H
+
 #include <algorithm>
+#include <new>
+#include <vector>
+
 #include <assert.h>
-#include <sstream>
-#include <stdint.h>
-#include <stdlib.h>
+#include <stddef.h>
 #include <string.h>
+
+#ifndef HTTPPARSER_SLICE_H
+#define HTTPPARSER_SLICE_H
+
+#include <ostream>
 #include <string>
-#include <vector>
+
+#include <stddef.h>
+#include <string.h>
 
 namespace httpparser
 {
-struct Request
+
+// A non-owning (pointer, length) reference into a buffer owned by someone else.
+class Slice
 {
-    Request() : versionMajor(0), versionMinor(0), keepAlive(false) {}
+public:
+    Slice() : ptr(NULL), len(0) {}
+    Slice(const char* data, size_t size) : ptr(data), len(size) {}
 
-    struct HeaderItem
+    const char* data() const { return ptr; }
+    size_t size() const { return len; }
+    bool empty() const { return len == 0; }
+
+    const char* begin() const { return ptr; }
+    const char* end() const { return ptr + len; }
+
+    char operator[](size_t i) const { return ptr[i]; }
+
+    std::string str() const { return std::string(ptr, len); }
+
+    // Grow the slice by `n` bytes that directly follow it in the same buffer.
+    // An empty slice starts at `p`.
+    void extend(const char* p, size_t n)
     {
-        std::string name;
-        std::string value;
-    };
+        if (len == 0)
+            ptr = p;
 
-    std::string method;
-    std::string uri;
-    int versionMajor;
-    int versionMinor;
-    std::vector<HeaderItem> headers;
-    std::vector<char> content;
-    bool keepAlive;
+        len += n;
+    }
 
-    std::string inspect() const
+    void clear()
     {
-        std::stringstream stream;
-        stream << method << " " << uri << " HTTP/" << versionMajor << "." << versionMinor << "\n";
+        ptr = NULL;
+        len = 0;
+    }
+
+    bool operator==(const char* str) const { return strlen(str) == len && memcmp(ptr, str, len) == 0; }
+    bool operator!=(const char* str) const { return !(*this == str); }
 
-        for (std::vector<Request::HeaderItem>::const_iterator it = headers.begin(); it != headers.end(); ++it)
+private:
+    const char* ptr;
+    size_t len;
+};
+
+inline std::ostream& operator<<(std::ostream& stream, const Slice& slice)
+{
+    return stream.write(slice.data(), static_cast<std::streamsize>(slice.size()));
+}
+
+}  // namespace httpparser
+
+#endif  // HTTPPARSER_SLICE_H
+
+namespace httpparser
+{
+
+// Monotonic byte storage for the fields of one message at a time. Bytes are handed out from
+// a list of blocks and are only released all at once by reset(), which keeps the blocks for
+// the next message. After the first few messages on a connection nothing is allocated anymore.
+//
+// Fields are built one after another: append() only grows the most recently started slice.
+// A slice that outgrows its block moves to the next one, so every slice stays contiguous.
+class Arena
+{
+public:
+    explicit Arena(size_t blockSize = 4096) : head(NULL), current(NULL), used(0), blockSize(blockSize) {}
+
+    ~Arena()
+    {
+        while (head)
         {
-            stream << it->name << ": " << it->value << "\n";
+            Block* next = head->next;
+            ::operator delete(head);
+            head = next;
         }
+    }
 
-        std::string data(content.begin(), content.end());
-        stream << data << "\n";
-        stream << "+ keep-alive: " << keepAlive << "\n";
-        ;
-        return stream.str();
+    // Append [p, p + n) to `s`, which is either empty or the last slice appended to.
+    void append(Slice& s, const char* p, size_t n)
+    {
+        assert(s.empty() || s.end() == top());
+
+        if (n == 0)
+            return;
+
+        if (available() < n)
+            moveToNextBlock(s, s.size() + n);
+
+        char* dst = top();
+        memcpy(dst, p, n);
+        used += n;
+
+        s = Slice(s.empty() ? dst : s.data(), s.size() + n);
     }
 
-    struct Response
+    // Append to the last slice of `v` if it is the last one appended to, or start a new slice.
+    void append(std::vector<Slice>& v, const char* p, size_t n)
     {
-        Response() : versionMajor(0), versionMinor(0), keepAlive(false), statusCode(0) {}
+        if (v.empty() || v.back().end() != top())
+            v.push_back(Slice());
 
-        struct HeaderItem
-        {
-            std::string name;
-            std::string value;
-        };
+        append(v.back(), p, n);
+    }
+
+    // Release every slice at once. The blocks are kept for reuse.
+    void reset()
+    {
+        current = head;
+        used    = 0;
+    }
+
+    // Total size of the blocks.
+    size_t capacity() const
+    {
+        size_t result = 0;
+
+        for (Block* b = head; b; b = b->next)
+            result += b->size;
 
-        int versionMajor;
-        int versionMinor;
-        std::vector<HeaderItem> headers;
-        std::vector<char> content;
-        bool keepAlive;
+        return result;
+    }
+
+private:
+    Arena(const Arena&);
+    Arena& operator=(const Arena&);
+
+    struct Block
+    {
+        Block* next;
+        size_t size;
+
+        char* data() { return reinterpret_cast<char*>(this + 1); }
+    };
+
+    char* top() const { return current ? current->data() + used : NULL; }
+
+    size_t available() const { return current ? current->size - used : 0; }
 
-        unsigned int statusCode;
-        std::string status;
+    // Continue in a block with room for `size` bytes, taking along the bytes of `s` built so far.
+    void moveToNextBlock(Slice& s, size_t size)
+    {
+        Block* next = current ? current->next : head;
 
-        std::string inspect() const
+        if (!next || next->size < size)
         {
-            std::stringstream stream;
-            stream << "HTTP/" << versionMajor << "." << versionMinor << " " << statusCode << " " << status << "\n";
+            size_t n = std::max(blockSize, 2 * size);
 
-            for (std::vector<Response::HeaderItem>::const_iterator it = headers.begin(); it != headers.end(); ++it)
-            {
-                stream << it->name << ": " << it->value << "\n";
-            }
+            Block* b = static_cast<Block*>(::operator new(sizeof(Block) + n));
+            b->next  = next;
+            b->size  = n;
+
+            if (current)
+                current->next = b;
+            else
+                head = b;
 
-            std::string data(content.begin(), content.end());
-            stream << data << "\n";
-            return stream.str();
+            next = b;
         }
+
+        if (!s.empty())
+            memcpy(next->data(), s.data(), s.size());
+
+        current = next;
+        used    = s.size();
+        s       = s.empty() ? Slice() : Slice(current->data(), s.size());
+    }
+
+    Block* head;
+    Block* current;
+    // Bytes taken from the current block.
+    size_t used;
+    size_t blockSize;
+};
+
+}  // namespace httpparser
+
+#endif  // HTTPPARSER_ARENA_H
+#ifndef HTTPPARSER_REQUESTVIEW_H
+#define HTTPPARSER_REQUESTVIEW_H
+
+#include <string>
+#include <vector>
+
+#ifndef HTTPPARSER_HEADERINDEX_H
+#define HTTPPARSER_HEADERINDEX_H
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifndef HTTPPARSER_CHARTABLE_H
+#define HTTPPARSER_CHARTABLE_H
+
+#include <stddef.h>
+
+namespace httpparser
+{
+
+// Character classes of the HTTP and URL grammar, one bit per class.
+enum CharClass
+{
+    CharToken      = 0x01,  // tchar (RFC 7230): methods, header names, chunk extensions
+    CharText       = 0x02,  // anything but a control character: URIs, header values, reason phrases
+    CharDigit      = 0x04,
+    CharHex        = 0x08,
+    CharAlnum      = 0x10,
+    CharUnreserved = 0x20,  // unreserved (RFC 3986): ALPHA / DIGIT / "-" / "." / "_" / "~"
+    CharScheme     = 0x40   // ALPHA / DIGIT / "+" / "-" / "."
+};
+
+// Classes of every byte value, indexed by the unsigned byte. Unlike <cctype> the result does not
+// depend on the locale. The table is a static member of a class template, so that it can be
+// defined in a header.
+template <typename T = void>
+struct BasicCharTable
+{
+    static constexpr unsigned char flags[256] = {
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // 0x00
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // 0x10
+        0x02, 0x03, 0x02, 0x03, 0x03, 0x03, 0x03, 0x03, 0x02, 0x02, 0x03, 0x43, 0x02, 0x63, 0x63, 0x02,  // 0x20
+        0x7f, 0x7f, 0x7f, 0x7f, 0x7f, 0x7f, 0x7f, 0x7f, 0x7f, 0x7f, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,  // 0x30
+        0x02, 0x7b, 0x7b, 0x7b, 0x7b, 0x7b, 0x7b, 0x73, 0x73, 0x73, 0x73, 0x73, 0x73, 0x73, 0x73, 0x73,  // 0x40
+        0x73, 0x73, 0x73, 0x73, 0x73, 0x73, 0x73, 0x73, 0x73, 0x73, 0x73, 0x02, 0x02, 0x02, 0x03, 0x23,  // 0x50
+        0x03, 0x7b, 0x7b, 0x7b, 0x7b, 0x7b, 0x7b, 0x73, 0x73, 0x73, 0x73, 0x73, 0x73, 0x73, 0x73, 0x73,  // 0x60
+        0x73, 0x73, 0x73, 0x73, 0x73, 0x73, 0x73, 0x73, 0x73, 0x73, 0x73, 0x02, 0x03, 0x02, 0x23, 0x00,  // 0x70
+        0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,  // 0x80
+        0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,  // 0x90
+        0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,  // 0xa0
+        0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,  // 0xb0
+        0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,  // 0xc0
+        0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,  // 0xd0
+        0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,  // 0xe0
+        0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02   // 0xf0
     };
+};
+
+template <typename T>
+constexpr unsigned char BasicCharTable<T>::flags[256];
+
+typedef BasicCharTable<> CharTable;
+
+inline bool isCharClass(char c, unsigned char charClass)
+{
+    return (CharTable::flags[static_cast<unsigned char>(c)] & charClass) != 0;
+}
+
+inline bool isToken(char c) { return isCharClass(c, CharToken); }
+inline bool isText(char c) { return isCharClass(c, CharText); }
+inline bool isDigit(char c) { return isCharClass(c, CharDigit); }
+inline bool isHexDigit(char c) { return isCharClass(c, CharHex); }
+inline bool isAlnum(char c) { return isCharClass(c, CharAlnum); }
+inline bool isUnreserved(char c) { return isCharClass(c, CharUnreserved); }
+inline bool isSchemeChar(char c) { return isCharClass(c, CharScheme); }
+
+// reason-phrase (RFC 9112): text and HTAB.
+inline bool isPhraseChar(char c) { return c == '\t' || isText(c); }
 
-    class HttpRequestParser
+// ASCII lowercase, independent of the locale.
+inline char toLower(char c) { return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c; }
+
+// Value of a hex digit.
+inline unsigned int hexValue(char c)
+{
+    return isDigit(c) ? static_cast<unsigned int>(c - '0') : static_cast<unsigned int>(toLower(c) - 'a' + 10);
+}
+
+inline bool equalsIgnoreCase(const char* a, const char* b, size_t size)
+{
+    for (size_t i = 0; i < size; ++i)
     {
-    public:
-        HttpRequestParser() : state(RequestMethodStart), contentSize(0), chunkSize(0), chunked(false) {}
+        if (toLower(a[i]) != toLower(b[i]))
+            return false;
+    }
+
+    return true;
+}
+
+}  // namespace httpparser
+
+#endif  // HTTPPARSER_CHARTABLE_H
+#ifndef HTTPPARSER_HEADERID_H
+#define HTTPPARSER_HEADERID_H
+
+#include <string>
+
+#include <stddef.h>
+#include <string.h>
+
+
+namespace httpparser
+{
+
+// Well-known header names. The parser classifies every header name it reads, so the framing
+// headers need no string comparison and applications can switch on the ID.
+enum HeaderId
+{
+    HeaderUnknown,
+    HeaderAccept,
+    HeaderAcceptCharset,
+    HeaderAcceptEncoding,
+    HeaderAcceptLanguage,
+    HeaderAcceptRanges,
+    HeaderAge,
+    HeaderAllow,
+    HeaderAuthorization,
+    HeaderCacheControl,
+    HeaderConnection,
+    HeaderContentDisposition,
+    HeaderContentEncoding,
+    HeaderContentLanguage,
+    HeaderContentLength,
+    HeaderContentLocation,
+    HeaderContentRange,
+    HeaderContentType,
+    HeaderCookie,
+    HeaderDate,
+    HeaderEtag,
+    HeaderExpect,
+    HeaderExpires,
+    HeaderForwarded,
+    HeaderHost,
+    HeaderIfMatch,
+    HeaderIfModifiedSince,
+    HeaderIfNoneMatch,
+    HeaderIfRange,
+    HeaderIfUnmodifiedSince,
+    HeaderKeepAlive,
+    HeaderLastModified,
+    HeaderLink,
+    HeaderLocation,
+    HeaderOrigin,
+    HeaderPragma,
+    HeaderProxyAuthenticate,
+    HeaderProxyAuthorization,
+    HeaderRange,
+    HeaderReferer,
+    HeaderRetryAfter,
+    HeaderServer,
+    HeaderSetCookie,
+    HeaderTe,
+    HeaderTrailer,
+    HeaderTransferEncoding,
+    HeaderUpgrade,
+    HeaderUserAgent,
+    HeaderVary,
+    HeaderVia,
+    HeaderWwwAuthenticate,
+    HeaderXForwardedFor,
+    HeaderXForwardedProto,
+    HeaderXRealIp,
+    HeaderXRequestedWith,
+
+    HeaderIdCount
+};
+
+// Perfect hash of the names above: the first, middle and last byte (lowercased) and the length
+// map every well-known name to its own slot. Other names may share a slot and are told apart by
+// a case-insensitive compare.
+constexpr unsigned int headerHash(const char* name, size_t size)
+{
+    return static_cast<unsigned int>(((static_cast<unsigned char>(name[0]) | 0x20) * 90u
+                                      + (static_cast<unsigned char>(name[size / 2]) | 0x20) * 68u
+                                      + (static_cast<unsigned char>(name[size - 1]) | 0x20) * 83u + size * 59u)
+                                     % 128u);
+}
+
+template <typename T = void>
+struct BasicHeaderTable
+{
+    // Canonical spelling, indexed by HeaderId.
+    static constexpr const char* names[HeaderIdCount] = {
+        "",
+        "Accept",
+        "Accept-Charset",
+        "Accept-Encoding",
+        "Accept-Language",
+        "Accept-Ranges",
+        "Age",
+        "Allow",
+        "Authorization",
+        "Cache-Control",
+        "Connection",
+        "Content-Disposition",
+        "Content-Encoding",
+        "Content-Language",
+        "Content-Length",
+        "Content-Location",
+        "Content-Range",
+        "Content-Type",
+        "Cookie",
+        "Date",
+        "ETag",
+        "Expect",
+        "Expires",
+        "Forwarded",
+        "Host",
+        "If-Match",
+        "If-Modified-Since",
+        "If-None-Match",
+        "If-Range",
+        "If-Unmodified-Since",
+        "Keep-Alive",
+        "Last-Modified",
+        "Link",
+        "Location",
+        "Origin",
+        "Pragma",
+        "Proxy-Authenticate",
+        "Proxy-Authorization",
+        "Range",
+        "Referer",
+        "Retry-After",
+        "Server",
+        "Set-Cookie",
+        "TE",
+        "Trailer",
+        "Transfer-Encoding",
+        "Upgrade",
+        "User-Agent",
+        "Vary",
+        "Via",
+        "WWW-Authenticate",
+        "X-Forwarded-For",
+        "X-Forwarded-Proto",
+        "X-Real-IP",
+        "X-Requested-With",
+    };
+
+    // HeaderId of the name that hashes to each slot.
+    static constexpr unsigned char slots[128] = {
+         0,  0,  0,  0, 49,  0,  7, 40,  0,  0,  0, 37, 45,  0,  0,  0,
+         0, 35, 10,  0,  0,  0,  0, 20,  0, 50,  0,  0,  0,  9, 41, 23,
+         0, 17, 29, 19, 24,  0,  0,  8, 52,  0,  0,  0,  0,  0,  0,  0,
+         0,  0, 38,  0, 14,  0,  0, 12,  0,  0,  0,  0,  2, 11, 25, 44,
+         0,  0,  0,  0,  0, 28, 46,  0,  3,  0, 33,  0, 22, 32,  0,  0,
+        47, 43,  0,  0, 21,  0,  5, 53, 15,  0,  0, 18, 16,  0,  0, 31,
+         0,  0,  0, 51,  0, 36,  6,  0, 54,  0,  0, 48,  1, 13, 34, 30,
+         0,  0,  0,  0,  0, 27,  0, 42, 26,  0,  0, 39,  0,  0,  4,  0
+    };
+};
+
+template <typename T>
+constexpr const char* BasicHeaderTable<T>::names[HeaderIdCount];
+
+template <typename T>
+constexpr unsigned char BasicHeaderTable<T>::slots[128];
+
+typedef BasicHeaderTable<> HeaderTable;
+
+// The slots are computed by hand: check at compile time that every well-known name hashes to
+// the slot holding its ID, and that no slot holds a name hashing elsewhere.
+constexpr size_t headerNameLength(const char* name) { return *name ? 1 + headerNameLength(name + 1) : 0; }
+
+constexpr unsigned int headerSlot(unsigned int id)
+{
+    return headerHash(HeaderTable::names[id], headerNameLength(HeaderTable::names[id]));
+}
+
+constexpr bool headerNamesInTheirSlots(unsigned int id = HeaderUnknown + 1)
+{
+    return id == HeaderIdCount || (HeaderTable::slots[headerSlot(id)] == id && headerNamesInTheirSlots(id + 1));
+}
+
+constexpr bool headerSlotsHoldTheirNames(unsigned int slot = 0)
+{
+    return slot == 128
+           || ((HeaderTable::slots[slot] == HeaderUnknown || headerSlot(HeaderTable::slots[slot]) == slot)
+               && headerSlotsHoldTheirNames(slot + 1));
+}
+
+static_assert(headerNamesInTheirSlots(), "HeaderTable::slots does not match headerHash()");
+static_assert(headerSlotsHoldTheirNames(), "HeaderTable::slots holds a name in the wrong slot");
+
+// Canonical name of a header ID, an empty string for HeaderUnknown.
+inline const char* headerName(HeaderId id) { return HeaderTable::names[id]; }
+
+// Classify a header name, ignoring case.
+inline HeaderId headerId(const char* name, size_t size)
+{
+    if (size == 0)
+        return HeaderUnknown;
+
+    HeaderId id           = static_cast<HeaderId>(HeaderTable::slots[headerHash(name, size)]);
+    const char* candidate = HeaderTable::names[id];
+
+    return strlen(candidate) == size && equalsIgnoreCase(name, candidate, size) ? id : HeaderUnknown;
+}
+
+inline HeaderId headerId(const std::string& name) { return headerId(name.data(), name.size()); }
+
+}  // namespace httpparser
+
+#endif  // HTTPPARSER_HEADERID_H
+
+namespace httpparser
+{
+
+// The name to look up with Request::header(), has() and findAll(): a C string, a std::string or
+// a HeaderId. Well-known names are matched by ID, others by a case-insensitive compare.
+class HeaderKey
+{
+public:
+    HeaderKey(const char* name) : name(name), size(strlen(name)), id(headerId(name, size)) {}
+    HeaderKey(const std::string& name) : name(name.data()), size(name.size()), id(headerId(name)) {}
+    HeaderKey(HeaderId id) : name(headerName(id)), size(strlen(name)), id(id) {}
+
+    // FNV-1a of the lowercased name.
+    static uint32_t hash(const char* p, size_t n)
+    {
+        uint32_t h = 2166136261u;
+
+        for (size_t i = 0; i < n; ++i)
+            h = (h ^ static_cast<unsigned char>(toLower(p[i]))) * 16777619u;
+
+        return h;
+    }
+
+    uint32_t hash() const { return hash(name, size); }
+
+    template <typename Item>
+    bool matches(const Item& item) const
+    {
+        if (id != HeaderUnknown && item.id != HeaderUnknown)
+            return id == item.id;
+
+        return item.name.size() == size && equalsIgnoreCase(item.name.data(), name, size);
+    }
+
+private:
+    const char* name;
+    size_t size;
+    HeaderId id;
+};
+
+// Open-addressing table from header names to positions in a header vector. Each slot holds the
+// first and the last header of one name; the headers of the same name are chained in `next`.
+//
+// The index covers the first size() headers and is only valid until they change: call build()
+// again after any edit. Lookups notice headers added or removed since and scan them linearly,
+// but a header renamed in place goes unnoticed.
+template <typename Alloc = std::allocator<char> >
+class BasicHeaderIndex
+{
+public:
+    explicit BasicHeaderIndex(const Alloc& alloc = Alloc()) : slots(alloc), next(alloc) {}
+
+    static const size_t npos = static_cast<size_t>(-1);
+
+    // Number of headers covered.
+    size_t size() const { return next.size(); }
+
+    // Forget all headers, keeping the capacity.
+    void clear()
+    {
+        std::fill(slots.begin(), slots.end(), Slot());
+        next.clear();
+    }
+
+    // Index all of `headers` from scratch.
+    template <typename Headers>
+    void build(const Headers& headers)
+    {
+        size_t capacity = std::max<size_t>(slots.size(), 16);
+
+        while (capacity < 2 * headers.size())
+            capacity *= 2;
+
+        if (capacity != slots.size())
+            slots.resize(capacity);
+
+        clear();
+        next.reserve(headers.size());
+        for (size_t i = 0; i < headers.size(); ++i)
+            insert(headers, i);
+    }
+
+    // Position of the first header matching `key`, or npos.
+    template <typename Headers>
+    size_t find(const Headers& headers, const HeaderKey& key) const
+    {
+        if (next.size() != headers.size())
+        {
+            for (size_t i = 0; i < headers.size(); ++i)
+            {
+                if (key.matches(headers[i]))
+                    return i;
+            }
+
+            return npos;
+        }
+
+        if (slots.empty())
+            return npos;
+
+        uint32_t hash = key.hash();
+        size_t mask   = slots.size() - 1;
 
-        enum ParseResult
+        for (size_t i = hash & mask; slots[i].first != 0; i = (i + 1) & mask)
         {
-            ParsingCompleted,
-            ParsingIncompleted,
-            ParsingError
-        };
+            if (slots[i].hash == hash && key.matches(headers[slots[i].first - 1]))
+                return slots[i].first - 1;
+        }
 
-        ParseResult parse(Request& req, const char* begin, const char* end) { return consume(req, begin, end); }
+        return npos;
+    }
 
-    private:
-        static bool checkIfConnection(const Request::HeaderItem& item)
+    // Position of the next header after `pos` with the same name, or npos.
+    template <typename Headers>
+    size_t findNext(const Headers& headers, const HeaderKey& key, size_t pos) const
+    {
+        if (next.size() == headers.size())
+            return next[pos] == 0 ? npos : next[pos] - 1;
+
+        for (size_t i = pos + 1; i < headers.size(); ++i)
         {
-            return strcasecmp(item.name.c_str(), "Connection") == 0;
+            if (key.matches(headers[i]))
+                return i;
         }
 
-        ParseResult consume(Request& req, const char* begin, const char* end)
+        return npos;
+    }
+
+private:
+    struct Slot
+    {
+        Slot() : hash(0), first(0), last(0) {}
+
+        uint32_t hash;
+        // Positions plus one, zero marks an empty slot or the end of a chain.
+        uint32_t first;
+        uint32_t last;
+    };
+
+    template <typename Headers>
+    void insert(const Headers& headers, size_t pos)
+    {
+        const typename Headers::value_type& item = headers[pos];
+
+        uint32_t hash = HeaderKey::hash(item.name.data(), item.name.size());
+        size_t mask   = slots.size() - 1;
+        size_t i      = hash & mask;
+
+        next.push_back(0);
+
+        for (; slots[i].first != 0; i = (i + 1) & mask)
         {
-            while (begin != end)
+            const typename Headers::value_type& other = headers[slots[i].first - 1];
+
+            if (slots[i].hash == hash && other.name.size() == item.name.size()
+                && equalsIgnoreCase(other.name.data(), item.name.data(), item.name.size()))
             {
-                char input = *begin++;
+                next[slots[i].last - 1] = static_cast<uint32_t>(pos + 1);
+                slots[i].last           = static_cast<uint32_t>(pos + 1);
+                return;
+            }
+        }
 
-                switch (state)
-                {
-                case RequestMethodStart:
-                    if (!isChar(input) || isControl(input) || isSpecial(input))
-                    {
-                        return ParsingError;
-                    }
-                    else
-                    {
-                        state = RequestMethod;
-                        req.method.push_back(input);
-                    }
-                    break;
-                case RequestMethod:
-                    if (input == ' ')
-                    {
-                        state = RequestUriStart;
-                    }
-                    else if (!isChar(input) || isControl(input) || isSpecial(input))
-                    {
-                        return ParsingError;
-                    }
-                    else
-                    {
-                        req.method.push_back(input);
-                    }
-                    break;
-                case RequestUriStart:
-                    if (isControl(input))
-                    {
-                        return ParsingError;
-                    }
-                    else
-                    {
-                        state = RequestUri;
-                        req.uri.push_back(input);
-                    }
-                    break;
-                case RequestUri:
-                    if (input == ' ')
-                    {
-                        state = RequestHttpVersion_h;
-                    }
-                    else if (input == '\r')
-                    {
-                        req.versionMajor = 0;
-                        req.versionMinor = 9;
+        slots[i].hash  = hash;
+        slots[i].first = static_cast<uint32_t>(pos + 1);
+        slots[i].last  = static_cast<uint32_t>(pos + 1);
+    }
 
-                        return ParsingCompleted;
-                    }
-                    else if (isControl(input))
-                    {
-                        return ParsingError;
-                    }
-                    else
-                    {
-                        req.uri.push_back(input);
-                    }
-                    break;
-                case RequestHttpVersion_h:
-                    if (input == 'H')
-                    {
-                        state = RequestHttpVersion_ht;
-                    }
-                    else
-                    {
-                        return ParsingError;
-                    }
-                    break;
-                case RequestHttpVersion_ht:
-                    if (input == 'T')
-                    {
-                        state = RequestHttpVersion_htt;
-                    }
-                    else
-                    {
-                        return ParsingError;
-                    }
-                    break;
-                case RequestHttpVersion_htt:
-                    if (input == 'T')
-                    {
-                        state = RequestHttpVersion_http;
-                    }
-                    else
-                    {
-                        return ParsingError;
-                    }
-                    break;
-                case RequestHttpVersion_http:
-                    if (input == 'P')
-                    {
-                        state = RequestHttpVersion_slash;
-                    }
-                    else
-                    {
-                        return ParsingError;
-                    }
-                    break;
-                case RequestHttpVersion_slash:
-                    if (input == '/')
-                    {
-                        req.versionMajor = 0;
-                        req.versionMinor = 0;
-                        state            = RequestHttpVersion_majorStart;
-                    }
-                    else
-                    {
-                        return ParsingError;
-                    }
-                    break;
-                case RequestHttpVersion_majorStart:
-                    if (isDigit(input))
-                    {
-                        req.versionMajor = input - '0';
-                        state            = RequestHttpVersion_major;
-                    }
-                    else
-                    {
-                        return ParsingError;
-                    }
-                    break;
-                case RequestHttpVersion_major:
-                    if (input == '.')
-                    {
-                        state = RequestHttpVersion_minorStart;
-                    }
-                    else if (isDigit(input))
-                    {
-                        req.versionMajor = req.versionMajor * 10 + input - '0';
-                    }
-                    else
-                    {
-                        return ParsingError;
-                    }
-                    break;
-                case RequestHttpVersion_minorStart:
-                    if (isDigit(input))
-                    {
-                        req.versionMinor = input - '0';
-                        state            = RequestHttpVersion_minor;
-                    }
-                    else
-                    {
-                        return ParsingError;
-                    }
-                    break;
-                case RequestHttpVersion_minor:
-                    if (input == '\r')
-                    {
-                        state = ResponseHttpVersion_newLine;
-                    }
-                    else if (isDigit(input))
-                    {
-                        req.versionMinor = req.versionMinor * 10 + input - '0';
-                    }
-                    else
-                    {
-                        return ParsingError;
-                    }
-                    break;
-                case ResponseHttpVersion_newLine:
-                    if (input == '\n')
-                    {
-                        state = HeaderLineStart;
-                    }
-                    else
-                    {
-                        return ParsingError;
-                    }
-                    break;
-                case HeaderLineStart:
-                    if (input == '\r')
-                    {
-                        state = ExpectingNewline_3;
-                    }
-                    else if (!req.headers.empty() && (input == ' ' || input == '\t'))
-                    {
-                        state = HeaderLws;
-                    }
-                    else if (!isChar(input) || isControl(input) || isSpecial(input))
-                    {
-                        return ParsingError;
-                    }
-                    else
-                    {
-                        req.headers.push_back(Request::HeaderItem());
-                        req.headers.back().name.reserve(16);
-                        req.headers.back().value.reserve(16);
-                        req.headers.back().name.push_back(input);
-                        state = HeaderName;
-                    }
-                    break;
-                case HeaderLws:
-                    if (input == '\r')
-                    {
-                        state = ExpectingNewline_2;
-                    }
-                    else if (input == ' ' || input == '\t')
-                    {
-                    }
-                    else if (isControl(input))
-                    {
-                        return ParsingError;
-                    }
-                    else
-                    {
-                        state = HeaderValue;
-                        req.headers.back().value.push_back(input);
-                    }
-                    break;
-                case HeaderName:
-                    if (input == ':')
-                    {
-                        state = SpaceBeforeHeaderValue;
-                    }
-                    else if (!isChar(input) || isControl(input) || isSpecial(input))
-                    {
-                        return ParsingError;
-                    }
-                    else
-                    {
-                        req.headers.back().name.push_back(input);
-                    }
-                    break;
-                case SpaceBeforeHeaderValue:
-                    if (input == ' ')
-                    {
-                        state = HeaderValue;
-                    }
-                    else
-                    {
-                        return ParsingError;
-                    }
-                    break;
-                case HeaderValue:
-                    if (input == '\r')
-                    {
-                        if (req.method == "POST" || req.method == "PUT")
-                        {
-                            Request::HeaderItem& h = req.headers.back();
-
-                            if (strcasecmp(h.name.c_str(), "Content-Length") == 0)
-                            {
-                                contentSize = atoi(h.value.c_str());
-                                req.content.reserve(contentSize);
-                            }
-                            else if (strcasecmp(h.name.c_str(), "Transfer-Encoding") == 0)
-                            {
-                                if (strcasecmp(h.value.c_str(), "chunked") == 0)
-                                    chunked = true;
-                            }
-                        }
-                        state = ExpectingNewline_2;
-                    }
-                    else if (isControl(input))
-                    {
-                        return ParsingError;
-                    }
-                    else
-                    {
-                        req.headers.back().value.push_back(input);
-                    }
-                    break;
-                case ExpectingNewline_2:
-                    if (input == '\n')
-                    {
-                        state = HeaderLineStart;
-                    }
-                    else
-                    {
-                        return ParsingError;
-                    }
-                    break;
-                case ExpectingNewline_3:
-                {
-                    std::vector<Request::HeaderItem>::iterator it =
-                        std::find_if(req.headers.begin(), req.headers.end(), checkIfConnection);
+    typedef std::allocator_traits<Alloc> AllocatorTraits;
 
-                    if (it != req.headers.end())
-                    {
-                        if (strcasecmp(it->value.c_str(), "Keep-Alive") == 0)
-                        {
-                            req.keepAlive = true;
-                        }
-                        else  // == Close
-                        {
-                            req.keepAlive = false;
-                        }
-                    }
-                    else
-                    {
-                        if (req.versionMajor > 1 || (req.versionMajor == 1 && req.versionMinor == 1))
-                            req.keepAlive = true;
-                    }
+    std::vector<Slot, typename AllocatorTraits::template rebind_alloc<Slot> > slots;
+    std::vector<uint32_t, typename AllocatorTraits::template rebind_alloc<uint32_t> > next;
+};
 
-                    if (chunked)
-                    {
-                        state = ChunkSize;
-                    }
-                    else if (contentSize == 0)
-                    {
-                        if (input == '\n')
-                            return ParsingCompleted;
-                        else
-                            return ParsingError;
-                    }
-                    else
-                    {
-                        state = Post;
-                    }
-                    break;
-                }
-                case Post:
-                    --contentSize;
-                    req.content.push_back(input);
+template <typename Alloc>
+const size_t BasicHeaderIndex<Alloc>::npos;
 
-                    if (contentSize == 0)
-                    {
-                        return ParsingCompleted;
-                    }
-                    break;
-                case ChunkSize:
-                    if (isalnum(input))
-                    {
-                        chunkSizeStr.push_back(input);
-                    }
-                    else if (input == ';')
-                    {
-                        state = ChunkExtensionName;
-                    }
-                    else if (input == '\r')
-                    {
-                        state = ChunkSizeNewLine;
-                    }
-                    else
-                    {
-                        return ParsingError;
-                    }
-                    break;
-                case ChunkExtensionName:
-                    if (isalnum(input) || input == ' ')
-                    {
-                        // skip
-                    }
-                    else if (input == '=')
-                    {
-                        state = ChunkExtensionValue;
-                    }
-                    else if (input == '\r')
-                    {
-                        state = ChunkSizeNewLine;
-                    }
-                    else
-                    {
-                        return ParsingError;
-                    }
-                    break;
-                case ChunkExtensionValue:
-                    if (isalnum(input) || input == ' ')
-                    {
-                        // skip
-                    }
-                    else if (input == '\r')
-                    {
-                        state = ChunkSizeNewLine;
-                    }
-                    else
-                    {
-                        return ParsingError;
-                    }
-                    break;
-                case ChunkSizeNewLine:
-                    if (input == '\n')
-                    {
-                        chunkSize = strtol(chunkSizeStr.c_str(), NULL, 16);
-                        chunkSizeStr.clear();
-                        req.content.reserve(req.content.size() + chunkSize);
-
-                        if (chunkSize == 0)
-                            state = ChunkSizeNewLine_2;
-                        else
-                            state = ChunkData;
-                    }
-                    else
-                    {
-                        return ParsingError;
-                    }
-                    break;
-                case ChunkSizeNewLine_2:
-                    if (input == '\r')
-                    {
-                        state = ChunkSizeNewLine_3;
-                    }
-                    else if (isalpha(input))
-                    {
-                        state = ChunkTrailerName;
-                    }
-                    else
-                    {
-                        return ParsingError;
-                    }
-                    break;
-                case ChunkSizeNewLine_3:
-                    if (input == '\n')
-                    {
-                        return ParsingCompleted;
-                    }
-                    else
-                    {
-                        return ParsingError;
-                    }
-                    break;
-                case ChunkTrailerName:
-                    if (isalnum(input))
-                    {
-                        // skip
-                    }
-                    else if (input == ':')
-                    {
-                        state = ChunkTrailerValue;
-                    }
-                    else
-                    {
-                        return ParsingError;
-                    }
-                    break;
-                case ChunkTrailerValue:
-                    if (isalnum(input) || input == ' ')
-                    {
-                        // skip
-                    }
-                    else if (input == '\r')
-                    {
-                        state = ChunkSizeNewLine;
-                    }
-                    else
-                    {
-                        return ParsingError;
-                    }
-                    break;
-                case ChunkData:
-                    req.content.push_back(input);
+typedef BasicHeaderIndex<> HeaderIndex;
 
-                    if (--chunkSize == 0)
-                    {
-                        state = ChunkDataNewLine_1;
-                    }
-                    break;
-                case ChunkDataNewLine_1:
-                    if (input == '\r')
-                    {
-                        state = ChunkDataNewLine_2;
-                    }
-                    else
-                    {
-                        return ParsingError;
-                    }
-                    break;
-                case ChunkDataNewLine_2:
-                    if (input == '\n')
-                    {
-                        state = ChunkSize;
-                    }
-                    else
-                    {
-                        return ParsingError;
-                    }
-                    break;
-                default:
-                    return ParsingError;
-                }
-            }
+}  // namespace httpparser
 
-            return ParsingIncompleted;
-        }
+#endif  // HTTPPARSER_HEADERINDEX_H
+#ifndef HTTPPARSER_METHOD_H
+#define HTTPPARSER_METHOD_H
 
-        // Check if a byte is an HTTP character.
-        inline bool isChar(int c) { return c >= 0 && c <= 127; }
+#include <string>
 
-        // Check if a byte is an HTTP control character.
-        inline bool isControl(int c) { return (c >= 0 && c <= 31) || (c == 127); }
+#include <stddef.h>
+#include <string.h>
 
-        // Check if a byte is defined as an HTTP special character.
-        inline bool isSpecial(int c)
-        {
-            switch (c)
-            {
-            case '(':
-            case ')':
-            case '<':
-            case '>':
-            case '@':
-            case ',':
-            case ';':
-            case ':':
-            case '\\':
-            case '"':
-            case '/':
-            case '[':
-            case ']':
-            case '?':
-            case '=':
-            case '{':
-            case '}':
-            case ' ':
-            case '\t':
-                return true;
-            default:
-                return false;
-            }
-        }
+namespace httpparser
+{
 
-        // Check if a byte is a digit.
-        inline bool isDigit(int c) { return c >= '0' && c <= '9'; }
+// Request methods of RFC 9110 and RFC 5789. The parser classifies the method of every request;
+// extension methods are MethodUnknown and only available as text.
+enum Method
+{
+    MethodUnknown,
+    MethodGet,
+    MethodHead,
+    MethodPost,
+    MethodPut,
+    MethodDelete,
+    MethodConnect,
+    MethodOptions,
+    MethodTrace,
+    MethodPatch,
 
-        // The current state of the parser.
-        enum State
-        {
-            RequestMethodStart,
-            RequestMethod,
-            RequestUriStart,
-            RequestUri,
-            RequestHttpVersion_h,
-            RequestHttpVersion_ht,
-            RequestHttpVersion_htt,
-            RequestHttpVersion_http,
-            RequestHttpVersion_slash,
-            RequestHttpVersion_majorStart,
-            RequestHttpVersion_major,
-            RequestHttpVersion_minorStart,
-            RequestHttpVersion_minor,
-
-            ResponseStatusStart,
-            ResponseHttpVersion_ht,
-            ResponseHttpVersion_htt,
-            ResponseHttpVersion_http,
-            ResponseHttpVersion_slash,
-            ResponseHttpVersion_majorStart,
-            ResponseHttpVersion_major,
-            ResponseHttpVersion_minorStart,
-            ResponseHttpVersion_minor,
-            ResponseHttpVersion_spaceAfterVersion,
-            ResponseHttpVersion_statusCodeStart,
-            ResponseHttpVersion_spaceAfterStatusCode,
-            ResponseHttpVersion_statusTextStart,
-            ResponseHttpVersion_newLine,
-
-            HeaderLineStart,
-            HeaderLws,
-            HeaderName,
-            SpaceBeforeHeaderValue,
-            HeaderValue,
-            ExpectingNewline_2,
-            ExpectingNewline_3,
-
-            Post,
-            ChunkSize,
-            ChunkExtensionName,
-            ChunkExtensionValue,
-            ChunkSizeNewLine,
-            ChunkSizeNewLine_2,
-            ChunkSizeNewLine_3,
-            ChunkTrailerName,
-            ChunkTrailerValue,
-
-            ChunkDataNewLine_1,
-            ChunkDataNewLine_2,
-            ChunkData,
-        } state;
-
-        size_t contentSize;
-        std::string chunkSizeStr;
-        size_t chunkSize;
-        bool chunked;
-    };
+    MethodCount
+};
 
-    class HttpResponseParser
-    {
-    public:
-        HttpResponseParser() : state(ResponseStatusStart), contentSize(0), chunkSize(0), chunked(false) {}
+template <typename T = void>
+struct BasicMethodTable
+{
+    // Spelling, indexed by Method.
+    static constexpr const char* names[MethodCount] = {
+        "", "GET", "HEAD", "POST", "PUT", "DELETE", "CONNECT", "OPTIONS", "TRACE", "PATCH",
+    };
+};
+
+template <typename T>
+constexpr const char* BasicMethodTable<T>::names[MethodCount];
+
+typedef BasicMethodTable<> MethodTable;
+
+inline const char* methodName(Method method) { return MethodTable::names[method]; }
+
+// Classify a method token. Methods are case-sensitive, "get" is an extension method.
+inline Method methodId(const char* name, size_t size)
+{
+    for (int i = MethodUnknown + 1; i < MethodCount; ++i)
+    {
+        const char* candidate = MethodTable::names[i];
+
+        if (strlen(candidate) == size && memcmp(candidate, name, size) == 0)
+            return static_cast<Method>(i);
+    }
+
+    return MethodUnknown;
+}
+
+inline Method methodId(const std::string& name) { return methodId(name.data(), name.size()); }
+
+}  // namespace httpparser
+
+#endif  // HTTPPARSER_METHOD_H
+#ifndef HTTPPARSER_REQUEST_H
+#define HTTPPARSER_REQUEST_H
 
-        enum ParseResult
+#include <algorithm>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace httpparser
+{
+
+// Every string and vector of the message, and of the headers it hands out, uses a copy of the
+// allocator given to the constructor.
+template <typename Alloc = std::allocator<char> >
+struct BasicRequest
+{
+private:
+    typedef std::allocator_traits<Alloc> AllocatorTraits;
+
+public:
+    typedef Alloc allocator_type;
+    typedef std::basic_string<char, std::char_traits<char>, typename AllocatorTraits::template rebind_alloc<char> > String;
+
+    explicit BasicRequest(const Alloc& alloc = Alloc())
+        : method(alloc),
+          methodId(MethodUnknown),
+          uri(alloc),
+          versionMajor(0),
+          versionMinor(0),
+          headers(alloc),
+          content(alloc),
+          keepAlive(false),
+          headerPool(alloc),
+          index(alloc),
+          none(alloc)
+    {
+    }
+
+    struct HeaderItem
+    {
+        HeaderItem() : id(HeaderUnknown) {}
+        HeaderItem(const String& name, const String& value, HeaderId id = HeaderUnknown)
+            : name(name), value(value), id(id)
         {
-            ParsingCompleted,
-            ParsingIncompleted,
-            ParsingError
-        };
+        }
 
-        ParseResult parse(Response& resp, const char* begin, const char* end) { return consume(resp, begin, end); }
+        String name;
+        String value;
+        // Set by the parser, HeaderUnknown for a header added by hand.
+        HeaderId id;
+    };
 
-    private:
-        static bool checkIfConnection(const Response::HeaderItem& item)
+    String method;
+    // Set by the parser, MethodUnknown for an extension method.
+    Method methodId;
+    String uri;
+    int versionMajor;
+    int versionMinor;
+    std::vector<HeaderItem, typename AllocatorTraits::template rebind_alloc<HeaderItem> > headers;
+    std::vector<char, typename AllocatorTraits::template rebind_alloc<char> > content;
+    bool keepAlive;
+
+    // Append an empty header, reusing the storage of a header dropped by clear() if possible.
+    HeaderItem& addHeader()
+    {
+        if (headerPool.empty())
+        {
+            HeaderItem item = {String(none.get_allocator()), String(none.get_allocator()), HeaderUnknown};
+            headers.push_back(std::move(item));
+        }
+        else
         {
-            return strcasecmp(item.name.c_str(), "Connection") == 0;
+            headers.push_back(std::move(headerPool.back()));
+            headerPool.pop_back();
         }
 
-        ParseResult consume(Response& resp, const char* begin, const char* end)
+        return headers.back();
+    }
+
+    // Reset to the default-constructed state but keep all allocated capacity, including the
+    // storage of every header name and value, so the next message on a keep-alive connection
+    // does not need to allocate again.
+    void clear()
+    {
+        method.clear();
+        methodId = MethodUnknown;
+        uri.clear();
+        versionMajor = 0;
+        versionMinor = 0;
+        content.clear();
+        keepAlive = false;
+
+        for (size_t i = headers.size(); i-- > 0;)
         {
-            while (begin != end)
-            {
-                char input = *begin++;
+            headers[i].name.clear();
+            headers[i].value.clear();
+            headers[i].id = HeaderUnknown;
+            headerPool.push_back(std::move(headers[i]));
+        }
 
-                switch (state)
-                {
-                case ResponseStatusStart:
-                    if (input != 'H')
-                    {
-                        return ParsingError;
-                    }
-                    else
-                    {
-                        state = ResponseHttpVersion_ht;
-                    }
-                    break;
-                case ResponseHttpVersion_ht:
-                    if (input == 'T')
-                    {
-                        state = ResponseHttpVersion_htt;
-                    }
-                    else
-                    {
-                        return ParsingError;
-                    }
-                    break;
-                case ResponseHttpVersion_htt:
-                    if (input == 'T')
-                    {
-                        state = ResponseHttpVersion_http;
-                    }
-                    else
-                    {
-                        return ParsingError;
-                    }
-                    break;
-                case ResponseHttpVersion_http:
-                    if (input == 'P')
-                    {
-                        state = ResponseHttpVersion_slash;
-                    }
-                    else
-                    {
-                        return ParsingError;
-                    }
-                    break;
-                case ResponseHttpVersion_slash:
-                    if (input == '/')
-                    {
-                        resp.versionMajor = 0;
-                        resp.versionMinor = 0;
-                        state             = ResponseHttpVersion_majorStart;
-                    }
-                    else
-                    {
-                        return ParsingError;
-                    }
-                    break;
-                case ResponseHttpVersion_majorStart:
-                    if (isDigit(input))
-                    {
-                        resp.versionMajor = input - '0';
-                        state             = ResponseHttpVersion_major;
-                    }
-                    else
-                    {
-                        return ParsingError;
-                    }
-                    break;
-                case ResponseHttpVersion_major:
-                    if (input == '.')
-                    {
-                        state = ResponseHttpVersion_minorStart;
-                    }
-                    else if (isDigit(input))
-                    {
-                        resp.versionMajor = resp.versionMajor * 10 + input - '0';
-                    }
-                    else
-                    {
-                        return ParsingError;
-                    }
-                    break;
-                case ResponseHttpVersion_minorStart:
-                    if (isDigit(input))
-                    {
-                        resp.versionMinor = input - '0';
-                        state             = ResponseHttpVersion_minor;
-                    }
-                    else
-                    {
-                        return ParsingError;
-                    }
-                    break;
-                case ResponseHttpVersion_minor:
-                    if (input == ' ')
-                    {
-                        state           = ResponseHttpVersion_statusCodeStart;
-                        resp.statusCode = 0;
-                    }
-                    else if (isDigit(input))
-                    {
-                        resp.versionMinor = resp.versionMinor * 10 + input - '0';
-                    }
-                    else
-                    {
-                        return ParsingError;
-                    }
-                    break;
-                case ResponseHttpVersion_statusCodeStart:
-                    if (isDigit(input))
-                    {
-                        resp.statusCode = input - '0';
-                        state           = ResponseHttpVersion_statusCode;
-                    }
-                    else
-                    {
-                        return ParsingError;
-                    }
-                    break;
-                case ResponseHttpVersion_statusCode:
-                    if (isDigit(input))
-                    {
-                        resp.statusCode = resp.statusCode * 10 + input - '0';
-                    }
-                    else
-                    {
-                        if (resp.statusCode < 100 || resp.statusCode > 999)
-                        {
-                            return ParsingError;
-                        }
-                        else if (input == ' ')
-                        {
-                            state = ResponseHttpVersion_statusTextStart;
-                        }
-                        else
-                        {
-                            return ParsingError;
-                        }
-                    }
-                    break;
-                case ResponseHttpVersion_statusTextStart:
-                    if (isChar(input))
-                    {
-                        resp.status += input;
-                        state = ResponseHttpVersion_statusText;
-                    }
-                    else
-                    {
-                        return ParsingError;
-                    }
-                    break;
-                case ResponseHttpVersion_statusText:
-                    if (input == '\r')
-                    {
-                        state = ResponseHttpVersion_newLine;
-                    }
-                    else if (isChar(input))
-                    {
-                        resp.status += input;
-                    }
-                    else
-                    {
-                        return ParsingError;
-                    }
-                    break;
-                case ResponseHttpVersion_newLine:
-                    if (input == '\n')
-                    {
-                        state = HeaderLineStart;
-                    }
-                    else
-                    {
-                        return ParsingError;
-                    }
-                    break;
-                case HeaderLineStart:
-                    if (input == '\r')
-                    {
-                        state = ExpectingNewline_3;
-                    }
-                    else if (!resp.headers.empty() && (input == ' ' || input == '\t'))
-                    {
-                        state = HeaderLws;
-                    }
-                    else if (!isChar(input) || isControl(input) || isSpecial(input))
-                    {
-                        return ParsingError;
-                    }
-                    else
-                    {
-                        resp.headers.push_back(Response::HeaderItem());
-                        resp.headers.back().name.reserve(16);
-                        resp.headers.back().value.reserve(16);
-                        resp.headers.back().name.push_back(input);
-                        state = HeaderName;
-                    }
-                    break;
-                case HeaderLws:
-                    if (input == '\r')
-                    {
-                        state = ExpectingNewline_2;
-                    }
-                    else if (input == ' ' || input == '\t')
-                    {
-                    }
-                    else if (isControl(input))
-                    {
-                        return ParsingError;
-                    }
-                    else
-                    {
-                        state = HeaderValue;
-                        resp.headers.back().value.push_back(input);
-                    }
-                    break;
-                case HeaderName:
-                    if (input == ':')
-                    {
-                        state = SpaceBeforeHeaderValue;
-                    }
-                    else if (!isChar(input) || isControl(input) || isSpecial(input))
-                    {
-                        return ParsingError;
-                    }
-                    else
-                    {
-                        resp.headers.back().name.push_back(input);
-                    }
-                    break;
-                case SpaceBeforeHeaderValue:
-                    if (input == ' ')
-                    {
-                        state = HeaderValue;
-                    }
-                    else
-                    {
-                        return ParsingError;
-                    }
-                    break;
-                case HeaderValue:
-                    if (input == '\r')
-                    {
-                        Response::HeaderItem& h = resp.headers.back();
-
-                        if (strcasecmp(h.name.c_str(), "Content-Length") == 0)
-                        {
-                            contentSize = atoi(h.value.c_str());
-                            resp.content.reserve(contentSize);
-                        }
-                        else if (strcasecmp(h.name.c_str(), "Transfer-Encoding") == 0)
-                        {
-                            if (strcasecmp(h.value.c_str(), "chunked") == 0)
-                                chunked = true;
-                        }
-                        state = ExpectingNewline_2;
-                    }
-                    else if (isControl(input))
-                    {
-                        return ParsingError;
-                    }
-                    else
-                    {
-                        resp.headers.back().value.push_back(input);
-                    }
-                    break;
-                case ExpectingNewline_2:
-                    if (input == '\n')
-                    {
-                        state = HeaderLineStart;
-                    }
-                    else
-                    {
-                        return ParsingError;
-                    }
-                    break;
-                case ExpectingNewline_3:
-                {
-                    std::vector<Response::HeaderItem>::iterator it =
-                        std::find_if(resp.headers.begin(), resp.headers.end(), checkIfConnection);
+        headers.clear();
+        index.clear();
+    }
 
-                    if (it != resp.headers.end())
-                    {
-                        if (strcasecmp(it->value.c_str(), "Keep-Alive") == 0)
-                        {
-                            resp.keepAlive = true;
-                        }
-                        else  // == Close
-                        {
-                            resp.keepAlive = false;
-                        }
-                    }
-                    else
-                    {
-                        if (resp.versionMajor > 1 || (resp.versionMajor == 1 && resp.versionMinor == 1))
-                            resp.keepAlive = true;
-                    }
+    // Value of the first header called `key`, ignoring case, or an empty string if there is none.
+    const String& header(const HeaderKey& key) const
+    {
+        size_t pos = index.find(headers, key);
+        return pos == HeaderIndex::npos ? none : headers[pos].value;
+    }
 
-                    if (chunked)
-                    {
-                        state = ChunkSize;
-                    }
-                    else if (contentSize == 0)
-                    {
-                        if (input == '\n')
-                            return ParsingCompleted;
-                        else
-                            return ParsingError;
-                    }
+    bool has(const HeaderKey& key) const { return index.find(headers, key) != HeaderIndex::npos; }
 
-                    else
-                    {
-                        state = Post;
-                    }
-                    break;
-                }
-                case Post:
-                    --contentSize;
-                    resp.content.push_back(input);
+    // All headers called `key`, in the order of the message.
+    std::vector<const HeaderItem*> findAll(const HeaderKey& key) const
+    {
+        std::vector<const HeaderItem*> result;
 
-                    if (contentSize == 0)
-                    {
-                        return ParsingCompleted;
-                    }
-                    break;
-                case ChunkSize:
-                    if (isalnum(input))
-                    {
-                        chunkSizeStr.push_back(input);
-                    }
-                    else if (input == ';')
-                    {
-                        state = ChunkExtensionName;
-                    }
-                    else if (input == '\r')
-                    {
-                        state = ChunkSizeNewLine;
-                    }
-                    else
-                    {
-                        return ParsingError;
-                    }
-                    break;
-                case ChunkExtensionName:
-                    if (isalnum(input) || input == ' ')
-                    {
-                        // skip
-                    }
-                    else if (input == '=')
-                    {
-                        state = ChunkExtensionValue;
-                    }
-                    else if (input == '\r')
-                    {
-                        state = ChunkSizeNewLine;
-                    }
-                    else
-                    {
-                        return ParsingError;
-                    }
-                    break;
-                case ChunkExtensionValue:
-                    if (isalnum(input) || input == ' ')
-                    {
-                        // skip
-                    }
-                    else if (input == '\r')
-                    {
-                        state = ChunkSizeNewLine;
-                    }
-                    else
-                    {
+        for (size_t pos = index.find(headers, key); pos != HeaderIndex::npos; pos = index.findNext(headers, key, pos))
+            result.push_back(&headers[pos]);
+
+        return result;
+    }
+
+    // Index the headers for the lookups above. The parser does it when the headers are complete;
+    // call it again after any change to `headers`, renaming one in place included. The index does
+    // not see such changes, and the lookups may miss headers until then. A renamed header also
+    // needs the `id` of its new name, or HeaderUnknown.
+    void reindex() { index.build(headers); }
+
+    std::string inspect() const
+    {
+        std::stringstream stream;
+        stream << method << " " << uri << " HTTP/" << versionMajor << "." << versionMinor << "\n";
+
+        for (size_t i = 0; i < headers.size(); ++i)
+        {
+            stream << headers[i].name << ": " << headers[i].value << "\n";
+        }
+
+        std::string data(content.begin(), content.end());
+        stream << data << "\n";
+        stream << "+ keep-alive: " << keepAlive << "\n";
+        ;
+        return stream.str();
+    }
+
+private:
+    // Cleared headers kept for reuse, the next one to hand out is at the back.
+    std::vector<HeaderItem, typename AllocatorTraits::template rebind_alloc<HeaderItem> > headerPool;
+    BasicHeaderIndex<Alloc> index;
+    // Returned by header() for a missing header, and the source of the allocator for new headers.
+    String none;
+};
+
+typedef BasicRequest<> Request;
+
+}  // namespace httpparser
+
+#endif  // HTTPPARSER_REQUEST_H
+
+namespace httpparser
+{
+
+// Zero-copy counterpart of Request: every field is a slice of the buffer that was passed to
+// HttpRequestParser::parse(), nothing is copied.
+//
+// Buffer contract: all bytes of the message must live in one contiguous buffer which stays
+// alive and is not moved or modified while the view is in use. A message split across several
+// parse() calls is fine as long as each call continues exactly where the previous one stopped
+// in that same buffer. Call materialize() to get an owning Request that outlives the buffer.
+struct RequestView
+{
+    RequestView() : methodId(MethodUnknown), versionMajor(0), versionMinor(0), keepAlive(false) {}
+
+    struct HeaderItem
+    {
+        HeaderItem() : id(HeaderUnknown) {}
+
+        Slice name;
+        Slice value;
+        HeaderId id;
+    };
+
+    Slice method;
+    Method methodId;
+    Slice uri;
+    int versionMajor;
+    int versionMinor;
+    std::vector<HeaderItem> headers;
+    // One slice for a Content-Length body, one slice per chunk for a chunked body.
+    std::vector<Slice> content;
+    bool keepAlive;
+
+    HeaderItem& addHeader()
+    {
+        headers.push_back(HeaderItem());
+        return headers.back();
+    }
+
+    // Reset to the default-constructed state, keeping the capacity of the vectors.
+    void clear()
+    {
+        method.clear();
+        methodId = MethodUnknown;
+        uri.clear();
+        versionMajor = 0;
+        versionMinor = 0;
+        headers.clear();
+        index.clear();
+        content.clear();
+        keepAlive = false;
+    }
+
+    // Value of the first header called `key`, ignoring case, or an empty slice if there is none.
+    Slice header(const HeaderKey& key) const
+    {
+        size_t pos = index.find(headers, key);
+        return pos == HeaderIndex::npos ? Slice() : headers[pos].value;
+    }
+
+    bool has(const HeaderKey& key) const { return index.find(headers, key) != HeaderIndex::npos; }
+
+    // All headers called `key`, in the order of the message.
+    std::vector<const HeaderItem*> findAll(const HeaderKey& key) const
+    {
+        std::vector<const HeaderItem*> result;
+
+        for (size_t pos = index.find(headers, key); pos != HeaderIndex::npos; pos = index.findNext(headers, key, pos))
+            result.push_back(&headers[pos]);
+
+        return result;
+    }
+
+    // Index the headers for the lookups above. The parser does it when the headers are complete;
+    // call it again after any change to `headers`, renaming one in place included. The index does
+    // not see such changes, and the lookups may miss headers until then. A renamed header also
+    // needs the `id` of its new name, or HeaderUnknown.
+    void reindex() { index.build(headers); }
+
+    template <typename Alloc>
+    void materialize(BasicRequest<Alloc>& req) const
+    {
+        req.clear();
+        req.method.assign(method.data(), method.size());
+        req.methodId = methodId;
+        req.uri.assign(uri.data(), uri.size());
+        req.versionMajor = versionMajor;
+        req.versionMinor = versionMinor;
+        req.keepAlive    = keepAlive;
+
+        for (size_t i = 0; i < headers.size(); ++i)
+        {
+            req.addHeader().name.assign(headers[i].name.data(), headers[i].name.size());
+            req.headers.back().value.assign(headers[i].value.data(), headers[i].value.size());
+            req.headers.back().id = headers[i].id;
+        }
+
+        for (std::vector<Slice>::const_iterator it = content.begin(); it != content.end(); ++it)
+        {
+            req.content.insert(req.content.end(), it->begin(), it->end());
+        }
+
+        req.reindex();
+    }
+
+    Request materialize() const
+    {
+        Request req;
+        materialize(req);
+        return req;
+    }
+
+    std::string inspect() const { return materialize().inspect(); }
+
+private:
+    HeaderIndex index;
+};
+
+}  // namespace httpparser
+
+#endif  // HTTPPARSER_REQUESTVIEW_H
+
+namespace httpparser
+{
+
+// A RequestView whose slices point into an arena the request owns instead of into the parsed
+// buffer, so the buffer can be reused as soon as parse() returns. Keep one ArenaRequest per
+// connection and clear() it between messages: the text of the next message goes to the same
+// memory and the vectors keep their capacity, so a warmed-up connection does not allocate.
+//
+// The body is stored as a single slice.
+struct ArenaRequest : RequestView
+{
+    explicit ArenaRequest(size_t blockSize = 4096) : arena(blockSize) {}
+
+    void clear()
+    {
+        RequestView::clear();
+        arena.reset();
+    }
+
+    Arena arena;
+};
+
+}  // namespace httpparser
+
+#endif  // HTTPPARSER_ARENAREQUEST_H
+#ifndef HTTPPARSER_HTTPPARSERBASE_H
+#define HTTPPARSER_HTTPPARSERBASE_H
+
+#include <algorithm>
+
+#include <stdint.h>
+#include <string.h>
+
+#ifndef HTTPPARSER_HEADERCOMPLETE_H
+#define HTTPPARSER_HEADERCOMPLETE_H
+
+#include <stddef.h>
+
+#ifndef HTTPPARSER_SCAN_H
+#define HTTPPARSER_SCAN_H
+
+#include <string.h>
+
+
+// Vector scanners are built on x86 with GCC and Clang, which can compile SSE4.2 and AVX2
+// functions without -m flags and tell the CPU features at runtime. Define HTTPPARSER_NO_SIMD
+// to always use the portable loops.
+#if !defined(HTTPPARSER_NO_SIMD) && (defined(__GNUC__) || defined(__clang__)) \
+    && (defined(__x86_64__) || defined(__i386__))
+#define HTTPPARSER_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace httpparser
+{
+
+// Scanners for the long runs of header lines. Each one returns the first byte in [p, end) that
+// ends the run, or `end` if the run goes on past the buffer. The blankLine scanners return the
+// first "\r\n\r\n" that lies entirely in [p, end) instead.
+namespace scan
+{
+
+enum Level
+{
+    Scalar,
+    Sse42,
+    Avx2
+};
+
+// Portable versions.
+inline const char* tokenScalar(const char* p, const char* end)
+{
+    while (p != end && isToken(*p))
+        ++p;
+
+    return p;
+}
+
+inline const char* textScalar(const char* p, const char* end)
+{
+    while (p != end && isText(*p))
+        ++p;
+
+    return p;
+}
+
+inline const char* blankLineScalar(const char* p, const char* end)
+{
+    // Look at every LF that could end the blank line, memchr() skips the rest.
+    for (const char* lf = p + 3; lf < end; lf += 2)
+    {
+        lf = static_cast<const char*>(memchr(lf, '\n', end - lf));
+        if (!lf)
+            break;
+
+        if (lf[-1] == '\r' && lf[-2] == '\n' && lf[-3] == '\r')
+            return lf - 3;
+    }
+
+    return end;
+}
+
+#ifdef HTTPPARSER_SIMD_X86
+
+// The byte ranges that stop a run, for PCMPESTRI. Eight ranges cannot describe the token
+// delimiters exactly, so "{" to 0xff also stops at "|" and "~"; those are checked against the
+// table and skipped.
+__attribute__((target("sse4.2"))) inline const char* tokenSse42(const char* p, const char* end)
+{
+    static const char ranges[16] = {'\0', ' ', '"', '"', '(', ')', ',', ',', '/', '/', ':', '@', '[', ']', '{', '\xff'};
+    const __m128i r              = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ranges));
+
+    while (end - p >= 16)
+    {
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        int i     = _mm_cmpestri(r, 16, b, 16, _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_LEAST_SIGNIFICANT);
+
+        if (i == 16)
+        {
+            p += 16;
+        }
+        else
+        {
+            p += i;
+            if (!isToken(*p))
+                return p;
+            ++p;
+        }
+    }
+
+    return tokenScalar(p, end);
+}
+
+__attribute__((target("sse4.2"))) inline const char* textSse42(const char* p, const char* end)
+{
+    static const char ranges[16] = {'\0', '\x1f', '\x7f', '\x7f'};
+    const __m128i r              = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ranges));
+
+    while (end - p >= 16)
+    {
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        int i     = _mm_cmpestri(r, 4, b, 16, _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_LEAST_SIGNIFICANT);
+
+        if (i != 16)
+            return p + i;
+
+        p += 16;
+    }
+
+    return textScalar(p, end);
+}
+
+// A control byte is one that the unsigned minimum with 0x1f leaves unchanged.
+__attribute__((target("avx2"))) inline const char* textAvx2(const char* p, const char* end)
+{
+    const __m256i control = _mm256_set1_epi8(0x1f);
+    const __m256i del     = _mm256_set1_epi8(0x7f);
+
+    while (end - p >= 32)
+    {
+        __m256i b         = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i lo        = _mm256_cmpeq_epi8(_mm256_min_epu8(b, control), b);
+        __m256i hi        = _mm256_cmpeq_epi8(b, del);
+        unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_or_si256(lo, hi)));
+
+        if (mask != 0)
+            return p + __builtin_ctz(mask);
+
+        p += 32;
+    }
+
+    return textSse42(p, end);
+}
+
+// Compare 16 positions at once against each of the four bytes of "\r\n\r\n".
+__attribute__((target("sse2"))) inline const char* blankLineSse2(const char* p, const char* end)
+{
+    const __m128i cr = _mm_set1_epi8('\r');
+    const __m128i lf = _mm_set1_epi8('\n');
+
+    while (end - p >= 16 + 3)
+    {
+        __m128i b0        = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), cr);
+        __m128i b1        = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 1)), lf);
+        __m128i b2        = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 2)), cr);
+        __m128i b3        = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 3)), lf);
+        __m128i hit       = _mm_and_si128(_mm_and_si128(b0, b1), _mm_and_si128(b2, b3));
+        unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(hit));
+
+        if (mask != 0)
+            return p + __builtin_ctz(mask);
+
+        p += 16;
+    }
+
+    return blankLineScalar(p, end);
+}
+
+__attribute__((target("avx2"))) inline const char* blankLineAvx2(const char* p, const char* end)
+{
+    const __m256i cr = _mm256_set1_epi8('\r');
+    const __m256i lf = _mm256_set1_epi8('\n');
+
+    while (end - p >= 32 + 3)
+    {
+        __m256i b0        = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)), cr);
+        __m256i b1        = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 1)), lf);
+        __m256i b2        = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 2)), cr);
+        __m256i b3        = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 3)), lf);
+        __m256i hit       = _mm256_and_si256(_mm256_and_si256(b0, b1), _mm256_and_si256(b2, b3));
+        unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(hit));
+
+        if (mask != 0)
+            return p + __builtin_ctz(mask);
+
+        p += 32;
+    }
+
+    return blankLineSse2(p, end);
+}
+
+inline Level detectLevel()
+{
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2"))
+        return Avx2;
+    if (__builtin_cpu_supports("sse4.2"))
+        return Sse42;
+    return Scalar;
+}
+
+#else
+
+inline Level detectLevel() { return Scalar; }
+
+#endif  // HTTPPARSER_SIMD_X86
+
+// The best instruction set of this CPU, detected on first use.
+inline Level level()
+{
+    static const Level detected = detectLevel();
+    return detected;
+}
+
+// Find the end of a header name.
+inline const char* token(const char* p, const char* end)
+{
+#ifdef HTTPPARSER_SIMD_X86
+    if (level() != Scalar)
+        return tokenSse42(p, end);
+#endif
+    return tokenScalar(p, end);
+}
+
+// Find the end of a header value: the CR, or the control byte that makes it invalid.
+inline const char* text(const char* p, const char* end)
+{
+#ifdef HTTPPARSER_SIMD_X86
+    switch (level())
+    {
+    case Avx2:
+        return textAvx2(p, end);
+    case Sse42:
+        return textSse42(p, end);
+    default:
+        break;
+    }
+#endif
+    return textScalar(p, end);
+}
+
+// Find the blank line that ends the headers.
+inline const char* blankLine(const char* p, const char* end)
+{
+#ifdef HTTPPARSER_SIMD_X86
+    switch (level())
+    {
+    case Avx2:
+        return blankLineAvx2(p, end);
+    case Sse42:
+        return blankLineSse2(p, end);
+    default:
+        break;
+    }
+#endif
+    return blankLineScalar(p, end);
+}
+
+}  // namespace scan
+
+}  // namespace httpparser
+
+#endif  // HTTPPARSER_SCAN_H
+
+namespace httpparser
+{
+
+// Whether [begin, end), the bytes of a message received so far, holds the complete header block.
+// When data trickles in, call it on every read and run the parser once it returns true: the
+// parser then goes over the whole block in one call instead of resuming on every fragment.
+//
+// `scanned` carries the progress between calls on the same, growing buffer and must start at 0.
+// On success it is the size of the header block, the offset of the first body byte. Compare it
+// with ParserLimits::maxHeaderBytes to drop a peer that never finishes its headers.
+inline bool isHeaderComplete(const char* begin, const char* end, size_t& scanned)
+{
+    size_t size = end - begin;
+
+    if (scanned > size)
+        scanned = size;
+
+    const char* blank = scan::blankLine(begin + scanned, end);
+
+    if (blank != end)
+    {
+        scanned = blank + 4 - begin;
+        return true;
+    }
+
+    // The next call starts over the last three bytes, which may begin the blank line.
+    if (size > scanned + 3)
+        scanned = size - 3;
+
+    return false;
+}
+
+}  // namespace httpparser
+
+#endif  // HTTPPARSER_HEADERCOMPLETE_H
+#ifndef HTTPPARSER_HTTPHANDLER_H
+#define HTTPPARSER_HTTPHANDLER_H
+
+#include <string>
+#include <vector>
+
+#include <assert.h>
+#include <stddef.h>
+
+
+namespace httpparser
+{
+
+// Event interface of HttpRequestParser::parse(Handler&, ...) and HttpResponseParser::parse(Handler&, ...).
+//
+// The handler type is a template parameter of parse(), so the calls are resolved at compile time.
+// Derive from HttpHandler and hide only the callbacks you need. Returning false from a callback
+// stops parsing with ParsingError.
+//
+// Data callbacks receive slices of the buffer passed to parse(). A token split across several
+// parse() calls is reported in several fragments which must be concatenated; the pointers are
+// only valid during the callback unless the caller keeps the buffer alive.
+struct HttpHandler
+{
+    // Request line.
+    bool onMethod(const char*, size_t) { return true; }
+    // The method is complete: its well-known ID, or MethodUnknown.
+    bool onMethodId(Method) { return true; }
+    bool onUri(const char*, size_t) { return true; }
+
+    // Status line.
+    bool onStatusCode(unsigned int) { return true; }
+    bool onStatus(const char*, size_t) { return true; }
+
+    // HTTP version of the request or the status line.
+    bool onVersion(int /*major*/, int /*minor*/) { return true; }
+
+    // A new header line starts, the onHeaderField() and onHeaderValue() fragments that follow belong to it.
+    bool onHeaderBegin() { return true; }
+    bool onHeaderField(const char*, size_t) { return true; }
+    // The header name is complete: its well-known ID, or HeaderUnknown.
+    bool onHeaderId(HeaderId) { return true; }
+    bool onHeaderValue(const char*, size_t) { return true; }
+    bool onHeadersComplete(bool /*keepAlive*/) { return true; }
+
+    bool onBody(const char*, size_t) { return true; }
+    bool onMessageComplete() { return true; }
+
+protected:
+    // Store a fragment into a field of an owning or a view message.
+    template <typename Traits, typename Alloc>
+    static void append(std::basic_string<char, Traits, Alloc>& s, const char* p, size_t n)
+    {
+        s.append(p, n);
+    }
+
+    static void append(Slice& s, const char* p, size_t n)
+    {
+        // Views of one message share a single contiguous buffer, so a later fragment of the same
+        // field just moves the end. Anything between the fragments (an obs-fold) stays in the slice.
+        assert(s.empty() || s.end() <= p);
+
+        if (s.empty())
+            s = Slice(p, n);
+        else
+            s = Slice(s.data(), p + n - s.data());
+    }
+
+    template <typename Alloc>
+    static void append(std::vector<char, Alloc>& v, const char* p, size_t n)
+    {
+        v.insert(v.end(), p, p + n);
+    }
+
+    static void append(std::vector<Slice>& v, const char* p, size_t n)
+    {
+        if (v.empty() || v.back().end() != p)
+            v.push_back(Slice(p, n));
+        else
+            v.back().extend(p, n);
+    }
+
+    template <typename Traits, typename Alloc>
+    static void reserve(std::basic_string<char, Traits, Alloc>& s, size_t n)
+    {
+        s.reserve(n);
+    }
+
+    static void reserve(Slice&, size_t) {}
+};
+
+}  // namespace httpparser
+
+#endif  // HTTPPARSER_HTTPHANDLER_H
+#ifndef HTTPPARSER_PARSERLIMITS_H
+#define HTTPPARSER_PARSERLIMITS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace httpparser
+{
+
+// Upper bounds on what the parser accepts from the peer. A message that goes over one of them
+// stops with ParsingTooLarge before the offending bytes reach the handler, so the memory a
+// message can make the builders allocate is bounded by the limits rather than by the peer.
+struct ParserLimits
+{
+    ParserLimits()
+        : maxUriSize(8192), maxHeaderCount(100), maxHeaderBytes(64 * 1024), maxBodySize(UINT64_MAX)
+    {
+    }
+
+    // Length of the request target.
+    size_t maxUriSize;
+    // Number of header lines.
+    size_t maxHeaderCount;
+    // Size of the start line and the header lines: their tokens, line ends and folding whitespace.
+    size_t maxHeaderBytes;
+    // Content-Length, or the total of all chunks of a chunked body.
+    uint64_t maxBodySize;
+};
+
+}  // namespace httpparser
+
+#endif  // HTTPPARSER_PARSERLIMITS_H
+
+namespace httpparser
+{
+
+// The part of the HTTP/1.x state machine that requests and responses share: header lines,
+// Content-Length and chunked bodies. `Derived` only parses its start line, through
+//
+//   template <typename Handler>
+//   ParseResult consumeStartLine(Handler&, const char* pos, const char*& begin, const char* end, const char*& mark);
+//   template <typename Handler> bool emitStartLine(Handler&, const char* p, size_t n);
+//   void resetStartLine();
+//   bool startLineStarted() const;
+//   static const bool closeDelimited;  // whether a body without framing runs until the connection closes
+//
+// and moves `state` to StartLineNewLine once it has seen the CR that ends the start line. It is
+// handed the byte at `pos` and may take more of them at once by moving `begin` further.
+template <typename Derived>
+class HttpParserBase
+{
+public:
+    enum ParseResult
+    {
+        ParsingCompleted,
+        ParsingIncompleted,
+        ParsingError,
+        // The message goes over a ParserLimits bound or the fixed capacity of the message it is
+        // parsed into, error() tells which.
+        ParsingTooLarge,
+        // In headers-only mode: the headers are complete and a body follows, see setHeadersOnly().
+        ParsingHeadersCompleted
+    };
+
+    // How the body of the message is delimited, known once the headers are complete.
+    enum BodyFraming
+    {
+        NoBody,
+        ContentLengthBody,
+        ChunkedBody,
+        // Until the connection closes.
+        CloseDelimitedBody
+    };
+
+    // Why the last parse() failed.
+    enum ParseError
+    {
+        NoError,
+        // Malformed, or rejected by the handler.
+        InvalidMessage,
+        UriTooLong,
+        HeadersTooLarge,
+        TooManyHeaders,
+        BodyTooLarge,
+        // A StaticRequest or StaticResponse ran out of room.
+        CapacityExceeded
+    };
+
+    ParseError error() const { return errorCode; }
+
+    // Make parse() return ParsingHeadersCompleted as soon as the headers of a message with a body
+    // are complete, without looking at the body. With parse(..., consumed) the body starts at
+    // `consumed`; forward it by framing() and contentLength(), or call parse() again to go on
+    // with the body. A message without a body still ends with ParsingCompleted.
+    void setHeadersOnly(bool enabled) { headersOnly = enabled; }
+
+    BodyFraming framing() const { return bodyFraming; }
+
+    // The Content-Length of a ContentLengthBody message.
+    uint64_t contentLength() const { return bodyFraming == ContentLengthBody ? bodyLength : 0; }
+
+    const ParserLimits& limits() const { return config; }
+
+    // New limits apply to the bytes parsed from now on.
+    void setLimits(const ParserLimits& limits) { config = limits; }
+
+    // Prepare for the next message on the same connection. Pair it with Request::clear() (or
+    // Response::clear()) to reuse the memory of the previous message.
+    void reset()
+    {
+        state                = StartLine;
+        contentSize          = 0;
+        chunkSize            = 0;
+        chunked              = false;
+        contentLengthSeen    = false;
+        transferEncodingSeen = false;
+        versionMajor         = 0;
+        versionMinor         = 0;
+        headerCount          = 0;
+        headerBytes          = 0;
+        bodySize             = 0;
+        header               = HeaderUnknown;
+        bodyAllowed          = true;
+        connectionSeen       = false;
+        connectionKeepAlive  = false;
+        errorCode            = NoError;
+        bodyFraming          = NoBody;
+        bodyLength           = 0;
+
+        derived().resetStartLine();
+    }
+
+    // Event-driven parsing without building a message object, see httphandler.h.
+    template <typename Handler>
+    ParseResult parse(Handler& handler, const char* begin, const char* end)
+    {
+        return consume(handler, begin, end);
+    }
+
+    // Same as above, but also report in `consumed` how many bytes of [begin, end) were used. Once
+    // the message is completed, the rest of the buffer is the start of the next pipelined message.
+    template <typename Handler>
+    ParseResult parse(Handler& handler, const char* begin, const char* end, size_t& consumed)
+    {
+        const char* pos = begin;
+        ParseResult res = consume(handler, pos, end);
+        consumed        = pos - begin;
+        return res;
+    }
+
+    // The peer closed the connection. Completes a body that runs until the close, see
+    // bodyUntilClose(). ParsingIncompleted if no message had started, ParsingError if the close
+    // cut the message short.
+    template <typename Handler>
+    ParseResult finish(Handler& handler)
+    {
+        if (state == BodyUntilClose)
+            return handler.onMessageComplete() ? ParsingCompleted : ParsingError;
+
+        if (state == StartLine && !derived().startLineStarted())
+            return ParsingIncompleted;
+
+        errorCode = InvalidMessage;
+        return ParsingError;
+    }
+
+    // Same for the message types, whose builders have nothing left to do at the end.
+    ParseResult finish()
+    {
+        HttpHandler handler;
+        return finish(handler);
+    }
+
+    // Whether the body of the message being parsed ends when the connection closes. Such a
+    // message is never kept alive.
+    bool bodyUntilClose() const { return state == BodyUntilClose; }
+
+protected:
+    explicit HttpParserBase(const ParserLimits& limits)
+        : state(StartLine),
+          contentSize(0),
+          chunkSize(0),
+          chunked(false),
+          contentLengthSeen(false),
+          transferEncodingSeen(false),
+          versionMajor(0),
+          versionMinor(0),
+          headerCount(0),
+          headerBytes(0),
+          bodySize(0),
+          header(HeaderUnknown),
+          bodyAllowed(true),
+          connectionSeen(false),
+          connectionKeepAlive(false),
+          errorCode(NoError),
+          headersOnly(false),
+          bodyFraming(NoBody),
+          bodyLength(0),
+          config(limits)
+    {
+    }
+
+    Derived& derived() { return static_cast<Derived&>(*this); }
+
+    // The 8 bytes at `p` as one word. A literal loaded the same way compares equal on any byte order.
+    static uint64_t loadWord(const char* p)
+    {
+        uint64_t w;
+        memcpy(&w, p, sizeof(w));
+        return w;
+    }
+
+    // Take "HTTP/1.1" or "HTTP/1.0" in the 8 bytes at `p` with one comparison. Other versions are
+    // left to the byte-by-byte states.
+    bool matchVersion(const char* p)
+    {
+        uint64_t w = loadWord(p);
+
+        if (w != loadWord("HTTP/1.1") && w != loadWord("HTTP/1.0"))
+            return false;
+
+        versionMajor = 1;
+        versionMinor = p[7] - '0';
+        return true;
+    }
+
+    // Report the part of the current token that lies in [p, p + n) to the handler and remember
+    // its beginning if the parser itself needs to understand the token.
+    template <typename Handler>
+    bool emit(Handler& handler, const char* p, size_t n)
+    {
+        if (n == 0)
+            return true;
+
+        switch (state)
+        {
+        case StartLine:
+            return derived().emitStartLine(handler, p, n);
+        case HeaderName:
+            if (!countHeaderBytes(n))
+                return false;
+
+            token.append(p, n);
+            return handler.onHeaderField(p, n);
+        case HeaderValue:
+            if (!countHeaderBytes(n))
+                return false;
+
+            // Only the final coding frames the message, however long the list is.
+            if (header == HeaderTransferEncoding)
+                value.appendListElement(p, n);
+            else
+                value.append(p, n);
+            return handler.onHeaderValue(p, n);
+        default:
+            return true;
+        }
+    }
+
+    // Stop with `error`, for the checks that return bool.
+    bool fail(ParseError error)
+    {
+        errorCode = error;
+        return false;
+    }
+
+    ParseResult tooLarge(ParseError error)
+    {
+        errorCode = error;
+        return ParsingTooLarge;
+    }
+
+    bool countHeaderBytes(size_t n)
+    {
+        headerBytes += n;
+        return headerBytes <= config.maxHeaderBytes || fail(HeadersTooLarge);
+    }
+
+    template <typename Handler>
+    ParseResult consume(Handler& handler, const char*& begin, const char* end)
+    {
+        ParseResult res = consumeMessage(handler, begin, end);
+
+        if (res != ParsingError)
+            return res;
+
+        // The checks of the limits fail through the same paths as syntax errors.
+        if (errorCode == NoError)
+            errorCode = InvalidMessage;
+
+        return errorCode == InvalidMessage ? ParsingError : ParsingTooLarge;
+    }
+
+    template <typename Handler>
+    ParseResult consumeMessage(Handler& handler, const char*& begin, const char* end)
+    {
+        // Start of the token the parser is in, reported when the token or the buffer ends.
+        const char* mark = begin;
+
+        while (begin != end)
+        {
+            const char* pos = begin++;
+            char input      = *pos;
+
+            switch (state)
+            {
+            case StartLine:
+            {
+                ParseResult res = derived().consumeStartLine(handler, pos, begin, end, mark);
+
+                if (res != ParsingIncompleted)
+                    return res;
+                break;
+            }
+            case StartLineNewLine:
+                if (input == '\n')
+                {
+                    state = HeaderLineStart;
+                }
+                else
+                {
+                    return ParsingError;
+                }
+                break;
+            case HeaderLineStart:
+                if (input == '\r')
+                {
+                    state = ExpectingNewline_3;
+                }
+                else if (headerCount != 0 && (input == ' ' || input == '\t'))
+                {
+                    if (!countHeaderBytes(1))
+                        return ParsingError;
+
+                    state = HeaderLws;
+                }
+                else if (!isToken(input))
+                {
+                    return ParsingError;
+                }
+                else
+                {
+                    if (++headerCount > config.maxHeaderCount)
+                        return tooLarge(TooManyHeaders);
+
+                    if (!handler.onHeaderBegin())
+                        return ParsingError;
+
+                    token.clear();
+                    value.clear();
+                    mark  = pos;
+                    state = HeaderName;
+                }
+                break;
+            case HeaderLws:
+                if (input == '\r')
+                {
+                    state = ExpectingNewline_2;
+                }
+                else if (input == ' ' || input == '\t')
+                {
+                    if (!countHeaderBytes(1))
                         return ParsingError;
-                    }
+                }
+                else if (!isText(input))
+                {
+                    return ParsingError;
+                }
+                else
+                {
+                    state = HeaderValue;
+                    mark  = pos;
+                }
+                break;
+            case HeaderName:
+                // Skip the rest of the name at once, it is reported when the name or the buffer ends.
+                pos = scan::token(pos, end);
+                if (pos == end)
+                {
+                    begin = end;
                     break;
-                case ChunkSizeNewLine:
-                    if (input == '\n')
-                    {
-                        chunkSize = strtol(chunkSizeStr.c_str(), NULL, 16);
-                        chunkSizeStr.clear();
-                        resp.content.reserve(resp.content.size() + chunkSize);
-
-                        if (chunkSize == 0)
-                            state = ChunkSizeNewLine_2;
-                        else
-                            state = ChunkData;
-                    }
-                    else
-                    {
-                        return ParsingError;
-                    }
+                }
+
+                // Report the name before checking the byte after it: with the name split over
+                // several buffers its bytes would have counted against the limits already.
+                begin = pos + 1;
+                if (!emit(handler, mark, pos - mark) || *pos != ':')
+                    return ParsingError;
+
+                header = token.headerId();
+                if (!handler.onHeaderId(header))
+                    return ParsingError;
+
+                state = SpaceBeforeHeaderValue;
+                break;
+            case SpaceBeforeHeaderValue:
+                if (input == ' ')
+                {
+                    state = HeaderValue;
+                    mark  = begin;
+                }
+                else
+                {
+                    return ParsingError;
+                }
+                break;
+            case HeaderValue:
+                pos = scan::text(pos, end);
+                if (pos == end)
+                {
+                    begin = end;
                     break;
-                case ChunkSizeNewLine_2:
-                    if (input == '\r')
+                }
+
+                begin = pos + 1;
+                if (!emit(handler, mark, pos - mark))
+                    return ParsingError;
+
+                if (*pos == '\r')
+                {
+                    switch (header)
                     {
-                        state = ChunkSizeNewLine_3;
-                    }
-                    else if (isalpha(input))
+                    case HeaderConnection:
+                        if (!connectionSeen)
+                            connectionKeepAlive = value.equals("Keep-Alive");
+
+                        connectionSeen = true;
+                        break;
+                    case HeaderContentLength:
                     {
-                        state = ChunkTrailerName;
+                        if (!bodyAllowed)
+                            break;
+
+                        // RFC 9112 6.3: differing lengths leave the end of the message unknown.
+                        uint64_t length = 0;
+                        if (!value.decimal(length) || (contentLengthSeen && length != contentSize))
+                            return ParsingError;
+
+                        contentSize       = length;
+                        contentLengthSeen = true;
+                        if (contentSize > config.maxBodySize)
+                            return tooLarge(BodyTooLarge);
+                        break;
+                    }
+                    case HeaderTransferEncoding:
+                        if (!bodyAllowed)
+                            break;
+
+                        // Chunked must be the final coding, and applied only once.
+                        if (chunked)
+                            return ParsingError;
+
+                        transferEncodingSeen = true;
+                        chunked              = value.trimmedEquals("chunked");
+                        break;
+                    default:
+                        break;
                     }
-                    else
-                    {
+                    state = ExpectingNewline_2;
+                }
+                else
+                {
+                    return ParsingError;
+                }
+                break;
+            case ExpectingNewline_2:
+                if (input == '\n')
+                {
+                    if (!countHeaderBytes(2))
                         return ParsingError;
-                    }
-                    break;
-                case ChunkSizeNewLine_3:
-                    if (input == '\n')
-                    {
-                        return ParsingCompleted;
-                    }
-                    else
-                    {
+
+                    state = HeaderLineStart;
+                }
+                else
+                {
+                    return ParsingError;
+                }
+                break;
+            case ExpectingNewline_3:
+            {
+                if (input != '\n')
+                    return ParsingError;
+
+                // RFC 9112 6.3: a request with a final coding other than chunked has no knowable
+                // length. A response to it goes on until the connection closes, as does one
+                // without Content-Length.
+                if (transferEncodingSeen && !chunked && !Derived::closeDelimited)
+                    return ParsingError;
+
+                bool keepAlive  = false;
+                bool untilClose = Derived::closeDelimited && bodyAllowed && !chunked
+                                  && (transferEncodingSeen || !contentLengthSeen);
+
+                // Transfer-Encoding overrides Content-Length, but the peer may have framed the
+                // message by the other one: do not read anything more from this connection.
+                if (untilClose || (transferEncodingSeen && contentLengthSeen))
+                    keepAlive = false;
+                else if (connectionSeen)
+                    keepAlive = connectionKeepAlive;
+                else if (versionMajor > 1 || (versionMajor == 1 && versionMinor == 1))
+                    keepAlive = true;
+
+                if (!handler.onHeadersComplete(keepAlive))
+                    return ParsingError;
+
+                if (chunked)
+                {
+                    state       = ChunkSizeStart;
+                    bodyFraming = ChunkedBody;
+                }
+                else if (untilClose)
+                {
+                    state       = BodyUntilClose;
+                    bodyFraming = CloseDelimitedBody;
+                }
+                else if (contentSize == 0)
+                {
+                    if (!handler.onMessageComplete())
                         return ParsingError;
-                    }
-                    break;
-                case ChunkTrailerName:
-                    if (isalnum(input))
-                    {
-                        // skip
-                    }
-                    else if (input == ':')
-                    {
-                        state = ChunkTrailerValue;
-                    }
-                    else
-                    {
+
+                    return ParsingCompleted;
+                }
+                else
+                {
+                    state       = Post;
+                    bodyFraming = ContentLengthBody;
+                    bodyLength  = contentSize;
+                }
+
+                if (headersOnly)
+                    return ParsingHeadersCompleted;
+                break;
+            }
+            case Post:
+            {
+                // Hand over as much of the body as this buffer holds in one step.
+                size_t n = static_cast<size_t>(std::min<uint64_t>(contentSize, end - pos));
+                begin    = pos + n;
+                contentSize -= n;
+
+                if (!handler.onBody(pos, n))
+                    return ParsingError;
+
+                if (contentSize == 0)
+                {
+                    if (!handler.onMessageComplete())
                         return ParsingError;
-                    }
-                    break;
-                case ChunkTrailerValue:
-                    if (isalnum(input) || input == ' ')
-                    {
-                        // skip
-                    }
-                    else if (input == '\r')
-                    {
-                        state = ChunkSizeNewLine;
-                    }
+
+                    return ParsingCompleted;
+                }
+                break;
+            }
+            case BodyUntilClose:
+            {
+                size_t n = end - pos;
+                begin    = end;
+
+                if (n > config.maxBodySize - bodySize)
+                    return tooLarge(BodyTooLarge);
+
+                bodySize += n;
+                if (!handler.onBody(pos, n))
+                    return ParsingError;
+                break;
+            }
+            case ChunkSizeStart:
+                if (!isHexDigit(input))
+                    return ParsingError;
+
+                chunkSize = hexValue(input);
+                state     = ChunkSize;
+                break;
+            case ChunkSize:
+                if (isHexDigit(input))
+                {
+                    // One more digit must not push the size past 64 bits.
+                    if (chunkSize > UINT64_MAX >> 4)
+                        return ParsingError;
+
+                    chunkSize = chunkSize * 16 + hexValue(input);
+                }
+                else if (input == ';')
+                {
+                    state = ChunkExtensionName;
+                }
+                else if (input == '\r')
+                {
+                    state = ChunkSizeNewLine;
+                }
+                else
+                {
+                    return ParsingError;
+                }
+                break;
+            case ChunkExtensionName:
+                if (isToken(input) || input == ' ')
+                {
+                    // skip
+                }
+                else if (input == '=')
+                {
+                    state = ChunkExtensionValue;
+                }
+                else if (input == '\r')
+                {
+                    state = ChunkSizeNewLine;
+                }
+                else
+                {
+                    return ParsingError;
+                }
+                break;
+            case ChunkExtensionValue:
+                if (isToken(input) || input == ' ')
+                {
+                    // skip
+                }
+                else if (input == '\r')
+                {
+                    state = ChunkSizeNewLine;
+                }
+                else
+                {
+                    return ParsingError;
+                }
+                break;
+            case ChunkSizeNewLine:
+                if (input == '\n')
+                {
+                    if (chunkSize > config.maxBodySize - bodySize)
+                        return tooLarge(BodyTooLarge);
+
+                    bodySize += chunkSize;
+                    if (chunkSize == 0)
+                        state = ChunkSizeNewLine_2;
                     else
-                    {
+                        state = ChunkData;
+                }
+                else
+                {
+                    return ParsingError;
+                }
+                break;
+            case ChunkSizeNewLine_2:
+                if (input == '\r')
+                {
+                    state = ChunkSizeNewLine_3;
+                }
+                else if (isToken(input))
+                {
+                    state = ChunkTrailerName;
+                }
+                else
+                {
+                    return ParsingError;
+                }
+                break;
+            case ChunkSizeNewLine_3:
+                if (input == '\n')
+                {
+                    if (!handler.onMessageComplete())
+                        return ParsingError;
+
+                    return ParsingCompleted;
+                }
+                else
+                {
+                    return ParsingError;
+                }
+                break;
+            case ChunkTrailerName:
+                if (isToken(input))
+                {
+                    // skip
+                }
+                else if (input == ':')
+                {
+                    state = ChunkTrailerValue;
+                }
+                else
+                {
+                    return ParsingError;
+                }
+                break;
+            case ChunkTrailerValue:
+                if (isText(input))
+                {
+                    // skip
+                }
+                else if (input == '\r')
+                {
+                    state = ChunkSizeNewLine;
+                }
+                else
+                {
+                    return ParsingError;
+                }
+                break;
+            case ChunkData:
+            {
+                size_t n = static_cast<size_t>(std::min<uint64_t>(chunkSize, end - pos));
+                begin    = pos + n;
+                chunkSize -= n;
+
+                if (!handler.onBody(pos, n))
+                    return ParsingError;
+
+                if (chunkSize == 0)
+                {
+                    state = ChunkDataNewLine_1;
+                }
+                break;
+            }
+            case ChunkDataNewLine_1:
+                if (input == '\r')
+                {
+                    state = ChunkDataNewLine_2;
+                }
+                else
+                {
+                    return ParsingError;
+                }
+                break;
+            case ChunkDataNewLine_2:
+                if (input == '\n')
+                {
+                    state = ChunkSizeStart;
+                }
+                else
+                {
+                    return ParsingError;
+                }
+                break;
+            default:
+                return ParsingError;
+            }
+        }
+
+        if (!emit(handler, mark, end - mark))
+            return ParsingError;
+
+        return ParsingIncompleted;
+    }
+
+    // The current state of the parser.
+    enum State
+    {
+        StartLine,
+        StartLineNewLine,
+
+        HeaderLineStart,
+        HeaderLws,
+        HeaderName,
+        SpaceBeforeHeaderValue,
+        HeaderValue,
+        ExpectingNewline_2,
+        ExpectingNewline_3,
+
+        Post,
+        BodyUntilClose,
+        ChunkSizeStart,
+        ChunkSize,
+        ChunkExtensionName,
+        ChunkExtensionValue,
+        ChunkSizeNewLine,
+        ChunkSizeNewLine_2,
+        ChunkSizeNewLine_3,
+        ChunkTrailerName,
+        ChunkTrailerValue,
+
+        ChunkDataNewLine_1,
+        ChunkDataNewLine_2,
+        ChunkData,
+    } state;
+
+    // The first bytes of a token, enough to recognize the methods and headers the parser itself
+    // has to understand. Longer tokens never compare equal.
+    class TokenPrefix
+    {
+    public:
+        TokenPrefix() : size(0), elementEnded(false) {}
+
+        void clear()
+        {
+            size         = 0;
+            elementEnded = false;
+        }
+
+        void append(const char* p, size_t n)
+        {
+            if (size < sizeof(data))
+                memcpy(data + size, p, std::min(n, sizeof(data) - size));
+
+            size += n;
+        }
+
+        // Case-insensitive comparison with a literal.
+        bool equals(const char* literal) const
+        {
+            return size == strlen(literal) && size <= sizeof(data) && strncasecmp(data, literal, size) == 0;
+        }
+
+        // Append the next bytes of a comma-separated list, keeping only its last non-empty
+        // element. The element may arrive split over any number of calls.
+        void appendListElement(const char* p, size_t n)
+        {
+            for (const char* end = p + n; p != end; ++p)
+            {
+                if (*p == ',')
+                {
+                    elementEnded = true;
+                }
+                else if (!elementEnded || (*p != ' ' && *p != '\t'))
+                {
+                    if (elementEnded)
+                        clear();
+                    append(p, 1);
+                }
+            }
+        }
+
+        // Case-insensitive comparison with a literal, ignoring whitespace around the token.
+        bool trimmedEquals(const char* literal) const
+        {
+            if (size > sizeof(data))
+                return false;
+
+            size_t i = 0, n = size;
+
+            while (i < n && (data[i] == ' ' || data[i] == '\t'))
+                ++i;
+            while (n > i && (data[n - 1] == ' ' || data[n - 1] == '\t'))
+                --n;
+
+            return n - i == strlen(literal) && strncasecmp(data + i, literal, n - i) == 0;
+        }
+
+        // Well-known ID of the token, names longer than the prefix are never well-known.
+        HeaderId headerId() const { return size <= sizeof(data) ? httpparser::headerId(data, size) : HeaderUnknown; }
+
+        Method methodId() const { return size <= sizeof(data) ? httpparser::methodId(data, size) : MethodUnknown; }
+
+        // Parse the token as a decimal number between optional whitespace. False if there is
+        // anything else in it or the number does not fit into 64 bits.
+        bool decimal(uint64_t& result) const
+        {
+            if (size > sizeof(data))
+                return false;
+
+            size_t i = 0, n = size;
+
+            while (i < n && (data[i] == ' ' || data[i] == '\t'))
+                ++i;
+            while (n > i && (data[n - 1] == ' ' || data[n - 1] == '\t'))
+                --n;
+
+            if (i == n)
+                return false;
+
+            for (result = 0; i < n; ++i)
+            {
+                unsigned int digit = data[i] - '0';
+
+                if (!isDigit(data[i]) || result > (UINT64_MAX - digit) / 10)
+                    return false;
+
+                result = result * 10 + digit;
+            }
+
+            return true;
+        }
+
+    private:
+        char data[32];
+        size_t size;
+        // A comma ended the list element in `data`, the next non-blank byte starts another.
+        bool elementEnded;
+    };
+
+    // 64 bits even where size_t is not, so that bodies over 4 GB parse everywhere.
+    uint64_t contentSize;
+    uint64_t chunkSize;
+    bool chunked;
+    bool contentLengthSeen;
+    bool transferEncodingSeen;
+
+    int versionMajor;
+    int versionMinor;
+    size_t headerCount;
+    // Bytes of the start line and the header lines so far, see ParserLimits::maxHeaderBytes.
+    size_t headerBytes;
+    // Sum of the chunk sizes, or the size of a body read until close, so far.
+    uint64_t bodySize;
+    // Well-known ID of the name of the header line being parsed.
+    HeaderId header;
+    // Whether Content-Length and Transfer-Encoding frame a body for this message.
+    bool bodyAllowed;
+    bool connectionSeen;
+    bool connectionKeepAlive;
+    TokenPrefix token;
+    TokenPrefix value;
+    ParseError errorCode;
+    bool headersOnly;
+    BodyFraming bodyFraming;
+    uint64_t bodyLength;
+    ParserLimits config;
+};
+
+}  // namespace httpparser
+
+#endif  // HTTPPARSER_HTTPPARSERBASE_H
+#ifndef HTTPPARSER_STATICREQUEST_H
+#define HTTPPARSER_STATICREQUEST_H
+
+#include <string>
+
+#include <stddef.h>
+
+#ifndef HTTPPARSER_FIXEDSTORAGE_H
+#define HTTPPARSER_FIXEDSTORAGE_H
+
+#include <assert.h>
+#include <stddef.h>
+#include <string.h>
+
+
+namespace httpparser
+{
+
+// Inline byte storage of `Size` bytes with the append() interface of Arena. It never allocates;
+// append() returns false once the bytes do not fit anymore.
+template <size_t Size>
+class FixedBuffer
+{
+public:
+    FixedBuffer() : used(0) {}
+
+    // Append [p, p + n) to `s`, which is either empty or the last slice appended to.
+    bool append(Slice& s, const char* p, size_t n)
+    {
+        assert(s.empty() || s.end() == data + used);
+
+        if (n > Size - used)
+            return false;
+
+        memcpy(data + used, p, n);
+        s = Slice(s.empty() ? data + used : s.data(), s.size() + n);
+        used += n;
+        return true;
+    }
+
+    void reset() { used = 0; }
+
+    size_t size() const { return used; }
+    static size_t capacity() { return Size; }
+
+private:
+    FixedBuffer(const FixedBuffer&);
+    FixedBuffer& operator=(const FixedBuffer&);
+
+    char data[Size];
+    size_t used;
+};
+
+// A vector of at most `Capacity` elements stored inline. push_back() returns false when full.
+template <typename T, size_t Capacity>
+class FixedVector
+{
+public:
+    typedef T value_type;
+    typedef const T* const_iterator;
+
+    FixedVector() : count(0) {}
+
+    bool push_back(const T& value)
+    {
+        if (count == Capacity)
+            return false;
+
+        items[count++] = value;
+        return true;
+    }
+
+    void clear() { count = 0; }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    static size_t capacity() { return Capacity; }
+
+    T& operator[](size_t i) { return items[i]; }
+    const T& operator[](size_t i) const { return items[i]; }
+
+    T& back() { return items[count - 1]; }
+    const T& back() const { return items[count - 1]; }
+
+    const_iterator begin() const { return items; }
+    const_iterator end() const { return items + count; }
+
+private:
+    T items[Capacity];
+    size_t count;
+};
+
+}  // namespace httpparser
+
+#endif  // HTTPPARSER_FIXEDSTORAGE_H
+
+namespace httpparser
+{
+
+// A request that keeps everything inline, for parsing without touching the heap: at most
+// `MaxHeaders` headers and `MaxBytes` bytes of text for the method, the URI, the header names
+// and values and the body together. HttpRequestParser returns ParsingTooLarge for a message that
+// does not fit.
+//
+// The fields are slices of the request's own storage, so it cannot be copied; materialize() it
+// into a Request to keep it.
+template <size_t MaxHeaders, size_t MaxBytes>
+struct StaticRequest
+{
+    StaticRequest() : methodId(MethodUnknown), versionMajor(0), versionMinor(0), keepAlive(false) {}
+
+    struct HeaderItem
+    {
+        HeaderItem() : id(HeaderUnknown) {}
+
+        Slice name;
+        Slice value;
+        HeaderId id;
+    };
+
+    Slice method;
+    Method methodId;
+    Slice uri;
+    int versionMajor;
+    int versionMinor;
+    FixedVector<HeaderItem, MaxHeaders> headers;
+    Slice content;
+    bool keepAlive;
+    FixedBuffer<MaxBytes> storage;
+
+    // Reset to the default-constructed state, ready for the next message.
+    void clear()
+    {
+        method.clear();
+        methodId = MethodUnknown;
+        uri.clear();
+        versionMajor = 0;
+        versionMinor = 0;
+        headers.clear();
+        content.clear();
+        keepAlive = false;
+        storage.reset();
+    }
+
+    // Value of the first header called `key`, ignoring case, or an empty slice if there is none.
+    // There are only a few headers, so this is a scan.
+    Slice header(const HeaderKey& key) const
+    {
+        for (size_t i = 0; i < headers.size(); ++i)
+        {
+            if (key.matches(headers[i]))
+                return headers[i].value;
+        }
+
+        return Slice();
+    }
+
+    bool has(const HeaderKey& key) const
+    {
+        for (size_t i = 0; i < headers.size(); ++i)
+        {
+            if (key.matches(headers[i]))
+                return true;
+        }
+
+        return false;
+    }
+
+    template <typename Alloc>
+    void materialize(BasicRequest<Alloc>& req) const
+    {
+        req.clear();
+        req.method.assign(method.data(), method.size());
+        req.methodId = methodId;
+        req.uri.assign(uri.data(), uri.size());
+        req.versionMajor = versionMajor;
+        req.versionMinor = versionMinor;
+        req.keepAlive    = keepAlive;
+
+        for (size_t i = 0; i < headers.size(); ++i)
+        {
+            req.addHeader().name.assign(headers[i].name.data(), headers[i].name.size());
+            req.headers.back().value.assign(headers[i].value.data(), headers[i].value.size());
+            req.headers.back().id = headers[i].id;
+        }
+
+        req.content.assign(content.begin(), content.end());
+        req.reindex();
+    }
+
+    Request materialize() const
+    {
+        Request req;
+        materialize(req);
+        return req;
+    }
+
+    std::string inspect() const { return materialize().inspect(); }
+};
+
+}  // namespace httpparser
+
+#endif  // HTTPPARSER_STATICREQUEST_H
+
+namespace httpparser
+{
+
+// The handler HttpRequestParser uses to fill a Request or a RequestView.
+template <typename Message>
+class RequestBuilder : public HttpHandler
+{
+public:
+    explicit RequestBuilder(Message& req) : req(req) {}
+
+    bool onMethod(const char* data, size_t size)
+    {
+        append(req.method, data, size);
+        return true;
+    }
+
+    bool onMethodId(Method method)
+    {
+        req.methodId = method;
+        return true;
+    }
+
+    bool onUri(const char* data, size_t size)
+    {
+        append(req.uri, data, size);
+        return true;
+    }
+
+    bool onVersion(int major, int minor)
+    {
+        req.versionMajor = major;
+        req.versionMinor = minor;
+        return true;
+    }
+
+    bool onHeaderBegin()
+    {
+        typename Message::HeaderItem& h = req.addHeader();
+        reserve(h.name, 16);
+        reserve(h.value, 16);
+        return true;
+    }
+
+    bool onHeaderField(const char* data, size_t size)
+    {
+        append(req.headers.back().name, data, size);
+        return true;
+    }
+
+    bool onHeaderId(HeaderId id)
+    {
+        req.headers.back().id = id;
+        return true;
+    }
+
+    bool onHeaderValue(const char* data, size_t size)
+    {
+        append(req.headers.back().value, data, size);
+        return true;
+    }
+
+    bool onHeadersComplete(bool keepAlive)
+    {
+        req.keepAlive = keepAlive;
+        req.reindex();
+        return true;
+    }
+
+    bool onBody(const char* data, size_t size)
+    {
+        append(req.content, data, size);
+        return true;
+    }
+
+protected:
+    Message& req;
+};
+
+// Copies the text of the message into the arena of an ArenaRequest.
+class ArenaRequestBuilder : public RequestBuilder<ArenaRequest>
+{
+public:
+    explicit ArenaRequestBuilder(ArenaRequest& req) : RequestBuilder<ArenaRequest>(req) {}
+
+    bool onMethod(const char* data, size_t size)
+    {
+        req.arena.append(req.method, data, size);
+        return true;
+    }
+
+    bool onUri(const char* data, size_t size)
+    {
+        req.arena.append(req.uri, data, size);
+        return true;
+    }
+
+    bool onHeaderField(const char* data, size_t size)
+    {
+        req.arena.append(req.headers.back().name, data, size);
+        return true;
+    }
+
+    bool onHeaderValue(const char* data, size_t size)
+    {
+        req.arena.append(req.headers.back().value, data, size);
+        return true;
+    }
+
+    bool onBody(const char* data, size_t size)
+    {
+        req.arena.append(req.content, data, size);
+        return true;
+    }
+};
+
+// Fills a StaticRequest, failing instead of growing once its capacity is used up.
+template <typename Message>
+class StaticRequestBuilder : public HttpHandler
+{
+public:
+    explicit StaticRequestBuilder(Message& req) : req(req), full(false) {}
+
+    bool onMethod(const char* data, size_t size) { return store(req.method, data, size); }
+
+    bool onMethodId(Method method)
+    {
+        req.methodId = method;
+        return true;
+    }
+
+    bool onUri(const char* data, size_t size) { return store(req.uri, data, size); }
+
+    bool onVersion(int major, int minor)
+    {
+        req.versionMajor = major;
+        req.versionMinor = minor;
+        return true;
+    }
+
+    bool onHeaderBegin() { return fits(req.headers.push_back(typename Message::HeaderItem())); }
+
+    bool onHeaderField(const char* data, size_t size) { return store(req.headers.back().name, data, size); }
+
+    bool onHeaderId(HeaderId id)
+    {
+        req.headers.back().id = id;
+        return true;
+    }
+
+    bool onHeaderValue(const char* data, size_t size) { return store(req.headers.back().value, data, size); }
+
+    bool onHeadersComplete(bool keepAlive)
+    {
+        req.keepAlive = keepAlive;
+        return true;
+    }
+
+    bool onBody(const char* data, size_t size) { return store(req.content, data, size); }
+
+    // Whether parsing stopped because the message ran out of capacity.
+    bool overflowed() const { return full; }
+
+private:
+    bool store(Slice& s, const char* data, size_t size) { return fits(req.storage.append(s, data, size)); }
+
+    bool fits(bool stored)
+    {
+        full = !stored;
+        return stored;
+    }
+
+    Message& req;
+    bool full;
+};
+
+// Fills the start line and the headers of a Request but hands the body over to `BodySink`, any
+// callable as bool(const char* data, size_t size), instead of accumulating it in content.
+template <typename Message, typename BodySink>
+class StreamingRequestBuilder : public RequestBuilder<Message>
+{
+public:
+    StreamingRequestBuilder(Message& req, BodySink& body) : RequestBuilder<Message>(req), body(body) {}
+
+    bool onBody(const char* data, size_t size) { return body(data, size); }
+
+private:
+    BodySink& body;
+};
+
+class HttpRequestParser : public HttpParserBase<HttpRequestParser>
+{
+public:
+    explicit HttpRequestParser(const ParserLimits& limits = ParserLimits()) : HttpParserBase<HttpRequestParser>(limits)
+    {
+        resetStartLine();
+    }
+
+    using HttpParserBase<HttpRequestParser>::parse;
+
+    template <typename Alloc>
+    ParseResult parse(BasicRequest<Alloc>& req, const char* begin, const char* end)
+    {
+        RequestBuilder<BasicRequest<Alloc> > builder(req);
+        return consume(builder, begin, end);
+    }
+
+    // Zero-copy parsing, see requestview.h for the buffer lifetime contract.
+    ParseResult parse(RequestView& req, const char* begin, const char* end)
+    {
+        RequestBuilder<RequestView> builder(req);
+        return consume(builder, begin, end);
+    }
+
+    // Copy the message into the arena of `req`, see arenarequest.h.
+    ParseResult parse(ArenaRequest& req, const char* begin, const char* end)
+    {
+        ArenaRequestBuilder builder(req);
+        return consume(builder, begin, end);
+    }
+
+    // Parse into inline storage only, ParsingTooLarge if the message does not fit.
+    template <size_t MaxHeaders, size_t MaxBytes>
+    ParseResult parse(StaticRequest<MaxHeaders, MaxBytes>& req, const char* begin, const char* end)
+    {
+        StaticRequestBuilder<StaticRequest<MaxHeaders, MaxBytes> > builder(req);
+        ParseResult res = consume(builder, begin, end);
+        return builder.overflowed() ? tooLarge(CapacityExceeded) : res;
+    }
+
+    // Stream the body to `body` as it arrives instead of storing it in req.content, so memory
+    // does not grow with the body size. Returning false from `body` stops parsing with ParsingError.
+    template <typename Alloc, typename BodySink>
+    ParseResult parse(BasicRequest<Alloc>& req, BodySink& body, const char* begin, const char* end)
+    {
+        StreamingRequestBuilder<BasicRequest<Alloc>, BodySink> builder(req, body);
+        return consume(builder, begin, end);
+    }
+
+    // Same as above, but also report in `consumed` how many bytes of [begin, end) were used. Once
+    // the message is completed, the rest of the buffer is the start of the next pipelined message.
+    template <typename Alloc>
+    ParseResult parse(BasicRequest<Alloc>& req, const char* begin, const char* end, size_t& consumed)
+    {
+        RequestBuilder<BasicRequest<Alloc> > builder(req);
+        return parse(builder, begin, end, consumed);
+    }
+
+    ParseResult parse(RequestView& req, const char* begin, const char* end, size_t& consumed)
+    {
+        RequestBuilder<RequestView> builder(req);
+        return parse(builder, begin, end, consumed);
+    }
+
+    ParseResult parse(ArenaRequest& req, const char* begin, const char* end, size_t& consumed)
+    {
+        ArenaRequestBuilder builder(req);
+        return parse(builder, begin, end, consumed);
+    }
+
+    template <size_t MaxHeaders, size_t MaxBytes>
+    ParseResult parse(StaticRequest<MaxHeaders, MaxBytes>& req, const char* begin, const char* end, size_t& consumed)
+    {
+        StaticRequestBuilder<StaticRequest<MaxHeaders, MaxBytes> > builder(req);
+        ParseResult res = parse(builder, begin, end, consumed);
+        return builder.overflowed() ? tooLarge(CapacityExceeded) : res;
+    }
+
+    template <typename Alloc, typename BodySink>
+    ParseResult parse(BasicRequest<Alloc>& req, BodySink& body, const char* begin, const char* end, size_t& consumed)
+    {
+        StreamingRequestBuilder<BasicRequest<Alloc>, BodySink> builder(req, body);
+        return parse(builder, begin, end, consumed);
+    }
+
+private:
+    friend class HttpParserBase<HttpRequestParser>;
+
+    template <typename Handler>
+    ParseResult consumeStartLine(Handler& handler, const char* pos, const char*& begin, const char* end,
+                                 const char*& mark)
+    {
+        char input = *pos;
+
+        switch (startLineState)
+        {
+        case RequestMethodStart:
+            // Take a well-known method with its space in one step when the buffer holds a word.
+            if (end - pos >= 8)
+            {
+                Method method = MethodUnknown;
+                size_t n      = knownMethod(pos, method);
+
+                if (n != 0)
+                {
+                    token.clear();
+                    startLineState = RequestMethod;
+                    if (!emit(handler, pos, n - 1) || !handler.onMethodId(method))
                         return ParsingError;
-                    }
+
+                    startLineState = RequestUriStart;
+                    begin          = pos + n;
                     break;
-                case ChunkData:
-                    resp.content.push_back(input);
+                }
+            }
+
+            if (!isToken(input))
+            {
+                return ParsingError;
+            }
+            else
+            {
+                startLineState = RequestMethod;
+                mark           = pos;
+                token.clear();
+            }
+            break;
+        case RequestMethod:
+            if (input == ' ')
+            {
+                if (!emit(handler, mark, pos - mark) || !handler.onMethodId(token.methodId()))
+                    return ParsingError;
+
+                startLineState = RequestUriStart;
+            }
+            else if (!isToken(input))
+            {
+                // The bytes so far count against the limits first, as in a split buffer.
+                emit(handler, mark, pos - mark);
+                return ParsingError;
+            }
+            break;
+        case RequestUriStart:
+            if (!isText(input))
+            {
+                return ParsingError;
+            }
+            else
+            {
+                startLineState = RequestUri;
+                mark           = pos;
+            }
+            break;
+        case RequestUri:
+            if (input == ' ')
+            {
+                if (!emit(handler, mark, pos - mark))
+                    return ParsingError;
+
+                startLineState = RequestHttpVersion_h;
+            }
+            else if (input == '\r')
+            {
+                if (!emit(handler, mark, pos - mark) || !handler.onVersion(0, 9)
+                    || !handler.onMessageComplete())
+                    return ParsingError;
+
+                return ParsingCompleted;
+            }
+            else if (!isText(input))
+            {
+                emit(handler, mark, pos - mark);
+                return ParsingError;
+            }
+            break;
+        case RequestHttpVersion_h:
+            // "HTTP/1.1\r\n" at once, the states below handle anything else and split buffers.
+            if (end - pos >= 10 && pos[8] == '\r' && pos[9] == '\n' && matchVersion(pos))
+            {
+                if (!handler.onVersion(versionMajor, versionMinor))
+                    return ParsingError;
+
+                state = HeaderLineStart;
+                begin = pos + 10;
+                break;
+            }
+
+            if (input == 'H')
+            {
+                startLineState = RequestHttpVersion_ht;
+            }
+            else
+            {
+                return ParsingError;
+            }
+            break;
+        case RequestHttpVersion_ht:
+            if (input == 'T')
+            {
+                startLineState = RequestHttpVersion_htt;
+            }
+            else
+            {
+                return ParsingError;
+            }
+            break;
+        case RequestHttpVersion_htt:
+            if (input == 'T')
+            {
+                startLineState = RequestHttpVersion_http;
+            }
+            else
+            {
+                return ParsingError;
+            }
+            break;
+        case RequestHttpVersion_http:
+            if (input == 'P')
+            {
+                startLineState = RequestHttpVersion_slash;
+            }
+            else
+            {
+                return ParsingError;
+            }
+            break;
+        case RequestHttpVersion_slash:
+            if (input == '/')
+            {
+                versionMajor   = 0;
+                versionMinor   = 0;
+                startLineState = RequestHttpVersion_majorStart;
+            }
+            else
+            {
+                return ParsingError;
+            }
+            break;
+        case RequestHttpVersion_majorStart:
+            if (isDigit(input))
+            {
+                versionMajor   = input - '0';
+                startLineState = RequestHttpVersion_major;
+            }
+            else
+            {
+                return ParsingError;
+            }
+            break;
+        case RequestHttpVersion_major:
+            if (input == '.')
+            {
+                startLineState = RequestHttpVersion_minorStart;
+            }
+            else
+            {
+                return ParsingError;
+            }
+            break;
+        case RequestHttpVersion_minorStart:
+            if (isDigit(input))
+            {
+                versionMinor   = input - '0';
+                startLineState = RequestHttpVersion_minor;
+            }
+            else
+            {
+                return ParsingError;
+            }
+            break;
+        case RequestHttpVersion_minor:
+            if (input == '\r')
+            {
+                if (!handler.onVersion(versionMajor, versionMinor))
+                    return ParsingError;
+
+                state = StartLineNewLine;
+            }
+            else
+            {
+                return ParsingError;
+            }
+            break;
+        default:
+            return ParsingError;
+        }
+
+        return ParsingIncompleted;
+    }
+
+    template <typename Handler>
+    bool emitStartLine(Handler& handler, const char* p, size_t n)
+    {
+        switch (startLineState)
+        {
+        case RequestMethod:
+            if (!countHeaderBytes(n))
+                return false;
+
+            token.append(p, n);
+            return handler.onMethod(p, n);
+        case RequestUri:
+            // Fail with the limit that a byte at a time would reach first, so the error does not
+            // depend on how the input is split. Neither count is over its limit yet.
+            if (n > config.maxUriSize - uriSize && config.maxUriSize - uriSize <= config.maxHeaderBytes - headerBytes)
+                return fail(UriTooLong);
+            if (!countHeaderBytes(n))
+                return false;
+
+            uriSize += n;
+            return handler.onUri(p, n);
+        default:
+            return true;
+        }
+    }
+
+    void resetStartLine()
+    {
+        startLineState = RequestMethodStart;
+        uriSize        = 0;
+    }
+
+    bool startLineStarted() const { return startLineState != RequestMethodStart; }
+
+    // Size of the well-known method and the space after it at `p`, which has at least 8 bytes,
+    // or 0. Each method is compared as one masked word.
+    static size_t knownMethod(const char* p, Method& method)
+    {
+        static const struct
+        {
+            char text[9];
+            size_t size;
+            Method id;
+        } methods[] = {
+            {"GET ", 4, MethodGet},
+            {"POST ", 5, MethodPost},
+            {"PUT ", 4, MethodPut},
+            {"HEAD ", 5, MethodHead},
+            {"DELETE ", 7, MethodDelete},
+            {"PATCH ", 6, MethodPatch},
+            {"OPTIONS ", 8, MethodOptions},
+            {"CONNECT ", 8, MethodConnect},
+            {"TRACE ", 6, MethodTrace},
+        };
+        // Eight bytes of ones followed by eight zero bytes: the word at `8 - n` masks n bytes.
+        static const char ones[16] = {'\xff', '\xff', '\xff', '\xff', '\xff', '\xff', '\xff', '\xff'};
+
+        uint64_t w = loadWord(p);
+
+        for (size_t i = 0; i < sizeof(methods) / sizeof(methods[0]); ++i)
+        {
+            if (((w ^ loadWord(methods[i].text)) & loadWord(ones + 8 - methods[i].size)) == 0)
+            {
+                method = methods[i].id;
+                return methods[i].size;
+            }
+        }
+
+        return 0;
+    }
+
+    // A request without Content-Length or chunked encoding has no body.
+    static const bool closeDelimited = false;
+
+    // The state of the parser within the request line.
+    enum StartLineState
+    {
+        RequestMethodStart,
+        RequestMethod,
+        RequestUriStart,
+        RequestUri,
+        RequestHttpVersion_h,
+        RequestHttpVersion_ht,
+        RequestHttpVersion_htt,
+        RequestHttpVersion_http,
+        RequestHttpVersion_slash,
+        RequestHttpVersion_majorStart,
+        RequestHttpVersion_major,
+        RequestHttpVersion_minorStart,
+        RequestHttpVersion_minor,
+    } startLineState;
+
+    size_t uriSize;
+};
+
+}  // namespace httpparser
+
+#endif  // LIBAHTTP_REQUESTPARSER_H
+#ifndef HTTPPARSER_RESPONSEPARSER_H
+#define HTTPPARSER_RESPONSEPARSER_H
+
+#ifndef HTTPPARSER_ARENARESPONSE_H
+#define HTTPPARSER_ARENARESPONSE_H
+
+#ifndef HTTPPARSER_RESPONSEVIEW_H
+#define HTTPPARSER_RESPONSEVIEW_H
+
+#include <string>
+#include <vector>
+
+#ifndef HTTPPARSER_RESPONSE_H
+#define HTTPPARSER_RESPONSE_H
+
+#include <algorithm>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace httpparser
+{
+
+// Every string and vector of the message, and of the headers it hands out, uses a copy of the
+// allocator given to the constructor.
+template <typename Alloc = std::allocator<char> >
+struct BasicResponse
+{
+private:
+    typedef std::allocator_traits<Alloc> AllocatorTraits;
+
+public:
+    typedef Alloc allocator_type;
+    typedef std::basic_string<char, std::char_traits<char>, typename AllocatorTraits::template rebind_alloc<char> > String;
+
+    explicit BasicResponse(const Alloc& alloc = Alloc())
+        : versionMajor(0),
+          versionMinor(0),
+          headers(alloc),
+          content(alloc),
+          keepAlive(false),
+          statusCode(0),
+          status(alloc),
+          headerPool(alloc),
+          index(alloc),
+          none(alloc)
+    {
+    }
+
+    struct HeaderItem
+    {
+        HeaderItem() : id(HeaderUnknown) {}
+        HeaderItem(const String& name, const String& value, HeaderId id = HeaderUnknown)
+            : name(name), value(value), id(id)
+        {
+        }
+
+        String name;
+        String value;
+        // Set by the parser, HeaderUnknown for a header added by hand.
+        HeaderId id;
+    };
+
+    int versionMajor;
+    int versionMinor;
+    std::vector<HeaderItem, typename AllocatorTraits::template rebind_alloc<HeaderItem> > headers;
+    std::vector<char, typename AllocatorTraits::template rebind_alloc<char> > content;
+    bool keepAlive;
+
+    unsigned int statusCode;
+    String status;
+
+    // Append an empty header, reusing the storage of a header dropped by clear() if possible.
+    HeaderItem& addHeader()
+    {
+        if (headerPool.empty())
+        {
+            HeaderItem item = {String(none.get_allocator()), String(none.get_allocator()), HeaderUnknown};
+            headers.push_back(std::move(item));
+        }
+        else
+        {
+            headers.push_back(std::move(headerPool.back()));
+            headerPool.pop_back();
+        }
+
+        return headers.back();
+    }
+
+    // Same as Request::clear().
+    void clear()
+    {
+        versionMajor = 0;
+        versionMinor = 0;
+        content.clear();
+        keepAlive  = false;
+        statusCode = 0;
+        status.clear();
+
+        for (size_t i = headers.size(); i-- > 0;)
+        {
+            headers[i].name.clear();
+            headers[i].value.clear();
+            headers[i].id = HeaderUnknown;
+            headerPool.push_back(std::move(headers[i]));
+        }
+
+        headers.clear();
+        index.clear();
+    }
+
+    // Value of the first header called `key`, ignoring case, or an empty string if there is none.
+    const String& header(const HeaderKey& key) const
+    {
+        size_t pos = index.find(headers, key);
+        return pos == HeaderIndex::npos ? none : headers[pos].value;
+    }
+
+    bool has(const HeaderKey& key) const { return index.find(headers, key) != HeaderIndex::npos; }
+
+    // All headers called `key`, in the order of the message.
+    std::vector<const HeaderItem*> findAll(const HeaderKey& key) const
+    {
+        std::vector<const HeaderItem*> result;
+
+        for (size_t pos = index.find(headers, key); pos != HeaderIndex::npos; pos = index.findNext(headers, key, pos))
+            result.push_back(&headers[pos]);
+
+        return result;
+    }
+
+    // Index the headers for the lookups above. The parser does it when the headers are complete;
+    // call it again after any change to `headers`, renaming one in place included. The index does
+    // not see such changes, and the lookups may miss headers until then. A renamed header also
+    // needs the `id` of its new name, or HeaderUnknown.
+    void reindex() { index.build(headers); }
+
+    std::string inspect() const
+    {
+        std::stringstream stream;
+        stream << "HTTP/" << versionMajor << "." << versionMinor << " " << statusCode << " " << status << "\n";
+
+        for (size_t i = 0; i < headers.size(); ++i)
+        {
+            stream << headers[i].name << ": " << headers[i].value << "\n";
+        }
+
+        std::string data(content.begin(), content.end());
+        stream << data << "\n";
+        return stream.str();
+    }
+
+private:
+    // Cleared headers kept for reuse, the next one to hand out is at the back.
+    std::vector<HeaderItem, typename AllocatorTraits::template rebind_alloc<HeaderItem> > headerPool;
+    BasicHeaderIndex<Alloc> index;
+    // Returned by header() for a missing header, and the source of the allocator for new headers.
+    String none;
+};
+
+typedef BasicResponse<> Response;
+
+}  // namespace httpparser
+
+#endif  // HTTPPARSER_RESPONSE_H
+
+namespace httpparser
+{
+
+// Zero-copy counterpart of Response. The same buffer contract as for RequestView applies:
+// the whole message must stay alive, unmoved and contiguous while the view is in use.
+struct ResponseView
+{
+    ResponseView() : versionMajor(0), versionMinor(0), keepAlive(false), statusCode(0) {}
+
+    struct HeaderItem
+    {
+        HeaderItem() : id(HeaderUnknown) {}
+
+        Slice name;
+        Slice value;
+        HeaderId id;
+    };
+
+    int versionMajor;
+    int versionMinor;
+    std::vector<HeaderItem> headers;
+    // One slice for a Content-Length body, one slice per chunk for a chunked body.
+    std::vector<Slice> content;
+    bool keepAlive;
+
+    unsigned int statusCode;
+    Slice status;
+
+    HeaderItem& addHeader()
+    {
+        headers.push_back(HeaderItem());
+        return headers.back();
+    }
+
+    // Reset to the default-constructed state, keeping the capacity of the vectors.
+    void clear()
+    {
+        versionMajor = 0;
+        versionMinor = 0;
+        headers.clear();
+        index.clear();
+        content.clear();
+        keepAlive  = false;
+        statusCode = 0;
+        status.clear();
+    }
+
+    // Value of the first header called `key`, ignoring case, or an empty slice if there is none.
+    Slice header(const HeaderKey& key) const
+    {
+        size_t pos = index.find(headers, key);
+        return pos == HeaderIndex::npos ? Slice() : headers[pos].value;
+    }
+
+    bool has(const HeaderKey& key) const { return index.find(headers, key) != HeaderIndex::npos; }
+
+    // All headers called `key`, in the order of the message.
+    std::vector<const HeaderItem*> findAll(const HeaderKey& key) const
+    {
+        std::vector<const HeaderItem*> result;
+
+        for (size_t pos = index.find(headers, key); pos != HeaderIndex::npos; pos = index.findNext(headers, key, pos))
+            result.push_back(&headers[pos]);
+
+        return result;
+    }
+
+    // Index the headers for the lookups above. The parser does it when the headers are complete;
+    // call it again after any change to `headers`, renaming one in place included. The index does
+    // not see such changes, and the lookups may miss headers until then. A renamed header also
+    // needs the `id` of its new name, or HeaderUnknown.
+    void reindex() { index.build(headers); }
+
+    template <typename Alloc>
+    void materialize(BasicResponse<Alloc>& resp) const
+    {
+        resp.clear();
+        resp.versionMajor = versionMajor;
+        resp.versionMinor = versionMinor;
+        resp.keepAlive    = keepAlive;
+        resp.statusCode   = statusCode;
+        resp.status.assign(status.data(), status.size());
+
+        for (size_t i = 0; i < headers.size(); ++i)
+        {
+            resp.addHeader().name.assign(headers[i].name.data(), headers[i].name.size());
+            resp.headers.back().value.assign(headers[i].value.data(), headers[i].value.size());
+            resp.headers.back().id = headers[i].id;
+        }
+
+        for (std::vector<Slice>::const_iterator it = content.begin(); it != content.end(); ++it)
+        {
+            resp.content.insert(resp.content.end(), it->begin(), it->end());
+        }
+
+        resp.reindex();
+    }
+
+    Response materialize() const
+    {
+        Response resp;
+        materialize(resp);
+        return resp;
+    }
+
+    std::string inspect() const { return materialize().inspect(); }
+
+private:
+    HeaderIndex index;
+};
+
+}  // namespace httpparser
+
+#endif  // HTTPPARSER_RESPONSEVIEW_H
+
+namespace httpparser
+{
+
+// A ResponseView whose slices point into an arena the response owns, see ArenaRequest.
+struct ArenaResponse : ResponseView
+{
+    explicit ArenaResponse(size_t blockSize = 4096) : arena(blockSize) {}
+
+    void clear()
+    {
+        ResponseView::clear();
+        arena.reset();
+    }
+
+    Arena arena;
+};
+
+}  // namespace httpparser
+
+#endif  // HTTPPARSER_ARENARESPONSE_H
+#ifndef HTTPPARSER_STATICRESPONSE_H
+#define HTTPPARSER_STATICRESPONSE_H
+
+#include <string>
+
+#include <stddef.h>
+
+
+namespace httpparser
+{
+
+// A response that keeps everything inline, see StaticRequest. `MaxBytes` covers the reason
+// phrase, the header names and values and the body.
+template <size_t MaxHeaders, size_t MaxBytes>
+struct StaticResponse
+{
+    StaticResponse() : versionMajor(0), versionMinor(0), keepAlive(false), statusCode(0) {}
+
+    struct HeaderItem
+    {
+        HeaderItem() : id(HeaderUnknown) {}
+
+        Slice name;
+        Slice value;
+        HeaderId id;
+    };
+
+    int versionMajor;
+    int versionMinor;
+    FixedVector<HeaderItem, MaxHeaders> headers;
+    Slice content;
+    bool keepAlive;
+
+    unsigned int statusCode;
+    Slice status;
+    FixedBuffer<MaxBytes> storage;
+
+    // Reset to the default-constructed state, ready for the next message.
+    void clear()
+    {
+        versionMajor = 0;
+        versionMinor = 0;
+        headers.clear();
+        content.clear();
+        keepAlive  = false;
+        statusCode = 0;
+        status.clear();
+        storage.reset();
+    }
+
+    // Value of the first header called `key`, ignoring case, or an empty slice if there is none.
+    // There are only a few headers, so this is a scan.
+    Slice header(const HeaderKey& key) const
+    {
+        for (size_t i = 0; i < headers.size(); ++i)
+        {
+            if (key.matches(headers[i]))
+                return headers[i].value;
+        }
+
+        return Slice();
+    }
+
+    bool has(const HeaderKey& key) const
+    {
+        for (size_t i = 0; i < headers.size(); ++i)
+        {
+            if (key.matches(headers[i]))
+                return true;
+        }
 
-                    if (--chunkSize == 0)
-                    {
-                        state = ChunkDataNewLine_1;
-                    }
-                    break;
-                case ChunkDataNewLine_1:
-                    if (input == '\r')
-                    {
-                        state = ChunkDataNewLine_2;
-                    }
-                    else
-                    {
-                        return ParsingError;
-                    }
-                    break;
-                case ChunkDataNewLine_2:
-                    if (input == '\n')
-                    {
-                        state = ChunkSize;
-                    }
-                    else
-                    {
+        return false;
+    }
+
+    template <typename Alloc>
+    void materialize(BasicResponse<Alloc>& resp) const
+    {
+        resp.clear();
+        resp.versionMajor = versionMajor;
+        resp.versionMinor = versionMinor;
+        resp.keepAlive    = keepAlive;
+        resp.statusCode   = statusCode;
+        resp.status.assign(status.data(), status.size());
+
+        for (size_t i = 0; i < headers.size(); ++i)
+        {
+            resp.addHeader().name.assign(headers[i].name.data(), headers[i].name.size());
+            resp.headers.back().value.assign(headers[i].value.data(), headers[i].value.size());
+            resp.headers.back().id = headers[i].id;
+        }
+
+        resp.content.assign(content.begin(), content.end());
+        resp.reindex();
+    }
+
+    Response materialize() const
+    {
+        Response resp;
+        materialize(resp);
+        return resp;
+    }
+
+    std::string inspect() const { return materialize().inspect(); }
+};
+
+}  // namespace httpparser
+
+#endif  // HTTPPARSER_STATICRESPONSE_H
+
+namespace httpparser
+{
+
+// The handler HttpResponseParser uses to fill a Response or a ResponseView.
+template <typename Message>
+class ResponseBuilder : public HttpHandler
+{
+public:
+    explicit ResponseBuilder(Message& resp) : resp(resp) {}
+
+    bool onVersion(int major, int minor)
+    {
+        resp.versionMajor = major;
+        resp.versionMinor = minor;
+        return true;
+    }
+
+    bool onStatusCode(unsigned int code)
+    {
+        resp.statusCode = code;
+        return true;
+    }
+
+    bool onStatus(const char* data, size_t size)
+    {
+        append(resp.status, data, size);
+        return true;
+    }
+
+    bool onHeaderBegin()
+    {
+        typename Message::HeaderItem& h = resp.addHeader();
+        reserve(h.name, 16);
+        reserve(h.value, 16);
+        return true;
+    }
+
+    bool onHeaderField(const char* data, size_t size)
+    {
+        append(resp.headers.back().name, data, size);
+        return true;
+    }
+
+    bool onHeaderId(HeaderId id)
+    {
+        resp.headers.back().id = id;
+        return true;
+    }
+
+    bool onHeaderValue(const char* data, size_t size)
+    {
+        append(resp.headers.back().value, data, size);
+        return true;
+    }
+
+    bool onHeadersComplete(bool keepAlive)
+    {
+        resp.keepAlive = keepAlive;
+        resp.reindex();
+        return true;
+    }
+
+    bool onBody(const char* data, size_t size)
+    {
+        append(resp.content, data, size);
+        return true;
+    }
+
+protected:
+    Message& resp;
+};
+
+// Copies the text of the message into the arena of an ArenaResponse.
+class ArenaResponseBuilder : public ResponseBuilder<ArenaResponse>
+{
+public:
+    explicit ArenaResponseBuilder(ArenaResponse& resp) : ResponseBuilder<ArenaResponse>(resp) {}
+
+    bool onStatus(const char* data, size_t size)
+    {
+        resp.arena.append(resp.status, data, size);
+        return true;
+    }
+
+    bool onHeaderField(const char* data, size_t size)
+    {
+        resp.arena.append(resp.headers.back().name, data, size);
+        return true;
+    }
+
+    bool onHeaderValue(const char* data, size_t size)
+    {
+        resp.arena.append(resp.headers.back().value, data, size);
+        return true;
+    }
+
+    bool onBody(const char* data, size_t size)
+    {
+        resp.arena.append(resp.content, data, size);
+        return true;
+    }
+};
+
+// Fills a StaticResponse, failing instead of growing once its capacity is used up.
+template <typename Message>
+class StaticResponseBuilder : public HttpHandler
+{
+public:
+    explicit StaticResponseBuilder(Message& resp) : resp(resp), full(false) {}
+
+    bool onVersion(int major, int minor)
+    {
+        resp.versionMajor = major;
+        resp.versionMinor = minor;
+        return true;
+    }
+
+    bool onStatusCode(unsigned int code)
+    {
+        resp.statusCode = code;
+        return true;
+    }
+
+    bool onStatus(const char* data, size_t size) { return store(resp.status, data, size); }
+
+    bool onHeaderBegin() { return fits(resp.headers.push_back(typename Message::HeaderItem())); }
+
+    bool onHeaderField(const char* data, size_t size) { return store(resp.headers.back().name, data, size); }
+
+    bool onHeaderId(HeaderId id)
+    {
+        resp.headers.back().id = id;
+        return true;
+    }
+
+    bool onHeaderValue(const char* data, size_t size) { return store(resp.headers.back().value, data, size); }
+
+    bool onHeadersComplete(bool keepAlive)
+    {
+        resp.keepAlive = keepAlive;
+        return true;
+    }
+
+    bool onBody(const char* data, size_t size) { return store(resp.content, data, size); }
+
+    // Whether parsing stopped because the message ran out of capacity.
+    bool overflowed() const { return full; }
+
+private:
+    bool store(Slice& s, const char* data, size_t size) { return fits(resp.storage.append(s, data, size)); }
+
+    bool fits(bool stored)
+    {
+        full = !stored;
+        return stored;
+    }
+
+    Message& resp;
+    bool full;
+};
+
+// Fills the start line and the headers of a Response but hands the body over to `BodySink`, any
+// callable as bool(const char* data, size_t size), instead of accumulating it in content.
+template <typename Message, typename BodySink>
+class StreamingResponseBuilder : public ResponseBuilder<Message>
+{
+public:
+    StreamingResponseBuilder(Message& resp, BodySink& body) : ResponseBuilder<Message>(resp), body(body) {}
+
+    bool onBody(const char* data, size_t size) { return body(data, size); }
+
+private:
+    BodySink& body;
+};
+
+class HttpResponseParser : public HttpParserBase<HttpResponseParser>
+{
+public:
+    explicit HttpResponseParser(const ParserLimits& limits = ParserLimits())
+        : HttpParserBase<HttpResponseParser>(limits), noBody(false), tunnel(false)
+    {
+        resetStartLine();
+    }
+
+    using HttpParserBase<HttpResponseParser>::parse;
+
+    // The method of the request the next responses answer, which decides how they are framed: a
+    // response to HEAD never has a body, a 2xx response to CONNECT ends with its headers and the
+    // connection becomes a tunnel. It stays in effect over reset() until it is changed.
+    void setRequestMethod(Method method)
+    {
+        noBody = method == MethodHead;
+        tunnel = method == MethodConnect;
+    }
+
+    void setRequestMethod(const char* method) { setRequestMethod(methodId(method, strlen(method))); }
+
+    // Tell that the next responses have no body whatever their headers say, or undo that.
+    void setBodyExpected(bool expected) { noBody = !expected; }
+
+    template <typename Alloc>
+    ParseResult parse(BasicResponse<Alloc>& resp, const char* begin, const char* end)
+    {
+        ResponseBuilder<BasicResponse<Alloc> > builder(resp);
+        return consume(builder, begin, end);
+    }
+
+    // Zero-copy parsing, see responseview.h for the buffer lifetime contract.
+    ParseResult parse(ResponseView& resp, const char* begin, const char* end)
+    {
+        ResponseBuilder<ResponseView> builder(resp);
+        return consume(builder, begin, end);
+    }
+
+    // Copy the message into the arena of `resp`, see arenaresponse.h.
+    ParseResult parse(ArenaResponse& resp, const char* begin, const char* end)
+    {
+        ArenaResponseBuilder builder(resp);
+        return consume(builder, begin, end);
+    }
+
+    // Parse into inline storage only, ParsingTooLarge if the message does not fit.
+    template <size_t MaxHeaders, size_t MaxBytes>
+    ParseResult parse(StaticResponse<MaxHeaders, MaxBytes>& resp, const char* begin, const char* end)
+    {
+        StaticResponseBuilder<StaticResponse<MaxHeaders, MaxBytes> > builder(resp);
+        ParseResult res = consume(builder, begin, end);
+        return builder.overflowed() ? tooLarge(CapacityExceeded) : res;
+    }
+
+    // Stream the body to `body` as it arrives instead of storing it in resp.content, so memory
+    // does not grow with the body size. Returning false from `body` stops parsing with ParsingError.
+    template <typename Alloc, typename BodySink>
+    ParseResult parse(BasicResponse<Alloc>& resp, BodySink& body, const char* begin, const char* end)
+    {
+        StreamingResponseBuilder<BasicResponse<Alloc>, BodySink> builder(resp, body);
+        return consume(builder, begin, end);
+    }
+
+    // Same as above, but also report in `consumed` how many bytes of [begin, end) were used. Once
+    // the message is completed, the rest of the buffer is the start of the next pipelined message.
+    template <typename Alloc>
+    ParseResult parse(BasicResponse<Alloc>& resp, const char* begin, const char* end, size_t& consumed)
+    {
+        ResponseBuilder<BasicResponse<Alloc> > builder(resp);
+        return parse(builder, begin, end, consumed);
+    }
+
+    ParseResult parse(ResponseView& resp, const char* begin, const char* end, size_t& consumed)
+    {
+        ResponseBuilder<ResponseView> builder(resp);
+        return parse(builder, begin, end, consumed);
+    }
+
+    ParseResult parse(ArenaResponse& resp, const char* begin, const char* end, size_t& consumed)
+    {
+        ArenaResponseBuilder builder(resp);
+        return parse(builder, begin, end, consumed);
+    }
+
+    template <size_t MaxHeaders, size_t MaxBytes>
+    ParseResult parse(StaticResponse<MaxHeaders, MaxBytes>& resp, const char* begin, const char* end, size_t& consumed)
+    {
+        StaticResponseBuilder<StaticResponse<MaxHeaders, MaxBytes> > builder(resp);
+        ParseResult res = parse(builder, begin, end, consumed);
+        return builder.overflowed() ? tooLarge(CapacityExceeded) : res;
+    }
+
+    template <typename Alloc, typename BodySink>
+    ParseResult parse(BasicResponse<Alloc>& resp, BodySink& body, const char* begin, const char* end, size_t& consumed)
+    {
+        StreamingResponseBuilder<BasicResponse<Alloc>, BodySink> builder(resp, body);
+        return parse(builder, begin, end, consumed);
+    }
+
+private:
+    friend class HttpParserBase<HttpResponseParser>;
+
+    template <typename Handler>
+    ParseResult consumeStartLine(Handler& handler, const char* pos, const char*& begin, const char* end,
+                                 const char*& mark)
+    {
+        char input = *pos;
+
+        switch (startLineState)
+        {
+        case ResponseStatusStart:
+            // "HTTP/1.1 " at once, the states below handle anything else and split buffers.
+            if (end - pos >= 9 && pos[8] == ' ' && matchVersion(pos))
+            {
+                if (!handler.onVersion(versionMajor, versionMinor))
+                    return ParsingError;
+
+                startLineState = ResponseHttpVersion_statusCodeStart;
+                statusCode     = 0;
+                begin          = pos + 9;
+                break;
+            }
+
+            if (input != 'H')
+            {
+                return ParsingError;
+            }
+            else
+            {
+                startLineState = ResponseHttpVersion_ht;
+            }
+            break;
+        case ResponseHttpVersion_ht:
+            if (input == 'T')
+            {
+                startLineState = ResponseHttpVersion_htt;
+            }
+            else
+            {
+                return ParsingError;
+            }
+            break;
+        case ResponseHttpVersion_htt:
+            if (input == 'T')
+            {
+                startLineState = ResponseHttpVersion_http;
+            }
+            else
+            {
+                return ParsingError;
+            }
+            break;
+        case ResponseHttpVersion_http:
+            if (input == 'P')
+            {
+                startLineState = ResponseHttpVersion_slash;
+            }
+            else
+            {
+                return ParsingError;
+            }
+            break;
+        case ResponseHttpVersion_slash:
+            if (input == '/')
+            {
+                versionMajor   = 0;
+                versionMinor   = 0;
+                startLineState = ResponseHttpVersion_majorStart;
+            }
+            else
+            {
+                return ParsingError;
+            }
+            break;
+        case ResponseHttpVersion_majorStart:
+            if (isDigit(input))
+            {
+                versionMajor   = input - '0';
+                startLineState = ResponseHttpVersion_major;
+            }
+            else
+            {
+                return ParsingError;
+            }
+            break;
+        case ResponseHttpVersion_major:
+            if (input == '.')
+            {
+                startLineState = ResponseHttpVersion_minorStart;
+            }
+            else
+            {
+                return ParsingError;
+            }
+            break;
+        case ResponseHttpVersion_minorStart:
+            if (isDigit(input))
+            {
+                versionMinor   = input - '0';
+                startLineState = ResponseHttpVersion_minor;
+            }
+            else
+            {
+                return ParsingError;
+            }
+            break;
+        case ResponseHttpVersion_minor:
+            if (input == ' ')
+            {
+                if (!handler.onVersion(versionMajor, versionMinor))
+                    return ParsingError;
+
+                startLineState = ResponseHttpVersion_statusCodeStart;
+                statusCode     = 0;
+            }
+            else
+            {
+                return ParsingError;
+            }
+            break;
+        case ResponseHttpVersion_statusCodeStart:
+            // RFC 9112: exactly three digits. Codes start at 100, so a leading zero can only
+            // pad one.
+            if (isDigit(input) && input != '0')
+            {
+                statusCode     = input - '0';
+                startLineState = ResponseHttpVersion_statusCode;
+            }
+            else
+            {
+                return ParsingError;
+            }
+            break;
+        case ResponseHttpVersion_statusCode:
+            if (isDigit(input))
+            {
+                if (statusCode >= 100)
+                    return ParsingError;
+
+                statusCode = statusCode * 10 + input - '0';
+            }
+            else
+            {
+                if (statusCode < 100)
+                {
+                    return ParsingError;
+                }
+                else if (input == ' ')
+                {
+                    if (!handler.onStatusCode(statusCode))
                         return ParsingError;
-                    }
-                    break;
-                default:
+
+                    bodyAllowed    = bodyExpected();
+                    startLineState = ResponseHttpVersion_statusTextStart;
+                }
+                else
+                {
                     return ParsingError;
                 }
             }
+            break;
+        case ResponseHttpVersion_statusTextStart:
+            if (isPhraseChar(input))
+            {
+                startLineState = ResponseHttpVersion_statusText;
+                mark           = pos;
+            }
+            else
+            {
+                return ParsingError;
+            }
+            break;
+        case ResponseHttpVersion_statusText:
+            if (input == '\r')
+            {
+                if (!emit(handler, mark, pos - mark))
+                    return ParsingError;
+
+                state = StartLineNewLine;
+            }
+            else if (!isPhraseChar(input))
+            {
+                // The bytes so far count against the limits first, as in a split buffer.
+                emit(handler, mark, pos - mark);
+                return ParsingError;
+            }
+            break;
+        default:
+            return ParsingError;
+        }
+
+        return ParsingIncompleted;
+    }
+
+    template <typename Handler>
+    bool emitStartLine(Handler& handler, const char* p, size_t n)
+    {
+        switch (startLineState)
+        {
+        case ResponseHttpVersion_statusText:
+            return countHeaderBytes(n) && handler.onStatus(p, n);
+        default:
+            return true;
+        }
+    }
+
+    void resetStartLine()
+    {
+        startLineState = ResponseStatusStart;
+        statusCode     = 0;
+    }
+
+    bool startLineStarted() const { return startLineState != ResponseStatusStart; }
+
+    // An HTTP/1.0 style response body without Content-Length or chunked encoding.
+    static const bool closeDelimited = true;
+
+    // Whether a response with this status to the current request may have a body.
+    bool bodyExpected() const
+    {
+        if (noBody || statusCode < 200 || statusCode == 204 || statusCode == 304)
+            return false;
+
+        return !(tunnel && statusCode < 300);
+    }
 
-            return ParsingIncompleted;
-        }
+    // The state of the parser within the status line.
+    enum StartLineState
+    {
+        ResponseStatusStart,
+        ResponseHttpVersion_ht,
+        ResponseHttpVersion_htt,
+        ResponseHttpVersion_http,
+        ResponseHttpVersion_slash,
+        ResponseHttpVersion_majorStart,
+        ResponseHttpVersion_major,
+        ResponseHttpVersion_minorStart,
+        ResponseHttpVersion_minor,
+        ResponseHttpVersion_statusCodeStart,
+        ResponseHttpVersion_statusCode,
+        ResponseHttpVersion_statusTextStart,
+        ResponseHttpVersion_statusText,
+    } startLineState;
 
-        // Check if a byte is an HTTP character.
-        inline bool isChar(int c) { return c >= 0 && c <= 127; }
+    unsigned int statusCode;
+    bool noBody;
+    bool tunnel;
+};
 
-        // Check if a byte is an HTTP control character.
-        inline bool isControl(int c) { return (c >= 0 && c <= 31) || (c == 127); }
+}  // namespace httpparser
 
-        // Check if a byte is defined as an HTTP special character.
-        inline bool isSpecial(int c)
-        {
-            switch (c)
-            {
-            case '(':
-            case ')':
-            case '<':
-            case '>':
-            case '@':
-            case ',':
-            case ';':
-            case ':':
-            case '\\':
-            case '"':
-            case '/':
-            case '[':
-            case ']':
-            case '?':
-            case '=':
-            case '{':
-            case '}':
-            case ' ':
-            case '\t':
-                return true;
-            default:
-                return false;
-            }
-        }
+#endif  // HTTPPARSER_RESPONSEPARSER_H
+#ifndef HTTPPARSER_URLPARSER_H
+#define HTTPPARSER_URLPARSER_H
 
-        // Check if a byte is a digit.
-        inline bool isDigit(int c) { return c >= '0' && c <= '9'; }
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string>
 
-        // The current state of the parser.
-        enum State
-        {
-            ResponseStatusStart,
-            ResponseHttpVersion_ht,
-            ResponseHttpVersion_htt,
-            ResponseHttpVersion_http,
-            ResponseHttpVersion_slash,
-            ResponseHttpVersion_majorStart,
-            ResponseHttpVersion_major,
-            ResponseHttpVersion_minorStart,
-            ResponseHttpVersion_minor,
-            ResponseHttpVersion_statusCodeStart,
-            ResponseHttpVersion_statusCode,
-            ResponseHttpVersion_statusTextStart,
-            ResponseHttpVersion_statusText,
-            ResponseHttpVersion_newLine,
-            HeaderLineStart,
-            HeaderLws,
-            HeaderName,
-            SpaceBeforeHeaderValue,
-            HeaderValue,
-            ExpectingNewline_2,
-            ExpectingNewline_3,
-            Post,
-            ChunkSize,
-            ChunkExtensionName,
-            ChunkExtensionValue,
-            ChunkSizeNewLine,
-            ChunkSizeNewLine_2,
-            ChunkSizeNewLine_3,
-            ChunkTrailerName,
-            ChunkTrailerValue,
-
-            ChunkDataNewLine_1,
-            ChunkDataNewLine_2,
-            ChunkData,
-        } state;
-
-        size_t contentSize;
-        std::string chunkSizeStr;
-        size_t chunkSize;
-        bool chunked;
-    };
 
-    class UrlParser
+namespace httpparser
+{
+
+class UrlParser
+{
+public:
+    UrlParser() : valid(false) {}
+
+    explicit UrlParser(const std::string& url) : valid(true) { parse(url); }
+
+    bool parse(const std::string& str)
     {
-    public:
-        UrlParser() : valid(false) {}
+        url.clear();
+        parse_(str);
 
-        explicit UrlParser(const std::string& url) : valid(true) { parse(url); }
+        return isValid();
+    }
 
-        bool parse(const std::string& str)
-        {
-            url = Url();
-            parse_(str);
+    bool isValid() const { return valid; }
 
-            return isValid();
-        }
+    std::string scheme() const
+    {
+        assert(isValid());
+        return url.scheme;
+    }
 
-        bool isValid() const { return valid; }
+    std::string username() const
+    {
+        assert(isValid());
+        return url.username;
+    }
 
-        std::string scheme() const
-        {
-            assert(isValid());
-            return url.scheme;
-        }
+    std::string password() const
+    {
+        assert(isValid());
+        return url.password;
+    }
 
-        std::string username() const
-        {
-            assert(isValid());
-            return url.username;
-        }
+    std::string hostname() const
+    {
+        assert(isValid());
+        return url.hostname;
+    }
 
-        std::string password() const
-        {
-            assert(isValid());
-            return url.password;
-        }
+    std::string port() const
+    {
+        assert(isValid());
+        return url.port;
+    }
 
-        std::string hostname() const
-        {
-            assert(isValid());
-            return url.hostname;
-        }
+    std::string path() const
+    {
+        assert(isValid());
+        return url.path;
+    }
 
-        std::string port() const
-        {
-            assert(isValid());
-            return url.port;
-        }
+    std::string query() const
+    {
+        assert(isValid());
+        return url.query;
+    }
 
-        std::string path() const
-        {
-            assert(isValid());
-            return url.path;
-        }
+    std::string fragment() const
+    {
+        assert(isValid());
+        return url.fragment;
+    }
+
+    uint16_t httpPort() const
+    {
+        const uint16_t defaultHttpPort  = 80;
+        const uint16_t defaultHttpsPort = 443;
+
+        assert(isValid());
 
-        std::string query() const
+        if (url.port.empty())
         {
-            assert(isValid());
-            return url.query;
+            if (scheme() == "https")
+                return defaultHttpsPort;
+            else
+                return defaultHttpPort;
         }
-
-        std::string fragment() const
+        else
         {
-            assert(isValid());
-            return url.fragment;
+            return url.integerPort;
         }
+    }
 
-        uint16_t httpPort() const
+private:
+    void parse_(const std::string& str)
+    {
+        enum
         {
-            const uint16_t defaultHttpPort  = 80;
-            const uint16_t defaultHttpsPort = 443;
+            Scheme,
+            SlashAfterScheme1,
+            SlashAfterScheme2,
+            UsernameOrHostname,
+            Password,
+            Hostname,
+            IPV6Hostname,
+            PortOrPassword,
+            Port,
+            Path,
+            Query,
+            Fragment
+        } state = Scheme;
 
-            assert(isValid());
+        usernameOrHostname.clear();
+        portOrPassword.clear();
 
-            if (url.port.empty())
-            {
-                if (scheme() == "https")
-                    return defaultHttpsPort;
-                else
-                    return defaultHttpPort;
-            }
-            else
-            {
-                return url.integerPort;
-            }
-        }
+        valid           = true;
+        url.path        = "/";
+        url.integerPort = 0;
 
-    private:
-        bool isUnreserved(char ch) const
+        for (size_t i = 0; i < str.size() && valid; ++i)
         {
-            if (isalnum(ch))
-                return true;
+            char ch = str[i];
 
-            switch (ch)
+            switch (state)
             {
-            case '-':
-            case '.':
-            case '_':
-            case '~':
-                return true;
+            case Scheme:
+                if (isSchemeChar(ch))
+                {
+                    url.scheme += ch;
+                }
+                else if (ch == ':')
+                {
+                    state = SlashAfterScheme1;
+                }
+                else
+                {
+                    valid = false;
+                    url.clear();
+                }
+                break;
+            case SlashAfterScheme1:
+                if (ch == '/')
+                {
+                    state = SlashAfterScheme2;
+                }
+                else if (isAlnum(ch))
+                {
+                    usernameOrHostname = ch;
+                    state              = UsernameOrHostname;
+                }
+                else
+                {
+                    valid = false;
+                    url.clear();
+                }
+                break;
+            case SlashAfterScheme2:
+                if (ch == '/')
+                {
+                    state = UsernameOrHostname;
+                }
+                else
+                {
+                    valid = false;
+                    url.clear();
+                }
+                break;
+            case UsernameOrHostname:
+                if (isUnreserved(ch) || ch == '%')
+                {
+                    usernameOrHostname += ch;
+                }
+                else if (ch == ':')
+                {
+                    state = PortOrPassword;
+                }
+                else if (ch == '@')
+                {
+                    state = Hostname;
+                    std::swap(url.username, usernameOrHostname);
+                }
+                else if (ch == '/')
+                {
+                    state = Path;
+                    std::swap(url.hostname, usernameOrHostname);
+                }
+                else
+                {
+                    valid = false;
+                    url.clear();
+                }
+                break;
+            case Password:
+                if (isAlnum(ch) || ch == '%')
+                {
+                    url.password += ch;
+                }
+                else if (ch == '@')
+                {
+                    state = Hostname;
+                }
+                else
+                {
+                    valid = false;
+                    url.clear();
+                }
+                break;
+            case Hostname:
+                if (ch == '[' && url.hostname.empty())
+                {
+                    state = IPV6Hostname;
+                }
+                else if (isUnreserved(ch) || ch == '%')
+                {
+                    url.hostname += ch;
+                }
+                else if (ch == ':')
+                {
+                    state = Port;
+                }
+                else if (ch == '/')
+                {
+                    state = Path;
+                }
+                else
+                {
+                    valid = false;
+                    url.clear();
+                }
+                break;
+            case IPV6Hostname:
+                abort();  // TODO
+            case PortOrPassword:
+                if (isDigit(ch))
+                {
+                    portOrPassword += ch;
+                }
+                else if (ch == '/')
+                {
+                    std::swap(url.hostname, usernameOrHostname);
+                    std::swap(url.port, portOrPassword);
+                    url.integerPort = atoi(url.port.c_str());
+                    state           = Path;
+                }
+                else if (isAlnum(ch) || ch == '%')
+                {
+                    std::swap(url.username, usernameOrHostname);
+                    std::swap(url.password, portOrPassword);
+                    url.password += ch;
+                    state = Password;
+                }
+                else
+                {
+                    valid = false;
+                    url.clear();
+                }
+                break;
+            case Port:
+                if (isDigit(ch))
+                {
+                    portOrPassword += ch;
+                }
+                else if (ch == '/')
+                {
+                    std::swap(url.port, portOrPassword);
+                    url.integerPort = atoi(url.port.c_str());
+                    state           = Path;
+                }
+                else
+                {
+                    valid = false;
+                    url.clear();
+                }
+                break;
+            case Path:
+                if (ch == '#')
+                {
+                    state = Fragment;
+                }
+                else if (ch == '?')
+                {
+                    state = Query;
+                }
+                else
+                {
+                    url.path += ch;
+                }
+                break;
+            case Query:
+                if (ch == '#')
+                {
+                    state = Fragment;
+                }
+                else if (ch == '?')
+                {
+                    state = Query;
+                }
+                else
+                {
+                    url.query += ch;
+                }
+                break;
+            case Fragment:
+                url.fragment += ch;
+                break;
             }
-
-            return false;
         }
 
-        void parse_(const std::string& str)
-        {
-            enum
-            {
-                Scheme,
-                SlashAfterScheme1,
-                SlashAfterScheme2,
-                UsernameOrHostname,
-                Password,
-                Hostname,
-                IPV6Hostname,
-                PortOrPassword,
-                Port,
-                Path,
-                Query,
-                Fragment
-            } state = Scheme;
-
-            std::string usernameOrHostname;
-            std::string portOrPassword;
-
-            valid           = true;
-            url.path        = "/";
-            url.integerPort = 0;
+        assert(portOrPassword.empty());
 
-            for (size_t i = 0; i < str.size() && valid; ++i)
-            {
-                char ch = str[i];
+        if (!usernameOrHostname.empty())
+            url.hostname = usernameOrHostname;
+    }
 
-                switch (state)
-                {
-                case Scheme:
-                    if (isalnum(ch) || ch == '+' || ch == '-' || ch == '.')
-                    {
-                        url.scheme += ch;
-                    }
-                    else if (ch == ':')
-                    {
-                        state = SlashAfterScheme1;
-                    }
-                    else
-                    {
-                        valid = false;
-                        url   = Url();
-                    }
-                    break;
-                case SlashAfterScheme1:
-                    if (ch == '/')
-                    {
-                        state = SlashAfterScheme2;
-                    }
-                    else if (isalnum(ch))
-                    {
-                        usernameOrHostname = ch;
-                        state              = UsernameOrHostname;
-                    }
-                    else
-                    {
-                        valid = false;
-                        url   = Url();
-                    }
-                    break;
-                case SlashAfterScheme2:
-                    if (ch == '/')
-                    {
-                        state = UsernameOrHostname;
-                    }
-                    else
-                    {
-                        valid = false;
-                        url   = Url();
-                    }
-                    break;
-                case UsernameOrHostname:
-                    if (isUnreserved(ch) || ch == '%')
-                    {
-                        usernameOrHostname += ch;
-                    }
-                    else if (ch == ':')
-                    {
-                        state = PortOrPassword;
-                    }
-                    else if (ch == '@')
-                    {
-                        state = Hostname;
-                        std::swap(url.username, usernameOrHostname);
-                    }
-                    else if (ch == '/')
-                    {
-                        state = Path;
-                        std::swap(url.hostname, usernameOrHostname);
-                    }
-                    else
-                    {
-                        valid = false;
-                        url   = Url();
-                    }
-                    break;
-                case Password:
-                    if (isalnum(ch) || ch == '%')
-                    {
-                        url.password += ch;
-                    }
-                    else if (ch == '@')
-                    {
-                        state = Hostname;
-                    }
-                    else
-                    {
-                        valid = false;
-                        url   = Url();
-                    }
-                    break;
-                case Hostname:
-                    if (ch == '[' && url.hostname.empty())
-                    {
-                        state = IPV6Hostname;
-                    }
-                    else if (isUnreserved(ch) || ch == '%')
-                    {
-                        url.hostname += ch;
-                    }
-                    else if (ch == ':')
-                    {
-                        state = Port;
-                    }
-                    else if (ch == '/')
-                    {
-                        state = Path;
-                    }
-                    else
-                    {
-                        valid = false;
-                        url   = Url();
-                    }
-                    break;
-                case IPV6Hostname:
-                    abort();  // TODO
-                case PortOrPassword:
-                    if (isdigit(ch))
-                    {
-                        portOrPassword += ch;
-                    }
-                    else if (ch == '/')
-                    {
-                        std::swap(url.hostname, usernameOrHostname);
-                        std::swap(url.port, portOrPassword);
-                        url.integerPort = atoi(url.port.c_str());
-                        state           = Path;
-                    }
-                    else if (isalnum(ch) || ch == '%')
-                    {
-                        std::swap(url.username, usernameOrHostname);
-                        std::swap(url.password, portOrPassword);
-                        url.password += ch;
-                        state = Password;
-                    }
-                    else
-                    {
-                        valid = false;
-                        url   = Url();
-                    }
-                    break;
-                case Port:
-                    if (isdigit(ch))
-                    {
-                        portOrPassword += ch;
-                    }
-                    else if (ch == '/')
-                    {
-                        std::swap(url.port, portOrPassword);
-                        url.integerPort = atoi(url.port.c_str());
-                        state           = Path;
-                    }
-                    else
-                    {
-                        valid = false;
-                        url   = Url();
-                    }
-                    break;
-                case Path:
-                    if (ch == '#')
-                    {
-                        state = Fragment;
-                    }
-                    else if (ch == '?')
-                    {
-                        state = Query;
-                    }
-                    else
-                    {
-                        url.path += ch;
-                    }
-                    break;
-                case Query:
-                    if (ch == '#')
-                    {
-                        state = Fragment;
-                    }
-                    else if (ch == '?')
-                    {
-                        state = Query;
-                    }
-                    else
-                    {
-                        url.query += ch;
-                    }
-                    break;
-                case Fragment:
-                    url.fragment += ch;
-                    break;
-                }
-            }
+    bool valid;
 
-            assert(portOrPassword.empty());
+    struct Url
+    {
+        Url() : integerPort(0) {}
 
-            if (!usernameOrHostname.empty())
-                url.hostname = usernameOrHostname;
+        // Empty every part but keep the storage, so parsing the next url allocates nothing
+        // unless it has a longer part.
+        void clear()
+        {
+            scheme.clear();
+            username.clear();
+            password.clear();
+            hostname.clear();
+            port.clear();
+            path.clear();
+            query.clear();
+            fragment.clear();
+            integerPort = 0;
         }
 
-        bool valid;
+        std::string scheme;
+        std::string username;
+        std::string password;
+        std::string hostname;
+        std::string port;
+        std::string path;
+        std::string query;
+        std::string fragment;
+        uint16_t integerPort;
+    } url;
 
-        struct Url
-        {
-            Url() : integerPort(0) {}
-
-            std::string scheme;
-            std::string username;
-            std::string password;
-            std::string hostname;
-            std::string port;
-            std::string path;
-            std::string query;
-            std::string fragment;
-            uint16_t integerPort;
-        } url;
-    };
+    // Scratch for the parts that are only told apart later, swapped with parts of `url`.
+    std::string usernameOrHostname;
+    std::string portOrPassword;
 };
 
-}  // namespace httpparser
\ No newline at end of file
+}  // namespace httpparser
+
+#endif  // HTTPPARSER_URLPARSER_H
+
+#endif  // HTTPPARSER_HTTPPARSER_H
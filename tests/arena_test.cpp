@@ -0,0 +1,116 @@
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+#include <httpparser/arena.h>
+#include <httpparser/arenarequest.h>
+#include <httpparser/arenaresponse.h>
+#include <httpparser/httprequestparser.h>
+#include <httpparser/httpresponseparser.h>
+
+#include <string>
+
+BOOST_AUTO_TEST_SUITE(Arenas)
+
+using httpparser::Arena;
+using httpparser::ArenaRequest;
+using httpparser::ArenaResponse;
+using httpparser::HeaderHost;
+using httpparser::HttpRequestParser;
+using httpparser::HttpResponseParser;
+using httpparser::Request;
+using httpparser::Response;
+using httpparser::Slice;
+
+BOOST_AUTO_TEST_CASE(slices_stay_contiguous_across_blocks)
+{
+    Arena arena(8);
+    Slice a, b;
+
+    arena.append(a, "0123", 4);
+    arena.append(a, "4567", 4);
+    arena.append(b, "abc", 3);
+    arena.append(b, "defghijk", 8);
+
+    BOOST_CHECK(a == "01234567");
+    BOOST_CHECK(b == "abcdefghijk");
+
+    std::vector<Slice> v;
+    arena.append(v, "xy", 2);
+    arena.append(v, "z", 1);
+    BOOST_REQUIRE_EQUAL(v.size(), 1u);
+    BOOST_CHECK(v[0] == "xyz");
+
+    size_t capacity = arena.capacity();
+    arena.reset();
+    a.clear();
+    arena.append(a, "01234567", 8);
+    BOOST_CHECK(a == "01234567");
+    BOOST_CHECK_EQUAL(arena.capacity(), capacity);
+}
+
+BOOST_AUTO_TEST_CASE(request_outlives_the_buffer)
+{
+    std::string text = "POST /uri.cgi HTTP/1.1\r\n"
+                       "Host: example.com\r\n"
+                       "Content-Length: 4\r\n"
+                       "\r\n"
+                       "data";
+
+    Request request;
+    ArenaRequest arenaRequest;
+    HttpRequestParser parser, arenaParser;
+
+    BOOST_REQUIRE_EQUAL(parser.parse(request, text.data(), text.data() + text.size()),
+                        HttpRequestParser::ParsingCompleted);
+    BOOST_REQUIRE_EQUAL(arenaParser.parse(arenaRequest, text.data(), text.data() + text.size()),
+                        HttpRequestParser::ParsingCompleted);
+
+    text.assign(text.size(), 'x');
+
+    BOOST_CHECK_EQUAL(arenaRequest.inspect(), request.inspect());
+    BOOST_CHECK(arenaRequest.header(HeaderHost) == "example.com");
+}
+
+BOOST_AUTO_TEST_CASE(small_blocks_and_split_buffers)
+{
+    const char text[] = "HTTP/1.1 200 OK\r\n"
+                        "Server: nginx/1.2.1\r\n"
+                        "Content-Type: text/html\r\n"
+                        "Transfer-Encoding: chunked\r\n"
+                        "\r\n"
+                        "23\r\n"
+                        "This is the data in the first chunk\r\n"
+                        "1A\r\n"
+                        "and this is the second one\r\n"
+                        "0\r\n\r\n";
+    const size_t size = sizeof(text) - 1;
+
+    Response expected;
+    HttpResponseParser expectedParser;
+    BOOST_REQUIRE_EQUAL(expectedParser.parse(expected, text, text + size), HttpResponseParser::ParsingCompleted);
+
+    ArenaResponse response(16);
+    HttpResponseParser parser;
+
+    for (size_t split = 1; split < size; ++split)
+    {
+        std::string first(text, split), second(text + split, size - split);
+
+        response.clear();
+        parser.reset();
+
+        BOOST_REQUIRE_EQUAL(parser.parse(response, first.data(), first.data() + first.size()),
+                            HttpResponseParser::ParsingIncompleted);
+        BOOST_REQUIRE_EQUAL(parser.parse(response, second.data(), second.data() + second.size()),
+                            HttpResponseParser::ParsingCompleted);
+
+        first.assign(first.size(), 'x');
+        second.assign(second.size(), 'x');
+
+        BOOST_CHECK_EQUAL(response.inspect(), expected.inspect());
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
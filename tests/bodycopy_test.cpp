@@ -0,0 +1,92 @@
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+
+#include <httpparser/httprequestparser.h>
+#include <httpparser/httpresponseparser.h>
+#include <httpparser/request.h>
+#include <httpparser/response.h>
+
+BOOST_AUTO_TEST_SUITE(BodyCopy)
+
+using httpparser::HttpRequestParser;
+using httpparser::HttpResponseParser;
+using httpparser::Request;
+using httpparser::Response;
+
+static const size_t bodySize  = 8 * 1024 * 1024;
+static const size_t chunkSize = 4096;
+
+std::string contentLengthRequest()
+{
+    std::ostringstream stream;
+    stream << "POST /upload HTTP/1.1\r\n"
+           << "Content-Length: " << bodySize << "\r\n"
+           << "\r\n"
+           << std::string(bodySize, 'x');
+    return stream.str();
+}
+
+std::string chunkedResponse()
+{
+    std::ostringstream stream;
+    stream << "HTTP/1.1 200 OK\r\n"
+           << "Transfer-Encoding: chunked\r\n"
+           << "\r\n";
+
+    for (size_t i = 0; i < bodySize / chunkSize; ++i)
+        stream << std::hex << chunkSize << "\r\n" << std::string(chunkSize, 'x') << "\r\n";
+
+    stream << "0\r\n\r\n";
+    return stream.str();
+}
+
+// Feed `text` to a fresh parser `step` bytes at a time and return the body it parsed.
+template <typename Parser, typename Message>
+std::string parseBody(const std::string& text, size_t step)
+{
+    Message message;
+    Parser parser;
+    typename Parser::ParseResult res = Parser::ParsingIncompleted;
+
+    const char* begin = text.data();
+    const char* end   = begin + text.size();
+
+    for (const char* p = begin; p < end && res == Parser::ParsingIncompleted; p += step)
+        res = parser.parse(message, p, std::min(p + step, end));
+
+    BOOST_REQUIRE_EQUAL(res, Parser::ParsingCompleted);
+    return std::string(message.content.begin(), message.content.end());
+}
+
+// Byte-at-a-time input goes through the state machine for every body byte, larger buffers
+// through the range copies; both must give the same body. The speed of each is measured by the
+// benchmarks in bench/.
+template <typename Parser, typename Message>
+void check(const std::string& text)
+{
+    std::string bytewise = parseBody<Parser, Message>(text, 1);
+
+    BOOST_CHECK_EQUAL(bytewise.size(), bodySize);
+    BOOST_CHECK(bytewise == std::string(bodySize, 'x'));
+    BOOST_CHECK((parseBody<Parser, Message>(text, text.size()) == bytewise));
+    BOOST_CHECK((parseBody<Parser, Message>(text, 64 * 1024) == bytewise));
+    BOOST_CHECK((parseBody<Parser, Message>(text, 1000) == bytewise));
+}
+
+BOOST_AUTO_TEST_CASE(content_length_body)
+{
+    check<HttpRequestParser, Request>(contentLengthRequest());
+}
+
+BOOST_AUTO_TEST_CASE(chunked_body)
+{
+    check<HttpResponseParser, Response>(chunkedResponse());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
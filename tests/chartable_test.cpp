@@ -0,0 +1,80 @@
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+#include <httpparser/chartable.h>
+#include <httpparser/httprequestparser.h>
+
+#include <string.h>
+
+BOOST_AUTO_TEST_SUITE(CharClasses)
+
+using httpparser::HttpRequestParser;
+using httpparser::isAlnum;
+using httpparser::isDigit;
+using httpparser::isHexDigit;
+using httpparser::isPhraseChar;
+using httpparser::isSchemeChar;
+using httpparser::isText;
+using httpparser::isToken;
+using httpparser::isUnreserved;
+using httpparser::Request;
+
+BOOST_AUTO_TEST_CASE(classes_match_grammar)
+{
+    for (int i = 0; i < 256; ++i)
+    {
+        char c       = static_cast<char>(i);
+        bool ascii   = i < 128;
+        bool alpha   = (i >= 'a' && i <= 'z') || (i >= 'A' && i <= 'Z');
+        bool digit   = i >= '0' && i <= '9';
+        bool control = i <= 31 || i == 127;
+        bool special = i != 0 && strchr("()<>@,;:\\\"/[]?={} \t", i) != NULL;
+
+        BOOST_TEST_CONTEXT("byte " << i)
+        {
+            BOOST_CHECK_EQUAL(isToken(c), ascii && !control && !special);
+            BOOST_CHECK_EQUAL(isText(c), !control);
+            BOOST_CHECK_EQUAL(isPhraseChar(c), !control || i == '\t');
+            BOOST_CHECK_EQUAL(isDigit(c), digit);
+            BOOST_CHECK_EQUAL(isHexDigit(c), digit || (i >= 'a' && i <= 'f') || (i >= 'A' && i <= 'F'));
+            BOOST_CHECK_EQUAL(isAlnum(c), alpha || digit);
+            BOOST_CHECK_EQUAL(isUnreserved(c), alpha || digit || (i != 0 && strchr("-._~", i) != NULL));
+            BOOST_CHECK_EQUAL(isSchemeChar(c), alpha || digit || (i != 0 && strchr("+-.", i) != NULL));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(chunk_size_must_be_hex)
+{
+    const char text[] = "POST / HTTP/1.1\r\n"
+                        "Transfer-Encoding: chunked\r\n"
+                        "\r\n"
+                        "1g\r\n";
+
+    Request request;
+    HttpRequestParser parser;
+
+    BOOST_CHECK_EQUAL(parser.parse(request, text, text + sizeof(text) - 1), HttpRequestParser::ParsingError);
+}
+
+BOOST_AUTO_TEST_CASE(chunk_extension_and_trailer)
+{
+    const char text[] = "POST / HTTP/1.1\r\n"
+                        "Transfer-Encoding: chunked\r\n"
+                        "\r\n"
+                        "4;ext-name=ext-value\r\n"
+                        "data\r\n"
+                        "0\r\n"
+                        "Expires: Wed, 21 Oct 2015 07:28:00 GMT\r\n"
+                        "\r\n";
+
+    Request request;
+    HttpRequestParser parser;
+
+    BOOST_REQUIRE_EQUAL(parser.parse(request, text, text + sizeof(text) - 1), HttpRequestParser::ParsingCompleted);
+    BOOST_CHECK_EQUAL(std::string(request.content.begin(), request.content.end()), "data");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
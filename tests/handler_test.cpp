@@ -0,0 +1,215 @@
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+
+#include <httpparser/httphandler.h>
+#include <httpparser/httprequestparser.h>
+#include <httpparser/httpresponseparser.h>
+
+BOOST_AUTO_TEST_SUITE(Handler)
+
+using httpparser::HttpHandler;
+using httpparser::HttpRequestParser;
+using httpparser::HttpResponseParser;
+
+// Only collects the Host header and counts body bytes.
+struct HostHandler : HttpHandler
+{
+    HostHandler() : inHost(false), bodySize(0), completed(false) {}
+
+    bool onHeaderBegin()
+    {
+        name.clear();
+        inHost = false;
+        return true;
+    }
+
+    bool onHeaderField(const char* data, size_t size)
+    {
+        name.append(data, size);
+        inHost = name == "Host";
+        return true;
+    }
+
+    bool onHeaderValue(const char* data, size_t size)
+    {
+        if (inHost)
+            host.append(data, size);
+        return true;
+    }
+
+    bool onBody(const char*, size_t size)
+    {
+        bodySize += size;
+        return true;
+    }
+
+    bool onMessageComplete()
+    {
+        completed = true;
+        return true;
+    }
+
+    std::string name;
+    std::string host;
+    bool inHost;
+    size_t bodySize;
+    bool completed;
+};
+
+// Records every event as text.
+struct RecordingHandler : HttpHandler
+{
+    bool onMethod(const char* data, size_t size) { return record("method", data, size); }
+    bool onUri(const char* data, size_t size) { return record("uri", data, size); }
+    bool onStatus(const char* data, size_t size) { return record("status", data, size); }
+    bool onHeaderField(const char* data, size_t size) { return record("field", data, size); }
+    bool onHeaderValue(const char* data, size_t size) { return record("value", data, size); }
+    bool onBody(const char* data, size_t size) { return record("body", data, size); }
+
+    bool onStatusCode(unsigned int code)
+    {
+        events.push_back("code " + std::to_string(code));
+        return true;
+    }
+
+    bool onVersion(int major, int minor)
+    {
+        events.push_back("version " + std::to_string(major) + "." + std::to_string(minor));
+        return true;
+    }
+
+    bool onHeaderBegin()
+    {
+        events.push_back("header");
+        return true;
+    }
+
+    bool onHeadersComplete(bool keepAlive)
+    {
+        events.push_back(keepAlive ? "headers keep-alive" : "headers close");
+        return true;
+    }
+
+    bool onMessageComplete()
+    {
+        events.push_back("complete");
+        return true;
+    }
+
+    bool record(const char* event, const char* data, size_t size)
+    {
+        events.push_back(std::string(event) + " " + std::string(data, size));
+        return true;
+    }
+
+    std::vector<std::string> events;
+};
+
+struct RejectingHandler : HttpHandler
+{
+    bool onUri(const char*, size_t) { return false; }
+};
+
+BOOST_AUTO_TEST_CASE(request_events)
+{
+    const char text[] = "POST /uri HTTP/1.1\r\n"
+                        "Host: example.com\r\n"
+                        "Content-Length: 4\r\n"
+                        "\r\n"
+                        "data";
+
+    RecordingHandler handler;
+    HttpRequestParser parser;
+
+    BOOST_REQUIRE_EQUAL(parser.parse(handler, text, text + sizeof(text) - 1), HttpRequestParser::ParsingCompleted);
+
+    const char* should[] = {"method POST",
+                            "uri /uri",
+                            "version 1.1",
+                            "header",
+                            "field Host",
+                            "value example.com",
+                            "header",
+                            "field Content-Length",
+                            "value 4",
+                            "headers keep-alive",
+                            "body data",
+                            "complete"};
+
+    BOOST_CHECK_EQUAL_COLLECTIONS(handler.events.begin(), handler.events.end(), should, should + 12);
+}
+
+BOOST_AUTO_TEST_CASE(response_events)
+{
+    const char text[] = "HTTP/1.0 200 OK\r\n"
+                        "Transfer-Encoding: chunked\r\n"
+                        "\r\n"
+                        "3\r\n"
+                        "con\r\n"
+                        "8\r\n"
+                        "sequence\r\n"
+                        "0\r\n\r\n";
+
+    RecordingHandler handler;
+    HttpResponseParser parser;
+
+    BOOST_REQUIRE_EQUAL(parser.parse(handler, text, text + sizeof(text) - 1), HttpResponseParser::ParsingCompleted);
+
+    const char* should[] = {"version 1.0",
+                            "code 200",
+                            "status OK",
+                            "header",
+                            "field Transfer-Encoding",
+                            "value chunked",
+                            "headers close",
+                            "body con",
+                            "body sequence",
+                            "complete"};
+
+    BOOST_CHECK_EQUAL_COLLECTIONS(handler.events.begin(), handler.events.end(), should, should + 10);
+}
+
+BOOST_AUTO_TEST_CASE(fragments_concatenate_across_parse_calls)
+{
+    const std::string text = "PUT /upload HTTP/1.1\r\n"
+                             "User-Agent: Mozilla/5.0\r\n"
+                             "Host: www.example.com\r\n"
+                             "Content-Length: 10\r\n"
+                             "\r\n"
+                             "0123456789";
+
+    for (size_t step = 1; step < text.size(); ++step)
+    {
+        HostHandler handler;
+        HttpRequestParser parser;
+        HttpRequestParser::ParseResult res = HttpRequestParser::ParsingIncompleted;
+
+        for (size_t i = 0; i < text.size() && res == HttpRequestParser::ParsingIncompleted; i += step)
+        {
+            const char* begin = text.data() + i;
+            res               = parser.parse(handler, begin, begin + std::min(step, text.size() - i));
+        }
+
+        BOOST_REQUIRE_EQUAL(res, HttpRequestParser::ParsingCompleted);
+        BOOST_CHECK_EQUAL(handler.host, "www.example.com");
+        BOOST_CHECK_EQUAL(handler.bodySize, 10u);
+        BOOST_CHECK(handler.completed);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(handler_can_stop_parsing)
+{
+    const char text[] = "GET /uri HTTP/1.1\r\n\r\n";
+
+    RejectingHandler handler;
+    HttpRequestParser parser;
+
+    BOOST_CHECK_EQUAL(parser.parse(handler, text, text + sizeof(text) - 1), HttpRequestParser::ParsingError);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
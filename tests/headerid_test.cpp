@@ -0,0 +1,155 @@
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+#include <httpparser/headerid.h>
+#include <httpparser/httprequestparser.h>
+#include <httpparser/httpresponseparser.h>
+#include <httpparser/staticrequest.h>
+#include <httpparser/staticresponse.h>
+
+#include <new>
+
+#include <ctype.h>
+#include <string.h>
+
+BOOST_AUTO_TEST_SUITE(HeaderIds)
+
+using httpparser::HeaderContentLength;
+using httpparser::HeaderHost;
+using httpparser::HeaderId;
+using httpparser::headerId;
+using httpparser::HeaderIdCount;
+using httpparser::headerName;
+using httpparser::HeaderTransferEncoding;
+using httpparser::HeaderUnknown;
+using httpparser::HttpRequestParser;
+using httpparser::HttpResponseParser;
+using httpparser::Request;
+using httpparser::RequestView;
+using httpparser::Response;
+using httpparser::ResponseView;
+using httpparser::StaticRequest;
+using httpparser::StaticResponse;
+
+BOOST_AUTO_TEST_CASE(every_name_has_its_own_slot)
+{
+    for (int i = HeaderUnknown + 1; i < HeaderIdCount; ++i)
+    {
+        HeaderId id      = static_cast<HeaderId>(i);
+        std::string name = headerName(id);
+
+        BOOST_TEST_CONTEXT(name)
+        {
+            BOOST_CHECK_EQUAL(headerId(name), id);
+
+            for (size_t j = 0; j < name.size(); ++j)
+                name[j] = static_cast<char>(tolower(name[j]));
+            BOOST_CHECK_EQUAL(headerId(name), id);
+
+            for (size_t j = 0; j < name.size(); ++j)
+                name[j] = static_cast<char>(toupper(name[j]));
+            BOOST_CHECK_EQUAL(headerId(name), id);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(unknown_names)
+{
+    BOOST_CHECK_EQUAL(headerId(""), HeaderUnknown);
+    BOOST_CHECK_EQUAL(headerId("X"), HeaderUnknown);
+    BOOST_CHECK_EQUAL(headerId("Hosts"), HeaderUnknown);
+    BOOST_CHECK_EQUAL(headerId("Hos"), HeaderUnknown);
+    BOOST_CHECK_EQUAL(headerId("Content-Lengths"), HeaderUnknown);
+    BOOST_CHECK_EQUAL(headerId("X-Custom-Header"), HeaderUnknown);
+    BOOST_CHECK_EQUAL(headerId("Content-Lenght"), HeaderUnknown);
+}
+
+BOOST_AUTO_TEST_CASE(parser_sets_ids)
+{
+    const char text[] = "POST / HTTP/1.1\r\n"
+                        "host: example.com\r\n"
+                        "X-Custom: 1\r\n"
+                        "CONTENT-LENGTH: 4\r\n"
+                        "\r\n"
+                        "data";
+
+    Request request;
+    HttpRequestParser parser;
+
+    BOOST_REQUIRE_EQUAL(parser.parse(request, text, text + sizeof(text) - 1), HttpRequestParser::ParsingCompleted);
+    BOOST_REQUIRE_EQUAL(request.headers.size(), 3u);
+    BOOST_CHECK_EQUAL(request.headers[0].id, HeaderHost);
+    BOOST_CHECK_EQUAL(request.headers[1].id, HeaderUnknown);
+    BOOST_CHECK_EQUAL(request.headers[2].id, HeaderContentLength);
+    BOOST_CHECK_EQUAL(request.content.size(), 4u);
+
+    RequestView view;
+    parser.reset();
+    BOOST_REQUIRE_EQUAL(parser.parse(view, text, text + sizeof(text) - 1), HttpRequestParser::ParsingCompleted);
+    BOOST_CHECK_EQUAL(view.headers[0].id, HeaderHost);
+    BOOST_CHECK_EQUAL(view.materialize().headers[2].id, HeaderContentLength);
+}
+
+BOOST_AUTO_TEST_CASE(id_of_name_split_across_parse_calls)
+{
+    const char text[] = "HTTP/1.1 200 OK\r\n"
+                        "Transfer-Encoding: chunked\r\n"
+                        "\r\n"
+                        "2\r\nok\r\n0\r\n\r\n";
+    const size_t size = sizeof(text) - 1;
+
+    for (size_t split = 1; split < size; ++split)
+    {
+        Response response;
+        HttpResponseParser parser;
+
+        BOOST_REQUIRE_EQUAL(parser.parse(response, text, text + split), HttpResponseParser::ParsingIncompleted);
+        BOOST_REQUIRE_EQUAL(parser.parse(response, text + split, text + size), HttpResponseParser::ParsingCompleted);
+        BOOST_CHECK_EQUAL(response.headers[0].id, HeaderTransferEncoding);
+        BOOST_CHECK_EQUAL(std::string(response.content.begin(), response.content.end()), "ok");
+    }
+}
+
+BOOST_AUTO_TEST_CASE(cleared_headers_forget_their_id)
+{
+    const char text[] = "GET / HTTP/1.1\r\nHost: a\r\n\r\n";
+
+    Request request;
+    HttpRequestParser parser;
+
+    BOOST_REQUIRE_EQUAL(parser.parse(request, text, text + sizeof(text) - 1), HttpRequestParser::ParsingCompleted);
+    BOOST_REQUIRE_EQUAL(request.headers[0].id, HeaderHost);
+
+    request.clear();
+    BOOST_CHECK_EQUAL(request.addHeader().id, HeaderUnknown);
+}
+
+// Default-initialize an item over garbage, as a local or a new-expression without () would.
+template <typename Item>
+HeaderId defaultId()
+{
+    alignas(Item) unsigned char storage[sizeof(Item)];
+    memset(storage, 0xab, sizeof(storage));
+
+    Item* item  = new (storage) Item;
+    HeaderId id = item->id;
+    item->~Item();
+    return id;
+}
+
+BOOST_AUTO_TEST_CASE(items_start_unknown)
+{
+    BOOST_CHECK_EQUAL(defaultId<Request::HeaderItem>(), HeaderUnknown);
+    BOOST_CHECK_EQUAL(defaultId<Response::HeaderItem>(), HeaderUnknown);
+    BOOST_CHECK_EQUAL(defaultId<RequestView::HeaderItem>(), HeaderUnknown);
+    BOOST_CHECK_EQUAL(defaultId<ResponseView::HeaderItem>(), HeaderUnknown);
+    BOOST_CHECK_EQUAL((defaultId<StaticRequest<4, 64>::HeaderItem>()), HeaderUnknown);
+    BOOST_CHECK_EQUAL((defaultId<StaticResponse<4, 64>::HeaderItem>()), HeaderUnknown);
+
+    Request::HeaderItem item = {"Host", "example.com"};
+    BOOST_CHECK_EQUAL(item.id, HeaderUnknown);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,147 @@
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+#include <httpparser/httprequestparser.h>
+#include <httpparser/httpresponseparser.h>
+
+#include <sstream>
+
+BOOST_AUTO_TEST_SUITE(HeaderIndexing)
+
+using httpparser::HeaderAccept;
+using httpparser::HeaderContentLength;
+using httpparser::HeaderCookie;
+using httpparser::HeaderHost;
+using httpparser::HeaderUnknown;
+using httpparser::HttpRequestParser;
+using httpparser::HttpResponseParser;
+using httpparser::ParserLimits;
+using httpparser::Request;
+using httpparser::RequestView;
+using httpparser::Response;
+
+static const char text[] = "GET / HTTP/1.1\r\n"
+                           "Host: example.com\r\n"
+                           "Accept: text/html\r\n"
+                           "X-Trace: one\r\n"
+                           "accept: application/json\r\n"
+                           "x-trace: two\r\n"
+                           "X-TRACE: three\r\n"
+                           "\r\n";
+
+BOOST_AUTO_TEST_CASE(request_lookups)
+{
+    Request request;
+    HttpRequestParser parser;
+
+    BOOST_REQUIRE_EQUAL(parser.parse(request, text, text + sizeof(text) - 1), HttpRequestParser::ParsingCompleted);
+
+    BOOST_CHECK_EQUAL(request.header("host"), "example.com");
+    BOOST_CHECK_EQUAL(request.header(HeaderHost), "example.com");
+    BOOST_CHECK_EQUAL(request.header(std::string("ACCEPT")), "text/html");
+    BOOST_CHECK_EQUAL(request.header("x-trace"), "one");
+    BOOST_CHECK_EQUAL(request.header("Cookie"), "");
+    BOOST_CHECK_EQUAL(request.header("X-Missing"), "");
+
+    BOOST_CHECK(request.has("Host"));
+    BOOST_CHECK(request.has(HeaderAccept));
+    BOOST_CHECK(!request.has(HeaderCookie));
+    BOOST_CHECK(!request.has("X-Trac"));
+
+    std::vector<const Request::HeaderItem*> traces = request.findAll("X-Trace");
+    BOOST_REQUIRE_EQUAL(traces.size(), 3u);
+    BOOST_CHECK_EQUAL(traces[0]->value, "one");
+    BOOST_CHECK_EQUAL(traces[1]->value, "two");
+    BOOST_CHECK_EQUAL(traces[2]->value, "three");
+
+    std::vector<const Request::HeaderItem*> accepts = request.findAll(HeaderAccept);
+    BOOST_REQUIRE_EQUAL(accepts.size(), 2u);
+    BOOST_CHECK_EQUAL(accepts[1]->value, "application/json");
+
+    BOOST_CHECK(request.findAll("Cookie").empty());
+}
+
+BOOST_AUTO_TEST_CASE(many_headers_grow_the_index)
+{
+    std::ostringstream message;
+    message << "HTTP/1.1 200 OK\r\n";
+    for (int i = 0; i < 100; ++i)
+        message << "X-Header-" << i << ": " << i << "\r\n";
+    message << "Content-Length: 0\r\n\r\n";
+    std::string str = message.str();
+
+    ParserLimits limits;
+    limits.maxHeaderCount = 200;
+
+    Response response;
+    HttpResponseParser parser(limits);
+
+    BOOST_REQUIRE_EQUAL(parser.parse(response, str.data(), str.data() + str.size()),
+                        HttpResponseParser::ParsingCompleted);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        std::ostringstream name, value;
+        name << "x-header-" << i;
+        value << i;
+        BOOST_CHECK_EQUAL(response.header(name.str()), value.str());
+    }
+    BOOST_CHECK_EQUAL(response.header(HeaderContentLength), "0");
+}
+
+BOOST_AUTO_TEST_CASE(headers_edited_by_hand)
+{
+    Request request;
+    HttpRequestParser parser;
+
+    BOOST_REQUIRE_EQUAL(parser.parse(request, text, text + sizeof(text) - 1), HttpRequestParser::ParsingCompleted);
+
+    // Not indexed yet, found by a scan.
+    Request::HeaderItem& cookie = request.addHeader();
+    cookie.name                 = "Cookie";
+    cookie.value                = "a=b";
+    BOOST_CHECK_EQUAL(request.header(HeaderCookie), "a=b");
+    BOOST_CHECK_EQUAL(request.findAll("X-Trace").size(), 3u);
+
+    request.reindex();
+    BOOST_CHECK_EQUAL(request.header("cookie"), "a=b");
+
+    request.clear();
+    BOOST_CHECK(!request.has("Host"));
+}
+
+// A rename keeps the count of headers, only reindex() makes the index see it.
+BOOST_AUTO_TEST_CASE(headers_renamed_in_place)
+{
+    Request request;
+    HttpRequestParser parser;
+
+    BOOST_REQUIRE_EQUAL(parser.parse(request, text, text + sizeof(text) - 1), HttpRequestParser::ParsingCompleted);
+
+    request.headers[2].name = "X-Bar";
+    request.headers[0].name = "X-Origin";
+    request.headers[0].id   = HeaderUnknown;
+    request.reindex();
+
+    BOOST_CHECK_EQUAL(request.header("X-Bar"), "one");
+    BOOST_CHECK_EQUAL(request.findAll("X-Trace").size(), 2u);
+    BOOST_CHECK_EQUAL(request.header("x-origin"), "example.com");
+    BOOST_CHECK(!request.has(HeaderHost));
+}
+
+BOOST_AUTO_TEST_CASE(view_lookups)
+{
+    RequestView view;
+    HttpRequestParser parser;
+
+    BOOST_REQUIRE_EQUAL(parser.parse(view, text, text + sizeof(text) - 1), HttpRequestParser::ParsingCompleted);
+
+    BOOST_CHECK(view.header("HOST") == "example.com");
+    BOOST_CHECK(view.header("Cookie").empty());
+    BOOST_CHECK_EQUAL(view.findAll("X-Trace").size(), 3u);
+    BOOST_CHECK_EQUAL(view.materialize().header("x-trace"), "one");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
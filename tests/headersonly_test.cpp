@@ -0,0 +1,134 @@
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+#include <httpparser/httprequestparser.h>
+#include <httpparser/httpresponseparser.h>
+
+#include <string>
+
+#include <string.h>
+
+BOOST_AUTO_TEST_SUITE(HeadersOnly)
+
+using httpparser::HeaderHost;
+using httpparser::HttpRequestParser;
+using httpparser::HttpResponseParser;
+using httpparser::Request;
+using httpparser::Response;
+
+BOOST_AUTO_TEST_CASE(content_length_body_is_left_alone)
+{
+    const char text[] = "POST /upload HTTP/1.1\r\n"
+                        "Host: example.com\r\n"
+                        "Content-Length: 11\r\n"
+                        "\r\n"
+                        "hello world";
+
+    Request req;
+    HttpRequestParser parser;
+    size_t consumed = 0;
+
+    parser.setHeadersOnly(true);
+    BOOST_REQUIRE_EQUAL(parser.parse(req, text, text + sizeof(text) - 1, consumed),
+                        HttpRequestParser::ParsingHeadersCompleted);
+
+    BOOST_CHECK_EQUAL(consumed, strstr(text, "hello") - text);
+    BOOST_CHECK_EQUAL(parser.framing(), HttpRequestParser::ContentLengthBody);
+    BOOST_CHECK_EQUAL(parser.contentLength(), 11u);
+    BOOST_CHECK(req.content.empty());
+    BOOST_CHECK_EQUAL(req.header(HeaderHost), "example.com");
+}
+
+BOOST_AUTO_TEST_CASE(body_split_from_headers)
+{
+    const char head[] = "POST /upload HTTP/1.1\r\n"
+                        "Content-Length: 5000000\r\n"
+                        "\r";
+
+    Request req;
+    HttpRequestParser parser;
+    size_t consumed = 0;
+
+    parser.setHeadersOnly(true);
+    BOOST_REQUIRE_EQUAL(parser.parse(req, head, head + sizeof(head) - 1), HttpRequestParser::ParsingIncompleted);
+    BOOST_REQUIRE_EQUAL(parser.parse(req, "\nbody", "\nbody" + 5, consumed), HttpRequestParser::ParsingHeadersCompleted);
+    BOOST_CHECK_EQUAL(consumed, 1u);
+    BOOST_CHECK_EQUAL(parser.contentLength(), 5000000u);
+}
+
+BOOST_AUTO_TEST_CASE(chunked_body_can_be_resumed)
+{
+    const char text[] = "POST /upload HTTP/1.1\r\n"
+                        "Transfer-Encoding: chunked\r\n"
+                        "\r\n"
+                        "5\r\nhello\r\n"
+                        "0\r\n\r\n";
+
+    Request req;
+    HttpRequestParser parser;
+    size_t consumed = 0;
+
+    parser.setHeadersOnly(true);
+    BOOST_REQUIRE_EQUAL(parser.parse(req, text, text + sizeof(text) - 1, consumed),
+                        HttpRequestParser::ParsingHeadersCompleted);
+    BOOST_CHECK_EQUAL(parser.framing(), HttpRequestParser::ChunkedBody);
+    BOOST_CHECK_EQUAL(parser.contentLength(), 0u);
+    BOOST_CHECK(req.content.empty());
+
+    BOOST_REQUIRE_EQUAL(parser.parse(req, text + consumed, text + sizeof(text) - 1),
+                        HttpRequestParser::ParsingCompleted);
+    BOOST_CHECK_EQUAL(std::string(req.content.begin(), req.content.end()), "hello");
+}
+
+BOOST_AUTO_TEST_CASE(message_without_body_completes)
+{
+    const char text[] = "GET / HTTP/1.1\r\n"
+                        "Host: example.com\r\n"
+                        "\r\n";
+
+    Request req;
+    HttpRequestParser parser;
+
+    parser.setHeadersOnly(true);
+    BOOST_CHECK_EQUAL(parser.parse(req, text, text + sizeof(text) - 1), HttpRequestParser::ParsingCompleted);
+    BOOST_CHECK_EQUAL(parser.framing(), HttpRequestParser::NoBody);
+}
+
+BOOST_AUTO_TEST_CASE(close_delimited_response)
+{
+    const char text[] = "HTTP/1.0 200 OK\r\n"
+                        "\r\n"
+                        "data";
+
+    Response resp;
+    HttpResponseParser parser;
+    size_t consumed = 0;
+
+    parser.setHeadersOnly(true);
+    BOOST_REQUIRE_EQUAL(parser.parse(resp, text, text + sizeof(text) - 1, consumed),
+                        HttpResponseParser::ParsingHeadersCompleted);
+    BOOST_CHECK_EQUAL(parser.framing(), HttpResponseParser::CloseDelimitedBody);
+    BOOST_CHECK_EQUAL(consumed, sizeof(text) - 5);
+}
+
+BOOST_AUTO_TEST_CASE(framing_is_reset)
+{
+    const char first[]  = "POST / HTTP/1.1\r\nContent-Length: 3\r\n\r\nabc";
+    const char second[] = "GET / HTTP/1.1\r\n\r\n";
+
+    Request req;
+    HttpRequestParser parser;
+
+    parser.setHeadersOnly(true);
+    BOOST_REQUIRE_EQUAL(parser.parse(req, first, first + sizeof(first) - 1), HttpRequestParser::ParsingHeadersCompleted);
+
+    parser.reset();
+    req.clear();
+    BOOST_REQUIRE_EQUAL(parser.parse(req, second, second + sizeof(second) - 1), HttpRequestParser::ParsingCompleted);
+    BOOST_CHECK_EQUAL(parser.framing(), HttpRequestParser::NoBody);
+    BOOST_CHECK_EQUAL(parser.contentLength(), 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -5,6 +5,7 @@
 
 #include <httpparser/httprequestparser.h>
 #include <httpparser/request.h>
+#include <httpparser/requestview.h>
 
 #include "common.h"
 
@@ -12,6 +13,7 @@ BOOST_AUTO_TEST_SUITE(Keepalive)
 
 using httpparser::HttpRequestParser;
 using httpparser::Request;
+using httpparser::RequestView;
 
 struct KeepaliveFixture
 {
@@ -83,4 +85,65 @@ BOOST_FIXTURE_TEST_CASE(http_11_connection_close, KeepaliveFixture)
     BOOST_CHECK_EQUAL(result.inspect(), should.inspect());
 }
 
+BOOST_AUTO_TEST_CASE(pipelined_requests_in_one_buffer)
+{
+    const std::string text = "GET /first HTTP/1.1\r\n"
+                             "Host: 127.0.0.1\r\n"
+                             "\r\n"
+                             "POST /second HTTP/1.1\r\n"
+                             "Content-Length: 4\r\n"
+                             "\r\n"
+                             "data"
+                             "GET /third HTTP/1.1\r\n"
+                             "\r\n"
+                             "GET /fourth HTTP/1.1\r\n";
+
+    const char* uris[] = {"/first", "/second", "/third"};
+
+    const char* begin = text.c_str();
+    const char* end   = begin + text.size();
+
+    for (size_t i = 0; i < 3; ++i)
+    {
+        Request request;
+        HttpRequestParser parser;
+        size_t consumed = 0;
+
+        BOOST_REQUIRE_EQUAL(parser.parse(request, begin, end, consumed), HttpRequestParser::ParsingCompleted);
+        BOOST_CHECK_EQUAL(request.uri, uris[i]);
+        begin += consumed;
+    }
+
+    BOOST_CHECK_EQUAL(std::string(begin, end), "GET /fourth HTTP/1.1\r\n");
+
+    RequestView view;
+    HttpRequestParser parser;
+    size_t consumed = 0;
+
+    BOOST_CHECK_EQUAL(parser.parse(view, begin, end, consumed), HttpRequestParser::ParsingIncompleted);
+    BOOST_CHECK_EQUAL(consumed, static_cast<size_t>(end - begin));
+    BOOST_CHECK(view.uri == "/fourth");
+}
+
+BOOST_AUTO_TEST_CASE(pipelined_request_views)
+{
+    const char text[] = "GET /first HTTP/1.1\r\n\r\n"
+                        "GET /second HTTP/1.1\r\n\r\n";
+
+    const char* begin = text;
+    const char* end   = text + sizeof(text) - 1;
+
+    RequestView first, second;
+    HttpRequestParser firstParser, secondParser;
+    size_t consumed = 0;
+
+    BOOST_REQUIRE_EQUAL(firstParser.parse(first, begin, end, consumed), HttpRequestParser::ParsingCompleted);
+    BOOST_REQUIRE_EQUAL(secondParser.parse(second, begin + consumed, end, consumed),
+                        HttpRequestParser::ParsingCompleted);
+
+    BOOST_CHECK(first.uri == "/first");
+    BOOST_CHECK(second.uri == "/second");
+    BOOST_CHECK_EQUAL(consumed, sizeof("GET /second HTTP/1.1\r\n\r\n") - 1);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,328 @@
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+#include <httpparser/httprequestparser.h>
+#include <httpparser/httpresponseparser.h>
+#include <httpparser/staticrequest.h>
+
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(Limits)
+
+using httpparser::HttpRequestParser;
+using httpparser::HttpResponseParser;
+using httpparser::ParserLimits;
+using httpparser::Request;
+using httpparser::Response;
+using httpparser::StaticRequest;
+
+// Bytes of a hostile peer: `head` once, then `filler` over and over.
+struct Flood
+{
+    Flood(const std::string& head, const std::string& filler) : head(head), filler(filler) {}
+
+    std::string head;
+    std::string filler;
+};
+
+// Feed `flood` in small pieces, the way it arrives from a socket, until the parser stops or a
+// megabyte has gone in. Returns the result and how many bytes it took.
+template <typename Parser, typename Message>
+typename Parser::ParseResult feed(Parser& parser, Message& msg, const Flood& flood, size_t& fed)
+{
+    std::string piece = flood.head;
+    fed               = 0;
+
+    while (fed < 1024 * 1024)
+    {
+        while (piece.size() < 1024)
+            piece += flood.filler;
+
+        typename Parser::ParseResult res = parser.parse(msg, piece.data(), piece.data() + piece.size());
+        fed += piece.size();
+
+        if (res != Parser::ParsingIncompleted)
+            return res;
+
+        piece.clear();
+    }
+
+    return Parser::ParsingIncompleted;
+}
+
+// Bytes the parser made `req` keep.
+size_t storedBytes(const Request& req)
+{
+    size_t n = req.method.size() + req.uri.size() + req.content.size();
+
+    for (size_t i = 0; i < req.headers.size(); ++i)
+        n += req.headers[i].name.size() + req.headers[i].value.size();
+
+    return n;
+}
+
+BOOST_AUTO_TEST_CASE(defaults)
+{
+    HttpRequestParser parser;
+
+    BOOST_CHECK_EQUAL(parser.limits().maxUriSize, 8192u);
+    BOOST_CHECK_EQUAL(parser.limits().maxHeaderCount, 100u);
+    BOOST_CHECK_EQUAL(parser.limits().maxHeaderBytes, 64u * 1024);
+    BOOST_CHECK_EQUAL(parser.error(), HttpRequestParser::NoError);
+}
+
+BOOST_AUTO_TEST_CASE(endless_uri)
+{
+    Request req;
+    HttpRequestParser parser;
+    size_t fed;
+
+    BOOST_CHECK_EQUAL(feed(parser, req, Flood("GET /", "a"), fed), HttpRequestParser::ParsingTooLarge);
+    BOOST_CHECK_EQUAL(parser.error(), HttpRequestParser::UriTooLong);
+    BOOST_CHECK_LE(fed, 8192u + 1024);
+    BOOST_CHECK_LE(req.uri.size(), 8192u);
+}
+
+// The error names the limit that the bytes reach first, whether they come at once or one by one.
+BOOST_AUTO_TEST_CASE(uri_and_header_limits_in_any_split)
+{
+    std::string text = "GET /" + std::string(200, 'a') + " HTTP/1.1\r\n\r\n";
+
+    const struct
+    {
+        size_t maxHeaderBytes;
+        size_t maxUriSize;
+        HttpRequestParser::ParseError error;
+    } cases[] = {
+        {100, 50, HttpRequestParser::UriTooLong},
+        {40, 50, HttpRequestParser::HeadersTooLarge},
+        {54, 50, HttpRequestParser::UriTooLong},
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i)
+    {
+        ParserLimits limits;
+        limits.maxHeaderBytes = cases[i].maxHeaderBytes;
+        limits.maxUriSize     = cases[i].maxUriSize;
+
+        Request whole;
+        HttpRequestParser wholeParser(limits);
+        BOOST_CHECK_EQUAL(wholeParser.parse(whole, text.data(), text.data() + text.size()),
+                          HttpRequestParser::ParsingTooLarge);
+        BOOST_CHECK_EQUAL(wholeParser.error(), cases[i].error);
+
+        Request bytewise;
+        HttpRequestParser bytewiseParser(limits);
+        HttpRequestParser::ParseResult res = HttpRequestParser::ParsingIncompleted;
+        for (size_t pos = 0; pos < text.size() && res == HttpRequestParser::ParsingIncompleted; ++pos)
+            res = bytewiseParser.parse(bytewise, text.data() + pos, text.data() + pos + 1);
+
+        BOOST_CHECK_EQUAL(res, HttpRequestParser::ParsingTooLarge);
+        BOOST_CHECK_EQUAL(bytewiseParser.error(), cases[i].error);
+    }
+}
+
+// Parse `text` in the pieces that end at `ends` and return the result the parser stops with.
+template <typename Parser>
+typename Parser::ParseResult parsePieces(Parser& parser, const std::string& text, const std::vector<size_t>& ends)
+{
+    Request req;
+    typename Parser::ParseResult res = Parser::ParsingIncompleted;
+    size_t begin                     = 0;
+
+    for (size_t i = 0; i < ends.size() && res == Parser::ParsingIncompleted; ++i)
+    {
+        res   = parser.parse(req, text.data() + begin, text.data() + ends[i]);
+        begin = ends[i];
+    }
+
+    return res;
+}
+
+// Whole, byte by byte, and cut in two at every position, `text` must stop with the same error.
+void checkEverySplit(const std::string& text, const ParserLimits& limits, HttpRequestParser::ParseError error)
+{
+    std::vector<std::vector<size_t> > splits;
+    splits.push_back(std::vector<size_t>(1, text.size()));
+
+    std::vector<size_t> bytes;
+    for (size_t pos = 1; pos <= text.size(); ++pos)
+        bytes.push_back(pos);
+    splits.push_back(bytes);
+
+    for (size_t pos = 1; pos < text.size(); ++pos)
+    {
+        std::vector<size_t> two;
+        two.push_back(pos);
+        two.push_back(text.size());
+        splits.push_back(two);
+    }
+
+    for (size_t i = 0; i < splits.size(); ++i)
+    {
+        HttpRequestParser parser(limits);
+
+        BOOST_TEST_CONTEXT("split " << i)
+        {
+            BOOST_CHECK_EQUAL(parsePieces(parser, text, splits[i]), HttpRequestParser::ParsingTooLarge);
+            BOOST_CHECK_EQUAL(parser.error(), error);
+        }
+    }
+}
+
+// A limit that the bytes before an invalid one exceed is what the parser reports, wherever the
+// buffers end.
+BOOST_AUTO_TEST_CASE(limit_before_invalid_byte_in_any_split)
+{
+    ParserLimits headerLimits;
+    headerLimits.maxHeaderBytes = 40;
+
+    checkEverySplit("GET / HTTP/1.1\r\n" + std::string(60, 'n') + "\x01: value\r\n\r\n", headerLimits,
+                    HttpRequestParser::HeadersTooLarge);
+    checkEverySplit("GET / HTTP/1.1\r\nX-Long: " + std::string(60, 'v') + "\x01\r\n\r\n", headerLimits,
+                    HttpRequestParser::HeadersTooLarge);
+    checkEverySplit("GET" + std::string(60, 'M') + "\x01 / HTTP/1.1\r\n\r\n", headerLimits,
+                    HttpRequestParser::HeadersTooLarge);
+
+    ParserLimits uriLimits;
+    uriLimits.maxUriSize = 10;
+
+    checkEverySplit("GET /" + std::string(30, 'a') + "\x01 HTTP/1.1\r\n\r\n", uriLimits,
+                    HttpRequestParser::UriTooLong);
+}
+
+BOOST_AUTO_TEST_CASE(endless_header_value)
+{
+    Request req;
+    HttpRequestParser parser;
+    size_t fed;
+
+    BOOST_CHECK_EQUAL(feed(parser, req, Flood("GET / HTTP/1.1\r\nX-Long: ", "a"), fed),
+                      HttpRequestParser::ParsingTooLarge);
+    BOOST_CHECK_EQUAL(parser.error(), HttpRequestParser::HeadersTooLarge);
+    BOOST_CHECK_LE(fed, 64u * 1024 + 1024);
+    BOOST_CHECK_LE(storedBytes(req), 64u * 1024);
+}
+
+BOOST_AUTO_TEST_CASE(endless_headers)
+{
+    ParserLimits limits;
+    limits.maxHeaderCount = 100000;
+
+    Request req;
+    HttpRequestParser parser(limits);
+    size_t fed;
+
+    BOOST_CHECK_EQUAL(feed(parser, req, Flood("GET / HTTP/1.1\r\n", "X-Header: value\r\n"), fed),
+                      HttpRequestParser::ParsingTooLarge);
+    BOOST_CHECK_EQUAL(parser.error(), HttpRequestParser::HeadersTooLarge);
+    BOOST_CHECK_LE(storedBytes(req), 64u * 1024);
+}
+
+BOOST_AUTO_TEST_CASE(endless_folding)
+{
+    Request req;
+    HttpRequestParser parser;
+    size_t fed;
+
+    BOOST_CHECK_EQUAL(feed(parser, req, Flood("GET / HTTP/1.1\r\nX-Folded: a\r\n", " \r\n"), fed),
+                      HttpRequestParser::ParsingTooLarge);
+    BOOST_CHECK_EQUAL(parser.error(), HttpRequestParser::HeadersTooLarge);
+    BOOST_CHECK_LE(fed, 64u * 1024 + 1024);
+}
+
+BOOST_AUTO_TEST_CASE(too_many_headers)
+{
+    Request req;
+    HttpRequestParser parser;
+    size_t fed;
+
+    BOOST_CHECK_EQUAL(feed(parser, req, Flood("GET / HTTP/1.1\r\n", "A: b\r\n"), fed),
+                      HttpRequestParser::ParsingTooLarge);
+    BOOST_CHECK_EQUAL(parser.error(), HttpRequestParser::TooManyHeaders);
+    BOOST_CHECK_EQUAL(req.headers.size(), 100u);
+}
+
+BOOST_AUTO_TEST_CASE(content_length_over_limit)
+{
+    const char text[] = "POST / HTTP/1.1\r\nContent-Length: 1000001\r\n\r\n";
+
+    ParserLimits limits;
+    limits.maxBodySize = 1000000;
+
+    Request req;
+    HttpRequestParser parser(limits);
+
+    BOOST_CHECK_EQUAL(parser.parse(req, text, text + sizeof(text) - 1), HttpRequestParser::ParsingTooLarge);
+    BOOST_CHECK_EQUAL(parser.error(), HttpRequestParser::BodyTooLarge);
+}
+
+BOOST_AUTO_TEST_CASE(endless_chunks)
+{
+    ParserLimits limits;
+    limits.maxBodySize = 64 * 1024;
+
+    std::string chunk = "400\r\n" + std::string(1024, 'x') + "\r\n";
+
+    Response resp;
+    HttpResponseParser parser(limits);
+    size_t fed;
+
+    BOOST_CHECK_EQUAL(feed(parser, resp, Flood("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n", chunk), fed),
+                      HttpResponseParser::ParsingTooLarge);
+    BOOST_CHECK_EQUAL(parser.error(), HttpResponseParser::BodyTooLarge);
+    BOOST_CHECK_LE(resp.content.size(), 64u * 1024);
+}
+
+BOOST_AUTO_TEST_CASE(limits_are_per_message)
+{
+    const char text[] = "GET /0123456789 HTTP/1.1\r\nHost: example.com\r\n\r\n";
+
+    ParserLimits limits;
+    limits.maxUriSize = 11;
+
+    HttpRequestParser parser(limits);
+
+    for (int i = 0; i < 3; ++i)
+    {
+        Request req;
+
+        BOOST_CHECK_EQUAL(parser.parse(req, text, text + sizeof(text) - 1), HttpRequestParser::ParsingCompleted);
+        BOOST_CHECK_EQUAL(parser.error(), HttpRequestParser::NoError);
+        parser.reset();
+    }
+
+    limits.maxUriSize = 10;
+    parser.setLimits(limits);
+
+    Request req;
+    BOOST_CHECK_EQUAL(parser.parse(req, text, text + sizeof(text) - 1), HttpRequestParser::ParsingTooLarge);
+    BOOST_CHECK_EQUAL(parser.error(), HttpRequestParser::UriTooLong);
+}
+
+BOOST_AUTO_TEST_CASE(syntax_errors_are_not_limits)
+{
+    const char text[] = "GET / HTTP/1.1\r\nBad Header: value\r\n\r\n";
+
+    Request req;
+    HttpRequestParser parser;
+
+    BOOST_CHECK_EQUAL(parser.parse(req, text, text + sizeof(text) - 1), HttpRequestParser::ParsingError);
+    BOOST_CHECK_EQUAL(parser.error(), HttpRequestParser::InvalidMessage);
+}
+
+BOOST_AUTO_TEST_CASE(static_capacity)
+{
+    const char text[] = "GET /a-rather-long-uri HTTP/1.1\r\nHost: example.com\r\n\r\n";
+
+    StaticRequest<4, 16> req;
+    HttpRequestParser parser;
+
+    BOOST_CHECK_EQUAL(parser.parse(req, text, text + sizeof(text) - 1), HttpRequestParser::ParsingTooLarge);
+    BOOST_CHECK_EQUAL(parser.error(), HttpRequestParser::CapacityExceeded);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
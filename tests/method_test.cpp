@@ -0,0 +1,121 @@
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+#include <httpparser/httprequestparser.h>
+#include <httpparser/httpresponseparser.h>
+#include <httpparser/method.h>
+
+#include <string>
+
+#include <string.h>
+
+BOOST_AUTO_TEST_SUITE(Methods)
+
+using httpparser::HttpRequestParser;
+using httpparser::HttpResponseParser;
+using httpparser::Method;
+using httpparser::MethodCount;
+using httpparser::MethodDelete;
+using httpparser::MethodHead;
+using httpparser::methodId;
+using httpparser::methodName;
+using httpparser::MethodUnknown;
+using httpparser::Request;
+using httpparser::RequestView;
+using httpparser::Response;
+
+BOOST_AUTO_TEST_CASE(names_round_trip)
+{
+    for (int i = MethodUnknown + 1; i < MethodCount; ++i)
+    {
+        Method method = static_cast<Method>(i);
+        BOOST_CHECK_EQUAL(methodId(methodName(method), strlen(methodName(method))), method);
+    }
+
+    BOOST_CHECK_EQUAL(methodId("get"), MethodUnknown);
+    BOOST_CHECK_EQUAL(methodId("GETS"), MethodUnknown);
+    BOOST_CHECK_EQUAL(methodId("PROPFIND"), MethodUnknown);
+    BOOST_CHECK_EQUAL(methodId(""), MethodUnknown);
+}
+
+// Whole buffers take the word-at-a-time path, single bytes the per-byte states.
+BOOST_AUTO_TEST_CASE(parser_classifies_the_method)
+{
+    const char* methods[] = {
+        "GET", "HEAD", "POST", "PUT", "DELETE", "CONNECT", "OPTIONS", "TRACE", "PATCH", "PROPFIND",
+    };
+
+    for (size_t i = 0; i < sizeof(methods) / sizeof(methods[0]); ++i)
+    {
+        std::string text = std::string(methods[i]) + " / HTTP/1.1\r\n\r\n";
+        Method expected  = methodId(methods[i]);
+
+        Request whole;
+        HttpRequestParser parser;
+        BOOST_REQUIRE_EQUAL(parser.parse(whole, text.data(), text.data() + text.size()),
+                            HttpRequestParser::ParsingCompleted);
+        BOOST_CHECK_EQUAL(whole.methodId, expected);
+        BOOST_CHECK_EQUAL(whole.method, methods[i]);
+
+        RequestView bytewise;
+        HttpRequestParser bytewiseParser;
+        for (size_t pos = 0; pos + 1 < text.size(); ++pos)
+            bytewiseParser.parse(bytewise, text.data() + pos, text.data() + pos + 1);
+        BOOST_CHECK_EQUAL(bytewise.methodId, expected);
+    }
+}
+
+// RFC 9112: the body of a request is framed by its headers, whatever the method.
+BOOST_AUTO_TEST_CASE(every_method_can_have_a_body)
+{
+    const char* methods[] = {"GET", "POST", "PUT", "DELETE", "PATCH", "OPTIONS", "PROPFIND"};
+
+    for (size_t i = 0; i < sizeof(methods) / sizeof(methods[0]); ++i)
+    {
+        std::string text = std::string(methods[i]) + " /x HTTP/1.1\r\nContent-Length: 4\r\n\r\nbody"
+                           + methods[i] + " /x HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n4\r\nbody\r\n0\r\n\r\n";
+
+        Request request;
+        HttpRequestParser parser;
+        size_t consumed = 0;
+
+        BOOST_REQUIRE_EQUAL(parser.parse(request, text.data(), text.data() + text.size(), consumed),
+                            HttpRequestParser::ParsingCompleted);
+        BOOST_CHECK_EQUAL(std::string(request.content.begin(), request.content.end()), "body");
+
+        request.clear();
+        parser.reset();
+        BOOST_REQUIRE_EQUAL(parser.parse(request, text.data() + consumed, text.data() + text.size()),
+                            HttpRequestParser::ParsingCompleted);
+        BOOST_CHECK_EQUAL(std::string(request.content.begin(), request.content.end()), "body");
+    }
+}
+
+BOOST_AUTO_TEST_CASE(clear_and_materialize_keep_the_method)
+{
+    const char text[] = "DELETE /item HTTP/1.1\r\n\r\n";
+
+    RequestView view;
+    HttpRequestParser parser;
+
+    BOOST_REQUIRE_EQUAL(parser.parse(view, text, text + sizeof(text) - 1), HttpRequestParser::ParsingCompleted);
+    BOOST_CHECK_EQUAL(view.materialize().methodId, MethodDelete);
+
+    view.clear();
+    BOOST_CHECK_EQUAL(view.methodId, MethodUnknown);
+}
+
+BOOST_AUTO_TEST_CASE(response_to_head_by_id)
+{
+    const char text[] = "HTTP/1.1 200 OK\r\nContent-Length: 100\r\n\r\n";
+
+    Response response;
+    HttpResponseParser parser;
+
+    parser.setRequestMethod(MethodHead);
+    BOOST_CHECK_EQUAL(parser.parse(response, text, text + sizeof(text) - 1), HttpResponseParser::ParsingCompleted);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -6,6 +6,12 @@
 #include <httpparser/httprequestparser.h>
 #include <httpparser/request.h>
 
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+#include <string.h>
+
 #include "common.h"
 
 BOOST_AUTO_TEST_SUITE(Post)
@@ -149,4 +155,255 @@ BOOST_FIXTURE_TEST_CASE(post_chunked_extension, PostFixture)
     BOOST_CHECK_EQUAL(result.inspect(), should.inspect());
 }
 
+BOOST_FIXTURE_TEST_CASE(post_body_split_across_parse_calls, PostFixture)
+{
+    const char text[] = "POST /uri.cgi HTTP/1.1\r\n"
+                        "Transfer-Encoding: chunked\r\n"
+                        "\r\n"
+                        "23\r\n"
+                        "This is the data in the first chunk\r\n"
+                        "1A\r\n"
+                        "and this is the second one\r\n"
+                        "0\r\n\r\n"
+                        "POST /uri.cgi HTTP/1.1\r\n"
+                        "Content-Length: 31\r\n"
+                        "\r\n"
+                        "arg1=test;arg1=%20%21;arg3=test";
+    const char* second = strstr(text + 1, "POST");
+
+    const char* messages[][2] = {{text, second}, {second, text + sizeof(text) - 1}};
+
+    for (size_t m = 0; m < 2; ++m)
+    {
+        const char* begin = messages[m][0];
+        const char* end   = messages[m][1];
+        Request whole     = parse(begin, end - begin);
+
+        BOOST_REQUIRE_EQUAL(whole.content.empty(), false);
+
+        for (size_t step = 1; step < static_cast<size_t>(end - begin); ++step)
+        {
+            Request request;
+            HttpRequestParser parser;
+            HttpRequestParser::ParseResult res = HttpRequestParser::ParsingIncompleted;
+
+            for (const char* p = begin; p < end && res == HttpRequestParser::ParsingIncompleted; p += step)
+                res = parser.parse(request, p, std::min(p + step, end));
+
+            BOOST_REQUIRE_EQUAL(res, HttpRequestParser::ParsingCompleted);
+            BOOST_CHECK_EQUAL(request.inspect(), whole.inspect());
+        }
+    }
+}
+
+// Counts the body without storing it.
+struct BodyCounter : httpparser::HttpHandler
+{
+    BodyCounter() : size(0), complete(false) {}
+
+    bool onBody(const char*, size_t n)
+    {
+        size += n;
+        return true;
+    }
+
+    bool onMessageComplete()
+    {
+        complete = true;
+        return true;
+    }
+
+    uint64_t size;
+    bool complete;
+};
+
+// Feed `size` bytes of body after `head` and then `tail`, one megabyte at a time.
+HttpRequestParser::ParseResult parseLargeBody(BodyCounter& counter, const std::string& head, uint64_t size,
+                                              const std::string& tail)
+{
+    std::vector<char> block(1024 * 1024, 'x');
+    HttpRequestParser parser;
+
+    HttpRequestParser::ParseResult res = parser.parse(counter, head.data(), head.data() + head.size());
+
+    for (; size > 0 && res == HttpRequestParser::ParsingIncompleted; size -= std::min<uint64_t>(size, block.size()))
+        res = parser.parse(counter, &block[0], &block[0] + std::min<uint64_t>(size, block.size()));
+
+    if (res == HttpRequestParser::ParsingIncompleted)
+        res = parser.parse(counter, tail.data(), tail.data() + tail.size());
+
+    return res;
+}
+
+BOOST_AUTO_TEST_CASE(post_body_over_4gb)
+{
+    const uint64_t size = 5000000000ull;
+
+    BodyCounter counter;
+    BOOST_CHECK_EQUAL(parseLargeBody(counter, "POST / HTTP/1.1\r\nContent-Length: 5000000000\r\n\r\n", size, ""),
+                      HttpRequestParser::ParsingCompleted);
+    BOOST_CHECK_EQUAL(counter.size, size);
+    BOOST_CHECK(counter.complete);
+}
+
+BOOST_AUTO_TEST_CASE(post_chunk_over_4gb)
+{
+    const uint64_t size = 0x12a05f200ull;
+
+    BodyCounter counter;
+    BOOST_CHECK_EQUAL(parseLargeBody(counter, "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n12a05f200\r\n", size,
+                                     "\r\n0\r\n\r\n"),
+                      HttpRequestParser::ParsingCompleted);
+    BOOST_CHECK_EQUAL(counter.size, size);
+    BOOST_CHECK(counter.complete);
+}
+
+BOOST_AUTO_TEST_CASE(post_invalid_sizes)
+{
+    const char* texts[] = {
+        "POST / HTTP/1.1\r\nContent-Length: 18446744073709551616\r\n\r\n",
+        "POST / HTTP/1.1\r\nContent-Length: 99999999999999999999999\r\n\r\n",
+        "POST / HTTP/1.1\r\nContent-Length: 12abc\r\n\r\n",
+        "POST / HTTP/1.1\r\nContent-Length: -1\r\n\r\n",
+        "POST / HTTP/1.1\r\nContent-Length: \r\n\r\n",
+        "POST / HTTP/1.1\r\nContent-Length: 000000000000000000000000000000001\r\n\r\n",
+        "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n10000000000000000\r\n",
+        "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n\r\n",
+        "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n;ext\r\n",
+    };
+
+    for (size_t i = 0; i < sizeof(texts) / sizeof(texts[0]); ++i)
+    {
+        Request request;
+        HttpRequestParser parser;
+
+        BOOST_CHECK_EQUAL(parser.parse(request, texts[i], texts[i] + strlen(texts[i])), HttpRequestParser::ParsingError);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(post_largest_sizes)
+{
+    const char* texts[] = {
+        "POST / HTTP/1.1\r\nContent-Length: 18446744073709551615\r\n\r\n",
+        "POST / HTTP/1.1\r\nContent-Length:  42 \r\n\r\n",
+        "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\nffffffffffffffff\r\n",
+    };
+
+    for (size_t i = 0; i < sizeof(texts) / sizeof(texts[0]); ++i)
+    {
+        Request request;
+        HttpRequestParser parser;
+
+        BOOST_CHECK_EQUAL(parser.parse(request, texts[i], texts[i] + strlen(texts[i])),
+                          HttpRequestParser::ParsingIncompleted);
+    }
+}
+
+// RFC 9112 6.3: framing that two implementations could read differently must not go through.
+BOOST_AUTO_TEST_CASE(post_ambiguous_framing)
+{
+    const char* texts[] = {
+        "POST / HTTP/1.1\r\nTransfer-Encoding: gzip\r\n\r\n",
+        "POST / HTTP/1.1\r\nTransfer-Encoding: chunked, gzip\r\n\r\n",
+        "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\nTransfer-Encoding: gzip\r\n\r\n",
+        "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\nTransfer-Encoding: chunked\r\n\r\n",
+        "POST / HTTP/1.1\r\nContent-Length: 5\r\nContent-Length: 2\r\n\r\nhello",
+    };
+
+    for (size_t i = 0; i < sizeof(texts) / sizeof(texts[0]); ++i)
+    {
+        Request request;
+        HttpRequestParser parser;
+
+        BOOST_CHECK_EQUAL(parser.parse(request, texts[i], texts[i] + strlen(texts[i])),
+                          HttpRequestParser::ParsingError);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(post_chunked_is_the_final_coding)
+{
+    const char text[] = "POST / HTTP/1.1\r\n"
+                        "Transfer-Encoding: gzip, Chunked \r\n"
+                        "\r\n"
+                        "5\r\nhello\r\n0\r\n\r\n";
+
+    Request request;
+    HttpRequestParser parser;
+    size_t consumed = 0;
+
+    BOOST_REQUIRE_EQUAL(parser.parse(request, text, text + sizeof(text) - 1, consumed),
+                        HttpRequestParser::ParsingCompleted);
+    BOOST_CHECK_EQUAL(consumed, sizeof(text) - 1);
+    BOOST_CHECK_EQUAL(std::string(request.content.begin(), request.content.end()), "hello");
+}
+
+BOOST_AUTO_TEST_CASE(post_repeated_content_length)
+{
+    const char text[] = "POST / HTTP/1.1\r\nContent-Length: 5\r\nContent-Length: 5\r\n\r\nhello";
+
+    Request request;
+    HttpRequestParser parser;
+
+    BOOST_REQUIRE_EQUAL(parser.parse(request, text, text + sizeof(text) - 1), HttpRequestParser::ParsingCompleted);
+    BOOST_CHECK_EQUAL(std::string(request.content.begin(), request.content.end()), "hello");
+}
+
+// Transfer-Encoding wins, and the connection is not reused after such a request.
+BOOST_AUTO_TEST_CASE(post_content_length_and_chunked)
+{
+    const char text[] = "POST / HTTP/1.1\r\n"
+                        "Content-Length: 3\r\n"
+                        "Transfer-Encoding: chunked\r\n"
+                        "\r\n"
+                        "5\r\nhello\r\n0\r\n\r\n";
+
+    Request request;
+    HttpRequestParser parser;
+
+    BOOST_REQUIRE_EQUAL(parser.parse(request, text, text + sizeof(text) - 1), HttpRequestParser::ParsingCompleted);
+    BOOST_CHECK_EQUAL(std::string(request.content.begin(), request.content.end()), "hello");
+    BOOST_CHECK(!request.keepAlive);
+}
+
+// Only the final coding counts, however long the list before it is.
+BOOST_AUTO_TEST_CASE(post_long_transfer_encoding_list)
+{
+    const char* codings[] = {
+        "gzip, deflate, identity, br, chunked",
+        "x-first-coding-with-a-long-name,chunked , ",
+        "x-first-coding-with-a-long-name, x-second-one, Chunked",
+    };
+
+    for (size_t i = 0; i < sizeof(codings) / sizeof(codings[0]); ++i)
+    {
+        std::string text = std::string("POST / HTTP/1.1\r\nTransfer-Encoding: ") + codings[i]
+                           + "\r\n\r\n5\r\nhello\r\n0\r\n\r\n";
+
+        Request whole;
+        HttpRequestParser wholeParser;
+        BOOST_REQUIRE_EQUAL(wholeParser.parse(whole, text.data(), text.data() + text.size()),
+                            HttpRequestParser::ParsingCompleted);
+        BOOST_CHECK_EQUAL(std::string(whole.content.begin(), whole.content.end()), "hello");
+
+        Request bytewise;
+        HttpRequestParser bytewiseParser;
+        HttpRequestParser::ParseResult res = HttpRequestParser::ParsingIncompleted;
+
+        for (size_t pos = 0; pos < text.size() && res == HttpRequestParser::ParsingIncompleted; ++pos)
+            res = bytewiseParser.parse(bytewise, text.data() + pos, text.data() + pos + 1);
+
+        BOOST_CHECK_EQUAL(res, HttpRequestParser::ParsingCompleted);
+        BOOST_CHECK_EQUAL(std::string(bytewise.content.begin(), bytewise.content.end()), "hello");
+    }
+
+    const char text[] = "POST / HTTP/1.1\r\n"
+                        "Transfer-Encoding: chunked, x-coding-with-a-name-longer-than-the-prefix\r\n"
+                        "\r\n"
+                        "5\r\nhello\r\n0\r\n\r\n";
+
+    Request request;
+    HttpRequestParser parser;
+    BOOST_CHECK_EQUAL(parser.parse(request, text, text + sizeof(text) - 1), HttpRequestParser::ParsingError);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -86,4 +86,78 @@ BOOST_FIXTURE_TEST_CASE(post_http_11_with_header_field, RequestFixture)
     BOOST_CHECK_EQUAL(result.inspect(), should.inspect());
 }
 
+// The word-at-a-time request line must agree with the byte-by-byte states, which take over for
+// unknown methods, other versions and buffers that end inside the line.
+BOOST_FIXTURE_TEST_CASE(request_line_fast_path_matches_bytewise, RequestFixture)
+{
+    const char* lines[] = {
+        "GET / HTTP/1.1",
+        "GET / HTTP/1.0",
+        "POST /form HTTP/1.1",
+        "PUT /file HTTP/1.1",
+        "HEAD / HTTP/1.1",
+        "DELETE /x HTTP/1.1",
+        "PATCH /x HTTP/1.1",
+        "OPTIONS * HTTP/1.1",
+        "CONNECT a:443 HTTP/1.1",
+        "TRACE / HTTP/1.1",
+        "GETX / HTTP/1.1",
+        "get / HTTP/1.1",
+        "PROPFIND / HTTP/1.1",
+        "GET / HTTP/2.0",
+        "GET / HTTP/1.12",
+        "GET / HTTP/1.1x",
+        "GET /",
+    };
+
+    for (size_t i = 0; i < sizeof(lines) / sizeof(lines[0]); ++i)
+    {
+        std::string text = std::string(lines[i]) + "\r\nContent-Length: 2\r\n\r\nok";
+
+        Request whole;
+        HttpRequestParser wholeParser;
+        HttpRequestParser::ParseResult expected = wholeParser.parse(whole, text.data(), text.data() + text.size());
+
+        Request bytewise;
+        HttpRequestParser bytewiseParser;
+        HttpRequestParser::ParseResult res = HttpRequestParser::ParsingIncompleted;
+
+        for (size_t pos = 0; pos < text.size() && res == HttpRequestParser::ParsingIncompleted; ++pos)
+            res = bytewiseParser.parse(bytewise, text.data() + pos, text.data() + pos + 1);
+
+        BOOST_CHECK_EQUAL(res, expected);
+        BOOST_CHECK_EQUAL(bytewise.inspect(), whole.inspect());
+    }
+}
+
+// RFC 9112: HTTP-version = HTTP-name "/" DIGIT "." DIGIT
+BOOST_AUTO_TEST_CASE(version_has_one_digit_each)
+{
+    const char* lines[] = {
+        "GET / HTTP/4294967297.1",
+        "GET / HTTP/11.1",
+        "GET / HTTP/1.12",
+        "GET / HTTP/1.4294967297",
+    };
+
+    for (size_t i = 0; i < sizeof(lines) / sizeof(lines[0]); ++i)
+    {
+        std::string text = std::string(lines[i]) + "\r\n\r\n";
+
+        Request whole;
+        HttpRequestParser wholeParser;
+        BOOST_CHECK_EQUAL(wholeParser.parse(whole, text.data(), text.data() + text.size()),
+                          HttpRequestParser::ParsingError);
+
+        Request bytewise;
+        HttpRequestParser bytewiseParser;
+        HttpRequestParser::ParseResult res = HttpRequestParser::ParsingIncompleted;
+
+        for (size_t pos = 0; pos < text.size() && res == HttpRequestParser::ParsingIncompleted; ++pos)
+            res = bytewiseParser.parse(bytewise, text.data() + pos, text.data() + pos + 1);
+
+        BOOST_CHECK_EQUAL(res, HttpRequestParser::ParsingError);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
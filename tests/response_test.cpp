@@ -6,6 +6,10 @@
 #include <httpparser/httpresponseparser.h>
 #include <httpparser/response.h>
 
+#include <string>
+
+#include <string.h>
+
 #include "common.h"
 
 BOOST_AUTO_TEST_SUITE(Simple)
@@ -122,4 +126,277 @@ BOOST_FIXTURE_TEST_CASE(chunk_extension, ResponseFixture)
     BOOST_CHECK_EQUAL(result.inspect(), should.inspect());
 }
 
+BOOST_AUTO_TEST_CASE(head_response_has_no_body)
+{
+    const char text[] = "HTTP/1.1 200 OK\r\n"
+                        "Content-Length: 1234\r\n"
+                        "\r\n"
+                        "HTTP/1.1 200 OK\r\n";
+
+    Response response;
+    HttpResponseParser parser;
+    size_t consumed = 0;
+
+    parser.setRequestMethod("HEAD");
+    BOOST_REQUIRE_EQUAL(parser.parse(response, text, text + sizeof(text) - 1, consumed),
+                        HttpResponseParser::ParsingCompleted);
+    BOOST_CHECK_EQUAL(consumed, strstr(text + 1, "HTTP") - text);
+    BOOST_CHECK(response.content.empty());
+    BOOST_CHECK(response.keepAlive);
+
+    // The method stays in effect for the next response.
+    response.clear();
+    parser.reset();
+    BOOST_CHECK_EQUAL(parser.parse(response, text, text + sizeof(text) - 1, consumed),
+                      HttpResponseParser::ParsingCompleted);
+
+    parser.setRequestMethod("GET");
+    parser.reset();
+    BOOST_CHECK_EQUAL(parser.parse(response, text, text + sizeof(text) - 1), HttpResponseParser::ParsingIncompleted);
+}
+
+BOOST_AUTO_TEST_CASE(statuses_without_body)
+{
+    const char* texts[] = {
+        "HTTP/1.1 100 Continue\r\n\r\n",
+        "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\n\r\n",
+        "HTTP/1.1 204 No Content\r\nContent-Length: 10\r\n\r\n",
+        "HTTP/1.1 304 Not Modified\r\nTransfer-Encoding: chunked\r\n\r\n",
+    };
+
+    for (size_t i = 0; i < sizeof(texts) / sizeof(texts[0]); ++i)
+    {
+        Response response;
+        HttpResponseParser parser;
+
+        BOOST_CHECK_EQUAL(parser.parse(response, texts[i], texts[i] + strlen(texts[i])),
+                          HttpResponseParser::ParsingCompleted);
+        BOOST_CHECK(response.content.empty());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(interim_response_then_final_one)
+{
+    const char text[] = "HTTP/1.1 100 Continue\r\n"
+                        "\r\n"
+                        "HTTP/1.1 200 OK\r\n"
+                        "Content-Length: 2\r\n"
+                        "\r\n"
+                        "ok";
+
+    Response response;
+    HttpResponseParser parser;
+    size_t consumed = 0;
+
+    BOOST_REQUIRE_EQUAL(parser.parse(response, text, text + sizeof(text) - 1, consumed),
+                        HttpResponseParser::ParsingCompleted);
+    BOOST_CHECK_EQUAL(response.statusCode, 100u);
+
+    response.clear();
+    parser.reset();
+    BOOST_REQUIRE_EQUAL(parser.parse(response, text + consumed, text + sizeof(text) - 1),
+                        HttpResponseParser::ParsingCompleted);
+    BOOST_CHECK_EQUAL(response.statusCode, 200u);
+    BOOST_CHECK_EQUAL(std::string(response.content.begin(), response.content.end()), "ok");
+}
+
+BOOST_AUTO_TEST_CASE(connect_response_starts_a_tunnel)
+{
+    const char text[] = "HTTP/1.1 200 Connection established\r\n\r\n";
+
+    Response response;
+    HttpResponseParser parser;
+
+    parser.setRequestMethod("CONNECT");
+    BOOST_CHECK_EQUAL(parser.parse(response, text, text + sizeof(text) - 1), HttpResponseParser::ParsingCompleted);
+}
+
+BOOST_AUTO_TEST_CASE(body_expected_can_be_turned_off)
+{
+    const char text[] = "HTTP/1.1 200 OK\r\nContent-Length: 10\r\n\r\n";
+
+    Response response;
+    HttpResponseParser parser;
+
+    parser.setBodyExpected(false);
+    BOOST_CHECK_EQUAL(parser.parse(response, text, text + sizeof(text) - 1), HttpResponseParser::ParsingCompleted);
+}
+
+BOOST_AUTO_TEST_CASE(body_until_close)
+{
+    const char head[] = "HTTP/1.1 200 OK\r\n"
+                        "Connection: keep-alive\r\n"
+                        "\r\n"
+                        "first ";
+    const char rest[] = "and last part";
+
+    Response response;
+    HttpResponseParser parser;
+
+    BOOST_REQUIRE_EQUAL(parser.parse(response, head, head + sizeof(head) - 1), HttpResponseParser::ParsingIncompleted);
+    BOOST_CHECK(parser.bodyUntilClose());
+    BOOST_CHECK(!response.keepAlive);
+    BOOST_REQUIRE_EQUAL(parser.parse(response, rest, rest + sizeof(rest) - 1), HttpResponseParser::ParsingIncompleted);
+
+    BOOST_REQUIRE_EQUAL(parser.finish(), HttpResponseParser::ParsingCompleted);
+    BOOST_CHECK_EQUAL(std::string(response.content.begin(), response.content.end()), "first and last part");
+}
+
+BOOST_AUTO_TEST_CASE(finish_reports_truncated_messages)
+{
+    const char* texts[] = {
+        "HTTP/1.1 2",
+        "HTTP/1.1 200 OK\r\nContent-Length: 10\r\n\r\nshort",
+        "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n5\r\nab",
+        "HTTP/1.1 200 OK\r\nServer: x",
+    };
+
+    for (size_t i = 0; i < sizeof(texts) / sizeof(texts[0]); ++i)
+    {
+        Response response;
+        HttpResponseParser parser;
+
+        BOOST_REQUIRE_EQUAL(parser.parse(response, texts[i], texts[i] + strlen(texts[i])),
+                            HttpResponseParser::ParsingIncompleted);
+        BOOST_CHECK_EQUAL(parser.finish(), HttpResponseParser::ParsingError);
+    }
+
+    HttpResponseParser idle;
+    BOOST_CHECK_EQUAL(idle.finish(), HttpResponseParser::ParsingIncompleted);
+}
+
+// RFC 9112 6.3: without chunked as the final coding the body runs until the close, and
+// Transfer-Encoding overrides Content-Length.
+BOOST_AUTO_TEST_CASE(transfer_encoding_framing)
+{
+    const char gzip[] = "HTTP/1.1 200 OK\r\n"
+                        "Transfer-Encoding: gzip\r\n"
+                        "Content-Length: 2\r\n"
+                        "\r\n"
+                        "compressed";
+
+    Response response;
+    HttpResponseParser parser;
+
+    BOOST_REQUIRE_EQUAL(parser.parse(response, gzip, gzip + sizeof(gzip) - 1), HttpResponseParser::ParsingIncompleted);
+    BOOST_CHECK(parser.bodyUntilClose());
+    BOOST_REQUIRE_EQUAL(parser.finish(), HttpResponseParser::ParsingCompleted);
+    BOOST_CHECK_EQUAL(std::string(response.content.begin(), response.content.end()), "compressed");
+
+    const char both[] = "HTTP/1.1 200 OK\r\n"
+                        "Content-Length: 2\r\n"
+                        "Transfer-Encoding: gzip, chunked\r\n"
+                        "\r\n"
+                        "3\r\nabc\r\n0\r\n\r\n";
+
+    response.clear();
+    parser.reset();
+    BOOST_REQUIRE_EQUAL(parser.parse(response, both, both + sizeof(both) - 1), HttpResponseParser::ParsingCompleted);
+    BOOST_CHECK_EQUAL(std::string(response.content.begin(), response.content.end()), "abc");
+    BOOST_CHECK(!response.keepAlive);
+
+    const char longList[] = "HTTP/1.1 200 OK\r\n"
+                            "Transfer-Encoding: gzip, deflate, identity, br, chunked\r\n"
+                            "\r\n"
+                            "3\r\nabc\r\n0\r\n\r\n";
+
+    response.clear();
+    parser.reset();
+    BOOST_REQUIRE_EQUAL(parser.parse(response, longList, longList + sizeof(longList) - 1),
+                        HttpResponseParser::ParsingCompleted);
+    BOOST_CHECK_EQUAL(std::string(response.content.begin(), response.content.end()), "abc");
+    BOOST_CHECK(response.keepAlive);
+
+    const char lengths[] = "HTTP/1.1 200 OK\r\nContent-Length: 2\r\nContent-Length: 3\r\n\r\nabc";
+
+    response.clear();
+    parser.reset();
+    BOOST_CHECK_EQUAL(parser.parse(response, lengths, lengths + sizeof(lengths) - 1), HttpResponseParser::ParsingError);
+}
+
+BOOST_AUTO_TEST_CASE(status_code_has_three_digits)
+{
+    const char* texts[] = {
+        "HTTP/1.1 4294967500 X\r\nContent-Length: 3\r\n\r\nabc",
+        "HTTP/1.1 2000 OK\r\n\r\n",
+        "HTTP/1.1 0200 OK\r\n\r\n",
+        "HTTP/1.1 20 OK\r\n\r\n",
+        "HTTP/1.1 099 OK\r\n\r\n",
+    };
+
+    for (size_t i = 0; i < sizeof(texts) / sizeof(texts[0]); ++i)
+    {
+        Response response;
+        HttpResponseParser parser;
+
+        BOOST_CHECK_EQUAL(parser.parse(response, texts[i], texts[i] + strlen(texts[i])),
+                          HttpResponseParser::ParsingError);
+    }
+
+    const char text[] = "HTTP/1.1 999 Custom\r\nContent-Length: 0\r\n\r\n";
+
+    Response response;
+    HttpResponseParser parser;
+
+    BOOST_REQUIRE_EQUAL(parser.parse(response, text, text + sizeof(text) - 1), HttpResponseParser::ParsingCompleted);
+    BOOST_CHECK_EQUAL(response.statusCode, 999u);
+}
+
+// RFC 9112: HTTP-version = HTTP-name "/" DIGIT "." DIGIT
+BOOST_AUTO_TEST_CASE(version_has_one_digit_each)
+{
+    const char* texts[] = {
+        "HTTP/4294967297.1 200 OK\r\n\r\n",
+        "HTTP/11.1 200 OK\r\n\r\n",
+        "HTTP/1.12 200 OK\r\n\r\n",
+        "HTTP/1.4294967297 200 OK\r\n\r\n",
+    };
+
+    for (size_t i = 0; i < sizeof(texts) / sizeof(texts[0]); ++i)
+    {
+        Response whole;
+        HttpResponseParser wholeParser;
+        BOOST_CHECK_EQUAL(wholeParser.parse(whole, texts[i], texts[i] + strlen(texts[i])),
+                          HttpResponseParser::ParsingError);
+
+        Response bytewise;
+        HttpResponseParser bytewiseParser;
+        HttpResponseParser::ParseResult res = HttpResponseParser::ParsingIncompleted;
+
+        for (size_t pos = 0; texts[i][pos] && res == HttpResponseParser::ParsingIncompleted; ++pos)
+            res = bytewiseParser.parse(bytewise, texts[i] + pos, texts[i] + pos + 1);
+
+        BOOST_CHECK_EQUAL(res, HttpResponseParser::ParsingError);
+    }
+}
+
+// RFC 9112: reason-phrase = 1*( HTAB / SP / VCHAR / obs-text )
+BOOST_AUTO_TEST_CASE(reason_phrase_with_tab)
+{
+    const char text[] = "HTTP/1.1 200 \tAll\tfine\r\nContent-Length: 0\r\n\r\n";
+
+    Response whole;
+    HttpResponseParser parser;
+
+    BOOST_REQUIRE_EQUAL(parser.parse(whole, text, text + sizeof(text) - 1), HttpResponseParser::ParsingCompleted);
+    BOOST_CHECK_EQUAL(whole.status, "\tAll\tfine");
+
+    Response bytewise;
+    HttpResponseParser bytewiseParser;
+
+    for (size_t pos = 0; pos + 1 < sizeof(text) - 1; ++pos)
+        BOOST_REQUIRE_EQUAL(bytewiseParser.parse(bytewise, text + pos, text + pos + 1),
+                            HttpResponseParser::ParsingIncompleted);
+    BOOST_CHECK_EQUAL(bytewiseParser.parse(bytewise, text + sizeof(text) - 2, text + sizeof(text) - 1),
+                      HttpResponseParser::ParsingCompleted);
+    BOOST_CHECK_EQUAL(bytewise.status, "\tAll\tfine");
+
+    const char control[] = "HTTP/1.1 200 O\x01K\r\n\r\n";
+
+    Response response;
+    HttpResponseParser controlParser;
+    BOOST_CHECK_EQUAL(controlParser.parse(response, control, control + sizeof(control) - 1),
+                      HttpResponseParser::ParsingError);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
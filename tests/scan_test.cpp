@@ -0,0 +1,170 @@
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+#include <httpparser/httprequestparser.h>
+#include <httpparser/scan.h>
+
+#include <algorithm>
+#include <string>
+
+BOOST_AUTO_TEST_SUITE(Scanners)
+
+using httpparser::HttpRequestParser;
+using httpparser::isHeaderComplete;
+using httpparser::Request;
+namespace scan = httpparser::scan;
+
+typedef const char* (*Scanner)(const char*, const char*);
+
+// Every scanner available on this CPU must agree with the portable loop, for every stopping
+// byte at every offset of buffers that are shorter and longer than a vector.
+void checkScanner(Scanner scanner, Scanner reference, char fill)
+{
+    for (size_t size = 0; size <= 70; ++size)
+    {
+        std::string buffer(size, fill);
+        const char* begin = buffer.data();
+        const char* end   = begin + size;
+
+        BOOST_REQUIRE_EQUAL(scanner(begin, end) - begin, reference(begin, end) - begin);
+
+        for (size_t at = 0; at < size; ++at)
+        {
+            for (int c = 0; c < 256; ++c)
+            {
+                buffer[at] = static_cast<char>(c);
+                BOOST_REQUIRE_EQUAL(scanner(begin, end) - begin, reference(begin, end) - begin);
+            }
+            buffer[at] = fill;
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(vector_scanners_match_scalar)
+{
+    checkScanner(&scan::token, &scan::tokenScalar, 'a');
+    checkScanner(&scan::text, &scan::textScalar, 'a');
+
+#ifdef HTTPPARSER_SIMD_X86
+    if (scan::level() >= scan::Sse42)
+    {
+        checkScanner(&scan::tokenSse42, &scan::tokenScalar, 'a');
+        checkScanner(&scan::textSse42, &scan::textScalar, 'a');
+    }
+
+    if (scan::level() >= scan::Avx2)
+        checkScanner(&scan::textAvx2, &scan::textScalar, 'a');
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(long_headers_split_across_parse_calls)
+{
+    std::string cookie(200, 'c');
+    std::string text = "GET / HTTP/1.1\r\n"
+                       "X-A-Rather-Long-Header-Name-To-Cross-Vectors: value\r\n"
+                       "Cookie: "
+                       + cookie + "\r\n\r\n";
+
+    for (size_t split = 1; split < text.size(); ++split)
+    {
+        Request request;
+        HttpRequestParser parser;
+
+        BOOST_REQUIRE_EQUAL(parser.parse(request, text.data(), text.data() + split),
+                            HttpRequestParser::ParsingIncompleted);
+        BOOST_REQUIRE_EQUAL(parser.parse(request, text.data() + split, text.data() + text.size()),
+                            HttpRequestParser::ParsingCompleted);
+        BOOST_REQUIRE_EQUAL(request.headers.size(), 2u);
+        BOOST_CHECK_EQUAL(request.headers[0].name, "X-A-Rather-Long-Header-Name-To-Cross-Vectors");
+        BOOST_CHECK_EQUAL(request.headers[1].value, cookie);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(control_byte_in_long_value_is_rejected)
+{
+    std::string text = "GET / HTTP/1.1\r\n"
+                       "Cookie: "
+                       + std::string(40, 'c') + '\x01' + std::string(40, 'c') + "\r\n\r\n";
+
+    Request request;
+    HttpRequestParser parser;
+
+    BOOST_CHECK_EQUAL(parser.parse(request, text.data(), text.data() + text.size()), HttpRequestParser::ParsingError);
+}
+
+// The first "\r\n\r\n" in [p, end), the plain way.
+const char* blankLineReference(const char* p, const char* end)
+{
+    return std::search(p, end, "\r\n\r\n", "\r\n\r\n" + 4);
+}
+
+void checkBlankLine(Scanner scanner)
+{
+    const char bytes[] = {'\r', '\n', 'a'};
+
+    // Every mix of CR, LF and other bytes in the first eight positions, followed by fillers that
+    // move the interesting part across vector boundaries.
+    for (int pattern = 0; pattern < 3 * 3 * 3 * 3 * 3 * 3 * 3 * 3; ++pattern)
+    {
+        std::string head;
+        for (int i = 0, rest = pattern; i < 8; ++i, rest /= 3)
+            head += bytes[rest % 3];
+
+        for (size_t pad = 0; pad < 40; pad += 13)
+        {
+            std::string buffer = std::string(pad, 'x') + head + std::string(pad, 'y');
+            const char* begin  = buffer.data();
+            const char* end    = begin + buffer.size();
+
+            BOOST_REQUIRE_EQUAL(scanner(begin, end) - begin, blankLineReference(begin, end) - begin);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(blank_line_scanners)
+{
+    checkBlankLine(&scan::blankLineScalar);
+    checkBlankLine(&scan::blankLine);
+
+#ifdef HTTPPARSER_SIMD_X86
+    checkBlankLine(&scan::blankLineSse2);
+
+    if (scan::level() >= scan::Avx2)
+        checkBlankLine(&scan::blankLineAvx2);
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(header_complete_byte_by_byte)
+{
+    std::string text = "GET /index.html HTTP/1.1\r\n"
+                       "Host: example.com\r\n"
+                       "X-Padding: "
+                       + std::string(100, 'p') + "\r\n\r\nbody";
+    size_t headerSize = text.find("body");
+
+    for (size_t step = 1; step < 20; ++step)
+    {
+        size_t scanned = 0, size = 0;
+
+        for (;;)
+        {
+            size = std::min(size + step, text.size());
+            if (isHeaderComplete(text.data(), text.data() + size, scanned))
+                break;
+
+            BOOST_REQUIRE_LT(size, headerSize);
+            BOOST_REQUIRE_LE(scanned, size);
+        }
+
+        BOOST_CHECK_GE(size, headerSize);
+        BOOST_CHECK_EQUAL(scanned, headerSize);
+
+        Request request;
+        HttpRequestParser parser;
+        BOOST_CHECK_EQUAL(parser.parse(request, text.data(), text.data() + scanned), HttpRequestParser::ParsingCompleted);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,62 @@
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+// Only the generated single header, none of include/httpparser.
+#include <httpparser/httpparser.h>
+
+BOOST_AUTO_TEST_SUITE(SingleInclude)
+
+using httpparser::HttpRequestParser;
+using httpparser::HttpResponseParser;
+using httpparser::Request;
+using httpparser::RequestView;
+using httpparser::Response;
+using httpparser::UrlParser;
+
+BOOST_AUTO_TEST_CASE(request)
+{
+    const char text[] = "POST /uri.cgi HTTP/1.1\r\n"
+                        "Content-Length: 4\r\n"
+                        "\r\n"
+                        "data";
+
+    Request request;
+    HttpRequestParser parser;
+
+    BOOST_REQUIRE_EQUAL(parser.parse(request, text, text + sizeof(text) - 1), HttpRequestParser::ParsingCompleted);
+    BOOST_CHECK_EQUAL(request.method, "POST");
+    BOOST_CHECK_EQUAL(std::string(request.content.begin(), request.content.end()), "data");
+
+    RequestView view;
+    parser.reset();
+    BOOST_REQUIRE_EQUAL(parser.parse(view, text, text + sizeof(text) - 1), HttpRequestParser::ParsingCompleted);
+    BOOST_CHECK(view.uri == "/uri.cgi");
+}
+
+BOOST_AUTO_TEST_CASE(response)
+{
+    const char text[] = "HTTP/1.1 200 OK\r\n"
+                        "Content-Length: 2\r\n"
+                        "\r\n"
+                        "ok";
+
+    Response response;
+    HttpResponseParser parser;
+
+    BOOST_REQUIRE_EQUAL(parser.parse(response, text, text + sizeof(text) - 1), HttpResponseParser::ParsingCompleted);
+    BOOST_CHECK_EQUAL(response.statusCode, 200u);
+    BOOST_CHECK_EQUAL(response.status, "OK");
+}
+
+BOOST_AUTO_TEST_CASE(url)
+{
+    UrlParser parser("http://www.example.com:8080/dir");
+
+    BOOST_CHECK_EQUAL(parser.isValid(), true);
+    BOOST_CHECK_EQUAL(parser.hostname(), "www.example.com");
+    BOOST_CHECK_EQUAL(parser.httpPort(), 8080);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,104 @@
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+#include <httpparser/httprequestparser.h>
+#include <httpparser/httpresponseparser.h>
+#include <httpparser/staticrequest.h>
+#include <httpparser/staticresponse.h>
+
+#include <string>
+
+BOOST_AUTO_TEST_SUITE(Static)
+
+using httpparser::HeaderHost;
+using httpparser::HeaderTransferEncoding;
+using httpparser::HttpRequestParser;
+using httpparser::HttpResponseParser;
+using httpparser::Request;
+using httpparser::StaticRequest;
+using httpparser::StaticResponse;
+
+static const char request[] = "POST /uri.cgi HTTP/1.1\r\n"
+                              "Host: example.com\r\n"
+                              "Content-Type: text/plain\r\n"
+                              "Content-Length: 4\r\n"
+                              "\r\n"
+                              "data";
+
+BOOST_AUTO_TEST_CASE(request_fits)
+{
+    StaticRequest<4, 128> req;
+    Request expected;
+    HttpRequestParser parser, expectedParser;
+
+    BOOST_REQUIRE_EQUAL(parser.parse(req, request, request + sizeof(request) - 1), HttpRequestParser::ParsingCompleted);
+    BOOST_REQUIRE_EQUAL(expectedParser.parse(expected, request, request + sizeof(request) - 1),
+                        HttpRequestParser::ParsingCompleted);
+
+    BOOST_CHECK_EQUAL(req.inspect(), expected.inspect());
+    BOOST_CHECK(req.header(HeaderHost) == "example.com");
+    BOOST_CHECK(req.has("content-type"));
+    BOOST_CHECK(!req.has("Cookie"));
+    BOOST_CHECK(req.content == "data");
+}
+
+BOOST_AUTO_TEST_CASE(too_many_headers)
+{
+    StaticRequest<2, 128> req;
+    HttpRequestParser parser;
+
+    BOOST_CHECK_EQUAL(parser.parse(req, request, request + sizeof(request) - 1), HttpRequestParser::ParsingTooLarge);
+}
+
+BOOST_AUTO_TEST_CASE(too_many_bytes)
+{
+    // Everything but the last byte of the body fits.
+    const size_t text = 4 + 8 + 4 + 11 + 12 + 10 + 14 + 1 + 4;
+
+    StaticRequest<4, text - 1> small;
+    StaticRequest<4, text> exact;
+    HttpRequestParser parser;
+
+    BOOST_CHECK_EQUAL(parser.parse(small, request, request + sizeof(request) - 1), HttpRequestParser::ParsingTooLarge);
+
+    parser.reset();
+    BOOST_CHECK_EQUAL(parser.parse(exact, request, request + sizeof(request) - 1), HttpRequestParser::ParsingCompleted);
+    BOOST_CHECK_EQUAL(exact.storage.size(), text);
+}
+
+BOOST_AUTO_TEST_CASE(response_split_across_parse_calls)
+{
+    const char text[] = "HTTP/1.1 200 OK\r\n"
+                        "Server: nginx/1.2.1\r\n"
+                        "Transfer-Encoding: chunked\r\n"
+                        "\r\n"
+                        "5\r\nhello\r\n"
+                        "6\r\n world\r\n"
+                        "0\r\n\r\n";
+    const size_t size = sizeof(text) - 1;
+
+    StaticResponse<4, 128> resp;
+    HttpResponseParser parser;
+
+    for (size_t split = 1; split < size; ++split)
+    {
+        std::string first(text, split), second(text + split, size - split);
+
+        resp.clear();
+        parser.reset();
+
+        BOOST_REQUIRE_EQUAL(parser.parse(resp, first.data(), first.data() + first.size()),
+                            HttpResponseParser::ParsingIncompleted);
+        BOOST_REQUIRE_EQUAL(parser.parse(resp, second.data(), second.data() + second.size()),
+                            HttpResponseParser::ParsingCompleted);
+
+        BOOST_CHECK_EQUAL(resp.statusCode, 200u);
+        BOOST_CHECK(resp.status == "OK");
+        BOOST_CHECK(resp.content == "hello world");
+        BOOST_CHECK_EQUAL(resp.headers[1].id, HeaderTransferEncoding);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
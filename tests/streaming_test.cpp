@@ -0,0 +1,128 @@
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+#include <sstream>
+#include <string>
+
+#include <httpparser/httprequestparser.h>
+#include <httpparser/httpresponseparser.h>
+#include <httpparser/request.h>
+#include <httpparser/response.h>
+
+BOOST_AUTO_TEST_SUITE(Streaming)
+
+using httpparser::HttpRequestParser;
+using httpparser::HttpResponseParser;
+using httpparser::Request;
+using httpparser::Response;
+
+// Checks the streamed body against the expected pattern without keeping it.
+struct PatternSink
+{
+    PatternSink() : size(0), calls(0), largest(0), valid(true) {}
+
+    bool operator()(const char* data, size_t n)
+    {
+        for (size_t i = 0; i < n; ++i)
+            valid = valid && data[i] == static_cast<char>('a' + (size + i) % 26);
+
+        size += n;
+        largest = std::max(largest, n);
+        ++calls;
+        return true;
+    }
+
+    size_t size;
+    size_t calls;
+    size_t largest;
+    bool valid;
+};
+
+static std::string pattern(size_t size)
+{
+    std::string body(size, ' ');
+
+    for (size_t i = 0; i < size; ++i)
+        body[i] = static_cast<char>('a' + i % 26);
+
+    return body;
+}
+
+BOOST_AUTO_TEST_CASE(content_length_body_is_streamed)
+{
+    const size_t bodySize = 1024 * 1024;
+    const size_t segment  = 4096;
+
+    std::ostringstream stream;
+    stream << "PUT /upload HTTP/1.1\r\n"
+           << "Host: example.com\r\n"
+           << "Content-Length: " << bodySize << "\r\n"
+           << "\r\n"
+           << pattern(bodySize);
+    const std::string text = stream.str();
+
+    Request request;
+    PatternSink sink;
+    HttpRequestParser parser;
+    HttpRequestParser::ParseResult res = HttpRequestParser::ParsingIncompleted;
+
+    for (size_t i = 0; i < text.size() && res == HttpRequestParser::ParsingIncompleted; i += segment)
+    {
+        const char* begin = text.data() + i;
+        res               = parser.parse(request, sink, begin, begin + std::min(segment, text.size() - i));
+    }
+
+    BOOST_REQUIRE_EQUAL(res, HttpRequestParser::ParsingCompleted);
+    BOOST_CHECK_EQUAL(request.method, "PUT");
+    BOOST_CHECK_EQUAL(request.headers.size(), 2u);
+    BOOST_CHECK(request.content.empty());
+    BOOST_CHECK_EQUAL(sink.size, bodySize);
+    BOOST_CHECK(sink.valid);
+    BOOST_CHECK_LE(sink.largest, segment);
+}
+
+BOOST_AUTO_TEST_CASE(chunked_body_is_streamed_to_a_callback)
+{
+    const char text[] = "HTTP/1.1 200 OK\r\n"
+                        "Transfer-Encoding: chunked\r\n"
+                        "\r\n"
+                        "3\r\n"
+                        "con\r\n"
+                        "8\r\n"
+                        "sequence\r\n"
+                        "0\r\n\r\n";
+
+    std::string body;
+    auto sink = [&body](const char* data, size_t size) {
+        body.append(data, size);
+        return true;
+    };
+
+    Response response;
+    HttpResponseParser parser;
+
+    BOOST_REQUIRE_EQUAL(parser.parse(response, sink, text, text + sizeof(text) - 1),
+                        HttpResponseParser::ParsingCompleted);
+    BOOST_CHECK_EQUAL(response.statusCode, 200u);
+    BOOST_CHECK(response.content.empty());
+    BOOST_CHECK_EQUAL(body, "consequence");
+}
+
+BOOST_AUTO_TEST_CASE(sink_can_stop_parsing)
+{
+    const char text[] = "POST /uri HTTP/1.1\r\n"
+                        "Content-Length: 4\r\n"
+                        "\r\n"
+                        "data";
+
+    auto sink = [](const char*, size_t) { return false; };
+
+    Request request;
+    HttpRequestParser parser;
+
+    BOOST_CHECK_EQUAL(parser.parse(request, sink, text, text + sizeof(text) - 1), HttpRequestParser::ParsingError);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,141 @@
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+#include <httpparser/httprequestparser.h>
+#include <httpparser/httpresponseparser.h>
+#include <httpparser/requestview.h>
+#include <httpparser/responseview.h>
+
+#include "common.h"
+
+BOOST_AUTO_TEST_SUITE(View)
+
+using httpparser::HttpRequestParser;
+using httpparser::HttpResponseParser;
+using httpparser::Request;
+using httpparser::RequestView;
+using httpparser::Response;
+using httpparser::ResponseView;
+
+BOOST_AUTO_TEST_CASE(request_view_points_into_buffer)
+{
+    const char text[] = "GET /uri.cgi HTTP/1.1\r\n"
+                        "User-Agent: Mozilla/5.0\r\n"
+                        "Host: 127.0.0.1\r\n"
+                        "\r\n";
+
+    RequestView view;
+    HttpRequestParser parser;
+
+    BOOST_REQUIRE_EQUAL(parser.parse(view, text, text + sizeof(text) - 1), HttpRequestParser::ParsingCompleted);
+
+    BOOST_CHECK(view.method == "GET");
+    BOOST_CHECK(view.uri == "/uri.cgi");
+    BOOST_CHECK_EQUAL(view.method.data(), text);
+    BOOST_CHECK_EQUAL(view.uri.data(), text + 4);
+    BOOST_REQUIRE_EQUAL(view.headers.size(), 2u);
+    BOOST_CHECK(view.headers[0].name == "User-Agent");
+    BOOST_CHECK(view.headers[0].value == "Mozilla/5.0");
+    BOOST_CHECK(view.headers[1].name == "Host");
+    BOOST_CHECK(view.headers[1].value == "127.0.0.1");
+    BOOST_CHECK(view.content.empty());
+    BOOST_CHECK_EQUAL(view.keepAlive, true);
+}
+
+BOOST_AUTO_TEST_CASE(request_view_split_across_parse_calls)
+{
+    const char text[] = "POST /uri.cgi HTTP/1.1\r\n"
+                        "Content-Type: application/x-www-form-urlencoded\r\n"
+                        "Content-Length: 31\r\n"
+                        "\r\n"
+                        "arg1=test;arg1=%20%21;arg3=test";
+    const size_t size = sizeof(text) - 1;
+
+    for (size_t split = 1; split < size; ++split)
+    {
+        RequestView view;
+        HttpRequestParser parser;
+
+        BOOST_REQUIRE_EQUAL(parser.parse(view, text, text + split), HttpRequestParser::ParsingIncompleted);
+        BOOST_REQUIRE_EQUAL(parser.parse(view, text + split, text + size), HttpRequestParser::ParsingCompleted);
+
+        Request should = RequestDsl()
+                             .method("POST")
+                             .uri("/uri.cgi")
+                             .version(1, 1)
+                             .header("Content-Type", "application/x-www-form-urlencoded")
+                             .header("Content-Length", "31")
+                             .content("arg1=test;arg1=%20%21;arg3=test")
+                             .keepAlive(true);
+
+        BOOST_CHECK_EQUAL(view.inspect(), should.inspect());
+        BOOST_REQUIRE_EQUAL(view.content.size(), 1u);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(request_view_chunked_body_has_slice_per_chunk)
+{
+    const char text[] = "POST /uri.cgi HTTP/1.1\r\n"
+                        "Transfer-Encoding: chunked\r\n"
+                        "\r\n"
+                        "23\r\n"
+                        "This is the data in the first chunk\r\n"
+                        "1A\r\n"
+                        "and this is the second one\r\n"
+                        "0\r\n\r\n";
+
+    RequestView view;
+    HttpRequestParser parser;
+
+    BOOST_REQUIRE_EQUAL(parser.parse(view, text, text + sizeof(text) - 1), HttpRequestParser::ParsingCompleted);
+    BOOST_REQUIRE_EQUAL(view.content.size(), 2u);
+    BOOST_CHECK(view.content[0] == "This is the data in the first chunk");
+    BOOST_CHECK(view.content[1] == "and this is the second one");
+}
+
+BOOST_AUTO_TEST_CASE(request_view_materialize_matches_request)
+{
+    const char text[] = "PUT /uri HTTP/1.0\r\n"
+                        "Connection: Keep-Alive\r\n"
+                        "Content-Length: 4\r\n"
+                        "\r\n"
+                        "data";
+
+    Request request;
+    RequestView view;
+    HttpRequestParser requestParser, viewParser;
+
+    BOOST_REQUIRE_EQUAL(requestParser.parse(request, text, text + sizeof(text) - 1),
+                        HttpRequestParser::ParsingCompleted);
+    BOOST_REQUIRE_EQUAL(viewParser.parse(view, text, text + sizeof(text) - 1), HttpRequestParser::ParsingCompleted);
+
+    BOOST_CHECK_EQUAL(view.materialize().inspect(), request.inspect());
+}
+
+BOOST_AUTO_TEST_CASE(response_view)
+{
+    const char text[] = "HTTP/1.1 404 Not Found\r\n"
+                        "Server: nginx/1.2.1\r\n"
+                        "Content-Length: 8\r\n"
+                        "\r\n"
+                        "<html />";
+
+    Response response;
+    ResponseView view;
+    HttpResponseParser responseParser, viewParser;
+
+    BOOST_REQUIRE_EQUAL(responseParser.parse(response, text, text + sizeof(text) - 1),
+                        HttpResponseParser::ParsingCompleted);
+    BOOST_REQUIRE_EQUAL(viewParser.parse(view, text, text + sizeof(text) - 1), HttpResponseParser::ParsingCompleted);
+
+    BOOST_CHECK_EQUAL(view.statusCode, 404u);
+    BOOST_CHECK(view.status == "Not Found");
+    BOOST_REQUIRE_EQUAL(view.content.size(), 1u);
+    BOOST_CHECK(view.content[0] == "<html />");
+    BOOST_CHECK_EQUAL(view.content[0].data(), text + sizeof(text) - 9);
+    BOOST_CHECK_EQUAL(view.materialize().inspect(), response.inspect());
+}
+
+BOOST_AUTO_TEST_SUITE_END()